@@ -16,22 +16,60 @@
 #ifndef SICK_BUFFER_MONITOR
 #define SICK_BUFFER_MONITOR
 
+/* Macros */
+#define DEFAULT_SICK_MONITOR_IDLE_TIMEOUT                (100000)  ///< Max time (usecs) the monitor waits for data before checking whether it should stop
+#define DEFAULT_SICK_MONITOR_ERROR_BACKOFF                 (1000)  ///< Time (usecs) the monitor backs off after a stream error
+#define SICK_MONITOR_MAX_RECV_STAMPS                         (32)  ///< Max number of reads whose arrival times are remembered
+#define SICK_MONITOR_MAX_REPLY_PATTERNS                       (8)  ///< Max number of reply patterns registered at once
+#define SICK_MONITOR_MAX_REPLY_PATTERN_LENGTH                (32)  ///< Max length (bytes) of a reply pattern
+#define DEFAULT_SICK_MONITOR_REPLY_QUEUE_DEPTH                (4)  ///< Number of replies the monitor will hold
+
 /* Dependencies */
 #include <iostream>
+#include <time.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
 #include <pthread.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <sys/socket.h>
 #include "SickException.hh"
+#include "SickMessageQueue.hh"
+#include "SickReactor.hh"
+#include "SickStats.hh"
 
 /* Associate the namespace */
 namespace SickToolbox {
 
   /**
    * \class SickBufferMonitor
+   *
+   * By default each monitor runs its own thread. If a SickReactor is set
+   * before the monitor is started, the data stream is instead registered
+   * with the reactor, which frames messages on its thread as bytes arrive.
+   *
+   * Each framed message is stamped w/ the arrival time of its first byte.
+   * For sockets this is the kernel's receive timestamp (SO_TIMESTAMPNS),
+   * for anything else (e.g. a serial port) it is taken as the read returns.
+   *
+   * The monitor also counts what passes through it (see SickStats) w/o
+   * taking any locks, so the counters can be left on in production.
+   *
+   * Framed messages are split across two channels. Those whose payload
+   * begins w/ a registered reply pattern (i.e. the reply to an outstanding
+   * request) go to the reply channel, everything else (e.g. streamed
+   * scans) stays on the data channel. Waiting on a reply therefore never
+   * consumes or discards scans.
    */
   template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   class SickBufferMonitor {
 
   public:
 
+    /** Called on the monitor's thread w/ each framed message (returns True if it consumed the message) */
+    typedef bool (*message_handler_t)( SICK_MSG_CLASS &sick_message, void * handler_args );
+
     /** A standard constructor */
     SickBufferMonitor( SICK_MONITOR_CLASS * const monitor_instance ) throw( SickThreadException );
 
@@ -41,8 +79,57 @@ namespace SickToolbox {
     /** Start the buffer monitor for the device */
     void StartMonitor( const unsigned int sick_fd ) throw( SickThreadException );
 
-    /** Acquire the most recent message buffered by the monitor */
+    /** Services the data stream from a shared reactor rather than a dedicated thread (monitor must be stopped) */
+    void SetReactor( SickReactor * const sick_reactor ) throw( SickConfigException );
+
+    /** Frames whatever is waiting on the data stream (called by the reactor) */
+    void OnReadable( ) throw( SickThreadException, SickIOException );
+
+    /** Sets a handler offered each message before it is queued (NULL to queue everything) */
+    void SetMessageHandler( const message_handler_t message_handler, void * const handler_args ) throw( SickConfigException );
+
+    /** Acquire the oldest message buffered by the monitor */
     bool GetNextMessageFromMonitor( SICK_MSG_CLASS &sick_message ) throw( SickThreadException );
+
+    /** Acquire the oldest message buffered by the monitor, waiting up to timeout_value usecs for one to arrive */
+    bool GetNextMessageFromMonitor( SICK_MSG_CLASS &sick_message, const unsigned int timeout_value ) throw( SickThreadException );
+
+    /** Acquire the newest message buffered by the monitor (discarding any older ones), waiting up to timeout_value usecs for one to arrive */
+    bool GetLatestMessageFromMonitor( SICK_MSG_CLASS &sick_message, const unsigned int timeout_value ) throw( SickThreadException );
+
+    /** Routes messages whose payload begins w/ the given bytes to the reply channel (returns an id for unregistering) */
+    unsigned int RegisterReplyPattern( const uint8_t * const byte_sequence, const unsigned int byte_sequence_length ) throw( SickThreadException, SickConfigException );
+
+    /** Stops routing messages matching the pattern to the reply channel */
+    void UnregisterReplyPattern( const unsigned int pattern_id ) throw( SickThreadException );
+
+    /** Acquire the oldest reply buffered by the monitor, waiting up to timeout_value usecs for one to arrive */
+    bool GetNextReplyFromMonitor( SICK_MSG_CLASS &sick_message, const unsigned int timeout_value ) throw( SickThreadException );
+
+    /** Sets the depth and overflow policy of the message queue (monitor must be stopped) */
+    void SetMessageQueueParams( const unsigned int queue_depth,
+				const sick_message_queue_overflow_policy_t overflow_policy ) throw( SickConfigException );
+
+    /** Gets the number of messages dropped because the queue was full */
+    unsigned long GetNumMessagesDropped( ) const { return _recv_msg_queue.GetNumDropped(); }
+
+    /** Copies out the monitor's counters and latency histograms */
+    void GetStats( sick_stats_t &sick_stats ) const;
+
+    /** Zeroes the monitor's counters and latency histograms */
+    void ResetStats( ) { _sick_stats.Reset(); }
+
+    /** Records the time (usecs) the driver spent decoding a scan */
+    void RecordDecodeTime( const unsigned long decode_usecs ) { _sick_stats.RecordDecode(decode_usecs); }
+
+    /** Records the device counter of a decoded scan (returns the number of scans lost just before it) */
+    unsigned int RecordScanCounter( const unsigned int counter, const unsigned int counter_modulus ) { return _sick_stats.RecordScanCounter(counter,counter_modulus); }
+
+    /** Forgets the last scan counter (call when the device restarts its stream) */
+    void RestartScanSequence( ) { _sick_stats.RestartScanSequence(); }
+
+    /** Gets the number of scans lost just before the last one decoded */
+    unsigned int GetNumScansLostBeforeLast( ) const { return _sick_stats.GetNumScansLostBeforeLast(); }
     
     /** Stop the buffer monitor for the device */
     void StopMonitor( ) throw( SickThreadException );
@@ -56,16 +143,45 @@ namespace SickToolbox {
     /** Unlock access to the data stream */
     void ReleaseDataStream( ) throw( SickThreadException );
 
+    /** Discards any bytes buffered by the monitor (data stream should be acquired) */
+    void FlushRecvBuffer( ) { _recv_buffer_head = _recv_buffer_tail = _recv_buffer_count = _recv_stamp_count = 0; }
+
+    /** Discards any messages waiting on the data channel */
+    void FlushMessageQueue( ) { _recv_msg_queue.Clear(); }
+
+    /** Indicates whether the other end closed the data stream (the monitor no longer reads it) */
+    bool IsStreamClosed( ) const { return _stream_closed; }
+
     /** A standard destructor */
     ~SickBufferMonitor( ) throw( SickThreadException );
 
+    /** Size of the receive buffer (room for at least two max length messages) */
+    static const unsigned int RECV_BUFFER_SIZE = (2*SICK_MSG_CLASS::MESSAGE_MAX_LENGTH > 4096) ? 2*SICK_MSG_CLASS::MESSAGE_MAX_LENGTH : 4096;
+
   protected:
 
     /** Sick data stream file descriptor */
     unsigned int _sick_fd;   
     
     /** Reads n bytes into the destination buffer */
-    void _readBytes( uint8_t * const dest_buffer, const int num_bytes_to_read, const unsigned int timeout_value = 0 ) const throw ( SickTimeoutException, SickIOException );       
+    void _readBytes( uint8_t * const dest_buffer, const int num_bytes_to_read, const unsigned int timeout_value = 0 ) throw ( SickTimeoutException, SickIOException );       
+
+    /** Reads n bytes into the destination buffer, counting them as they come (so a timeout can be resumed from) */
+    void _readBytes( uint8_t * const dest_buffer, const unsigned int num_bytes_to_read, unsigned int &num_bytes_read,
+		     const unsigned int timeout_value ) throw ( SickTimeoutException, SickIOException );
+
+    /** Reads bytes into the destination buffer up to and including the given delimiter */
+    void _readBytesUntil( uint8_t * const dest_buffer, const unsigned int max_bytes_to_read, const uint8_t delimiter,
+			  unsigned int &num_bytes_read, const unsigned int timeout_value = 0 ) throw ( SickTimeoutException, SickIOException );
+
+    /** Pulls everything the OS has buffered for the stream into the receive buffer */
+    void _fillRecvBuffer( const unsigned int timeout_value = 0 ) throw ( SickTimeoutException, SickIOException );
+
+    /** Indicates whether the data stream is serviced by a reactor (i.e. reads must not block) */
+    bool _isReactorDriven( ) const { return _sick_reactor != NULL; }
+
+    /** Counts a frame discarded due to a bad checksum */
+    void _recordChecksumFailure( ) { _sick_stats.RecordChecksumFailure(); }
     
   private:
 
@@ -74,27 +190,154 @@ namespace SickToolbox {
 
     /** A flag to indicate the monitor should continue running */
     bool _continue_grabbing;
+
+    /** Set once a read finds the other end closed the data stream */
+    volatile bool _stream_closed;
     
     /** Buffer monitor thread ID */
     pthread_t _monitor_thread_id;
 
-    /** A mutex for guarding the message container */
-    pthread_mutex_t _container_mutex;
+    /** Indicates whether the monitor has been started */
+    bool _monitor_running;
+
+    /** The reactor servicing the data stream (NULL if the monitor has its own thread) */
+    SickReactor *_sick_reactor;
+
+    /** Set when framing ran out of buffered bytes mid-message (reactor mode) */
+    bool _frame_incomplete;
 
     /** A mutex for locking the data stream */
     pthread_mutex_t _stream_mutex;
+
+    /** A mutex guarding the message arrival condition */
+    pthread_mutex_t _arrival_mutex;
+
+    /** Signaled by the monitor when a message is queued */
+    pthread_cond_t _arrival_cond;
+
+    /** Offered each framed message before it is queued */
+    message_handler_t _message_handler;
+
+    /** Passed through to the message handler */
+    void *_message_handler_args;
+
+    /** Number of threads blocked waiting for a message */
+    volatile unsigned int _num_arrival_waiters;
     
-    /** A container to hold the most recent message */
-    SICK_MSG_CLASS _recv_msg_container;      
+    /** A queue holding received messages until they are consumed (the data channel) */
+    SickMessageQueue< SICK_MSG_CLASS > _recv_msg_queue;
+
+    /** A queue holding replies to outstanding requests (the reply channel) */
+    SickMessageQueue< SICK_MSG_CLASS > _reply_msg_queue;
+
+    /**
+     * \struct sick_reply_pattern_t
+     * \brief Leading payload bytes identifying the reply to a request
+     */
+    struct sick_reply_pattern_t {
+      bool in_use;                                                        ///< Indicates whether the slot is registered
+      unsigned int length;                                                ///< Number of bytes in the pattern
+      uint8_t bytes[SICK_MONITOR_MAX_REPLY_PATTERN_LENGTH];               ///< The pattern
+    };
+
+    /** The registered reply patterns */
+    sick_reply_pattern_t _reply_patterns[SICK_MONITOR_MAX_REPLY_PATTERNS];
+
+    /** Number of registered reply patterns (readable w/o the mutex) */
+    volatile unsigned int _num_reply_patterns;
+
+    /** Guards the reply patterns */
+    pthread_mutex_t _reply_mutex;
+
+    /** Receive ring buffer holding bytes drained from the data stream */
+    uint8_t _recv_buffer[RECV_BUFFER_SIZE];
+
+    /** Index at which the next byte drained from the stream is stored */
+    unsigned int _recv_buffer_head;
+
+    /** Index of the next unconsumed byte in the receive buffer */
+    unsigned int _recv_buffer_tail;
+
+    /** Number of unconsumed bytes in the receive buffer */
+    unsigned int _recv_buffer_count;
+
+    /**
+     * \struct sick_recv_stamp_t
+     * \brief The arrival time of the bytes returned by a single read
+     */
+    struct sick_recv_stamp_t {
+      unsigned long end_pos;                                              ///< Stream position just past the last byte read
+      struct timespec arrival_time;                                       ///< When the bytes arrived (CLOCK_REALTIME)
+    };
+
+    /** Indicates whether the data stream delivers kernel receive timestamps */
+    bool _recv_kernel_stamps;
+
+    /** Number of bytes read from the stream so far (i.e. the stream position of the head) */
+    unsigned long _recv_stream_pos;
+
+    /** Stream position of the first byte of the message being framed */
+    unsigned long _recv_frame_start_pos;
+
+    /** When framing of the current message began (CLOCK_MONOTONIC) */
+    struct timespec _frame_beg_time;
+
+    /** Arrival times of the reads that filled the receive buffer (oldest first) */
+    sick_recv_stamp_t _recv_stamps[SICK_MONITOR_MAX_RECV_STAMPS];
+
+    /** Index of the oldest arrival time */
+    unsigned int _recv_stamp_head;
+
+    /** Number of arrival times remembered */
+    unsigned int _recv_stamp_count;
+
+    /** Counters and latency histograms for the acquisition path */
+    SickStats _sick_stats;
+
+    /** Queues a message and wakes any threads waiting on it */
+    void _queueMessage( SickMessageQueue< SICK_MSG_CLASS > &msg_queue, SICK_MSG_CLASS &sick_message ) throw( SickThreadException );
+
+    /** Pops a message from the given queue, waiting up to timeout_value usecs for one to arrive */
+    bool _waitForMessage( SickMessageQueue< SICK_MSG_CLASS > &msg_queue, SICK_MSG_CLASS &sick_message, const unsigned int timeout_value ) throw( SickThreadException );
+
+    /** Indicates whether a message matches a registered reply pattern */
+    bool _isReply( const SICK_MSG_CLASS &sick_message ) throw( SickThreadException );
+
+    /** Offers a message to the handler, queueing it if the handler passes on it */
+    void _deliverMessage( SICK_MSG_CLASS &sick_message ) throw( SickThreadException );
+
+    /** Waits (w/o holding the data stream) until bytes are available for framing */
+    bool _waitForData( const unsigned int timeout_value ) const;
+
+    /** Waits until the data stream itself is readable */
+    bool _streamReadable( const unsigned int timeout_value ) const;
+
+    /** Reads as many bytes as the receive buffer can hold w/ a single call */
+    void _readIntoRecvBuffer( ) throw ( SickIOException );
+
+    /** Throws if the receive buffer is empty and the stream must not be blocked on */
+    void _checkWouldBlock( ) throw ( SickTimeoutException );
+
+    /** Asks the OS to timestamp bytes as they arrive on the data stream (if it is a socket) */
+    void _enableRecvStamps( );
+
+    /** Remembers when the bytes from the last read arrived */
+    void _pushRecvStamp( const unsigned int num_bytes_read, const struct timespec &arrival_time );
 
-    /** Locks access to the message container */
-    void _acquireMessageContainer( ) throw( SickThreadException );
+    /** Notes that the next unconsumed byte starts a new message (and starts the frame's clock) */
+    void _markFrameStart( );
 
-    /** Unlocks access to the message container */
-    void _releaseMessageContainer( ) throw( SickThreadException );   
+    /** Computes how much of the frame's timeout is left */
+    void _remainingFrameTime( const unsigned int timeout_value, struct timespec &remaining_time ) const;
+
+    /** Stamps a framed message w/ the arrival time of its first byte */
+    void _stampFrame( SICK_MSG_CLASS &sick_message ) const;
 
     /** Entry point for the monitor thread */
     static void * _bufferMonitorThread( void * thread_args );    
+
+    /** Entry point for the reactor */
+    static void _reactorHandler( void * handler_args );
     
   };
 
@@ -104,17 +347,44 @@ namespace SickToolbox {
    */
   template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SickBufferMonitor( SICK_MONITOR_CLASS * const monitor_instance ) throw( SickThreadException ) :
-    _sick_monitor_instance(monitor_instance), _continue_grabbing(true), _monitor_thread_id(0) {
+    _sick_monitor_instance(monitor_instance), _continue_grabbing(true), _stream_closed(false), _monitor_thread_id(0),
+    _monitor_running(false), _sick_reactor(NULL), _frame_incomplete(false),
+    _message_handler(NULL), _message_handler_args(NULL), _num_arrival_waiters(0),
+    _reply_msg_queue(DEFAULT_SICK_MONITOR_REPLY_QUEUE_DEPTH), _num_reply_patterns(0),
+    _recv_buffer_head(0), _recv_buffer_tail(0), _recv_buffer_count(0),
+    _recv_kernel_stamps(false), _recv_stream_pos(0), _recv_frame_start_pos(0), _recv_stamp_head(0), _recv_stamp_count(0) {
+
+    /* No frame yet */
+    _frame_beg_time.tv_sec = _frame_beg_time.tv_nsec = 0;
     
-    /* Initialize the shared message buffer mutex */
-    if (pthread_mutex_init(&_container_mutex,NULL) != 0) {
+    /* Initialize the shared data stream mutex */
+    if (pthread_mutex_init(&_stream_mutex,NULL) != 0) {
       throw SickThreadException("SickBufferMonitor::SickBufferMonitor: pthread_mutex_init() failed!");
     }
 
-    /* Initialize the shared data stream mutex */
-    if (pthread_mutex_init(&_stream_mutex,NULL) != 0) {
+    /* Initialize the message arrival mutex */
+    if (pthread_mutex_init(&_arrival_mutex,NULL) != 0) {
+      throw SickThreadException("SickBufferMonitor::SickBufferMonitor: pthread_mutex_init() failed!");
+    }
+
+    /* Initialize the reply pattern mutex */
+    if (pthread_mutex_init(&_reply_mutex,NULL) != 0) {
       throw SickThreadException("SickBufferMonitor::SickBufferMonitor: pthread_mutex_init() failed!");
     }
+
+    for (unsigned int i = 0; i < SICK_MONITOR_MAX_REPLY_PATTERNS; i++) {
+      _reply_patterns[i].in_use = false;
+      _reply_patterns[i].length = 0;
+    }
+
+    /* Initialize the message arrival condition (timed against the monotonic clock) */
+    pthread_condattr_t arrival_cond_attr;
+    if (pthread_condattr_init(&arrival_cond_attr) != 0 ||
+	pthread_condattr_setclock(&arrival_cond_attr,CLOCK_MONOTONIC) != 0 ||
+	pthread_cond_init(&_arrival_cond,&arrival_cond_attr) != 0) {
+      throw SickThreadException("SickBufferMonitor::SickBufferMonitor: pthread_cond_init() failed!");
+    }
+    pthread_condattr_destroy(&arrival_cond_attr);
     
   }
 
@@ -126,15 +396,28 @@ namespace SickToolbox {
   void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SetDataStream( const unsigned int sick_fd ) throw ( SickThreadException ) {
 
     try {
+
+      /* The reactor must stop watching the old stream */
+      bool reregister = _isReactorDriven() && _monitor_running;
+      if (reregister) {
+	_sick_reactor->Unregister(_sick_fd);
+      }
     
       /* Attempt to acquire the data stream */
       AcquireDataStream();
       
-      /* Assign the data stream fd */
+      /* Assign the data stream fd (anything buffered belongs to the old stream) */
       _sick_fd = sick_fd;
+      _stream_closed = false;
+      FlushRecvBuffer();
+      _enableRecvStamps();
       
       /* Attempt to release the data stream */
       ReleaseDataStream();
+
+      if (reregister) {
+	_sick_reactor->Register(_sick_fd,SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_reactorHandler,this);
+      }
       
     }
 
@@ -160,62 +443,350 @@ namespace SickToolbox {
 
     /* Assign the fd associated with the data stream */
     _sick_fd = sick_fd;
+    _stream_closed = false;
+    FlushRecvBuffer();
+    _enableRecvStamps();
+
+    /* Set the flag to continue grabbing data */
+    _continue_grabbing = true;
+
+    /* Let the reactor service the stream */
+    if (_isReactorDriven()) {
+      _sick_reactor->Register(_sick_fd,SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_reactorHandler,this);
+      _monitor_running = true;
+      return;
+    }
     
     /* Start the buffer monitor */
     if (pthread_create(&_monitor_thread_id,NULL,SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_bufferMonitorThread,_sick_monitor_instance) != 0) {
       throw SickThreadException("SickBufferMonitor::StartMonitor: pthread_create() failed!");
     }
 
-    /* Set the flag to continue grabbing data */
-    _continue_grabbing = true;
+    _monitor_running = true;
+  }
+
+  /**
+   * \brief Hands the data stream to a shared reactor
+   * \param *sick_reactor The reactor that is to service the stream (NULL for a dedicated thread)
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SetReactor( SickReactor * const sick_reactor ) throw ( SickConfigException ) {
+
+    /* Can't switch modes on the fly */
+    if (_monitor_running) {
+      throw SickConfigException("SickBufferMonitor::SetReactor: Monitor is running!");
+    }
+
+    _sick_reactor = sick_reactor;
     
   }
 
   /**
-   * \brief Checks the message container for the next available Sick message
+   * \brief Frames and queues every complete message waiting on the data stream
+   *
+   * NOTE: This runs on the reactor thread, so it never blocks on the stream.
+   *       When framing runs out of bytes partway through a message, the
+   *       receive buffer is rewound to the start of that message and the
+   *       attempt is repeated once more bytes arrive. The data stream is
+   *       only held while framing, each message is delivered after it has
+   *       been released (as on the monitor thread).
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::OnReadable( ) throw ( SickThreadException, SickIOException ) {
+
+    SICK_MSG_CLASS curr_message;
+    bool read_stream = false;
+
+    /* Frame as many messages as are buffered */
+    for (;;) {
+
+      AcquireDataStream();
+
+      try {
+
+	if (!_continue_grabbing) {
+	  ReleaseDataStream();
+	  break;
+	}
+
+	/* Somebody else (e.g. a flush) may have drained the stream already */
+	if (!read_stream) {
+	  read_stream = true;
+	  if (_recv_buffer_count < RECV_BUFFER_SIZE && _streamReadable(0)) {
+	    _readIntoRecvBuffer();
+	  }
+	}
+
+	if (_recv_buffer_count == 0) {
+	  ReleaseDataStream();
+	  break;
+	}
+
+	/* Remember where this message started */
+	unsigned int frame_tail = _recv_buffer_tail;
+	unsigned int frame_count = _recv_buffer_count;
+
+	_frame_incomplete = false;
+	curr_message.Clear();
+	_markFrameStart();
+
+	_sick_monitor_instance->GetNextMessageFromDataStream(curr_message);
+
+	if (_frame_incomplete) {
+
+	  /* Rewind and wait for the rest (unless the buffer is full of junk) */
+	  _recv_buffer_tail = frame_tail;
+	  _recv_buffer_count = frame_count;
+	  if (_recv_buffer_count == RECV_BUFFER_SIZE) {
+	    FlushRecvBuffer();
+	  }
+
+	  _frame_incomplete = false;
+	  ReleaseDataStream();
+	  break;
+	}
+
+	/* Look up the arrival time before the stamps can be pruned */
+	if (curr_message.IsPopulated()) {
+	  struct timespec framing_end_time;
+	  clock_gettime(CLOCK_MONOTONIC,&framing_end_time);
+	  _sick_stats.RecordFrame(SickStats::ElapsedUsecs(_frame_beg_time,framing_end_time));
+	  _stampFrame(curr_message);
+	}
+
+      }
+
+      /* Don't leave the stream locked */
+      catch(...) {
+	_frame_incomplete = false;
+	ReleaseDataStream();
+	throw;
+      }
+
+      ReleaseDataStream();
+
+      /* Deliver the message w/o holding the stream (the handler may run callbacks) */
+      if (curr_message.IsPopulated()) {
+	_deliverMessage(curr_message);
+      }
+
+    }
+    
+  }
+
+  /**
+   * \brief Sets a handler that is offered each message before it is queued
+   * \param message_handler The handler (NULL to queue every message)
+   * \param *handler_args Passed through to the handler
+   *
+   * NOTE: The handler runs on the thread framing messages (the monitor
+   *       thread or the reactor), so it sees each message as soon as it
+   *       has been framed. Messages it doesn't consume are queued as usual.
+   *       It runs w/o holding the data stream, but nothing more is framed
+   *       until it returns, so neither it nor any callback it runs may block.
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SetMessageHandler( const message_handler_t message_handler,
+										   void * const handler_args ) throw( SickConfigException ) {
+
+    /* Can't swap handlers out from under the monitor thread */
+    if (_monitor_running) {
+      throw SickConfigException("SickBufferMonitor::SetMessageHandler: Monitor is running!");
+    }
+
+    _message_handler = message_handler;
+    _message_handler_args = handler_args;
+
+  }
+
+  /**
+   * \brief Pops the next available Sick message off of the message queue
    * \param &sick_message The message object that is to be populated with the results
-   * \return True if the current contents were acquired, false otherwise
+   * \return True if a message was acquired, false otherwise
    */
   template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::GetNextMessageFromMonitor( SICK_MSG_CLASS &sick_message ) throw( SickThreadException ) {
 
-    bool acquired_message = false;
+    /* The queue is lock-free, so just pop */
+    if (!_recv_msg_queue.Pop(sick_message)) {
+      return false;
+    }
 
-    try {
+    _sick_stats.RecordConsumed(sick_message.GetArrivalTime());
+    return true;
+
+  }
+
+  /**
+   * \brief Pops the next Sick message off of the message queue, blocking until one arrives
+   * \param &sick_message The message object that is to be populated with the results
+   * \param timeout_value The max time (usecs) to wait for a message
+   * \return True if a message was acquired, false if the timeout expired
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::GetNextMessageFromMonitor( SICK_MSG_CLASS &sick_message,
+											   const unsigned int timeout_value ) throw( SickThreadException ) {
+
+    return _waitForMessage(_recv_msg_queue,sick_message,timeout_value);
+
+  }
+
+  /**
+   * \brief Pops the newest Sick message off of the message queue, blocking until one arrives
+   * \param &sick_message The message object that is to be populated with the results
+   * \param timeout_value The max time (usecs) to wait for a message
+   * \return True if a message was acquired, false if the timeout expired
+   *
+   * NOTE: Any older messages still queued are discarded (and counted as
+   *       skipped in the stats), trading completeness for freshness.
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::GetLatestMessageFromMonitor( SICK_MSG_CLASS &sick_message,
+											     const unsigned int timeout_value ) throw( SickThreadException ) {
+
+    /* Keep popping until the queue runs dry (a failed pop leaves the message alone) */
+    unsigned long num_popped = 0;
+    while (_recv_msg_queue.Pop(sick_message)) {
+      num_popped++;
+    }
+
+    /* Nothing waiting, so whatever arrives next is the latest */
+    if (num_popped == 0) {
+      return _waitForMessage(_recv_msg_queue,sick_message,timeout_value);
+    }
+
+    if (num_popped > 1) {
+      _sick_stats.RecordSkipped(num_popped - 1);
+    }
     
-      /* Acquire a lock on the message buffer */
-      _acquireMessageContainer();
+    _sick_stats.RecordConsumed(sick_message.GetArrivalTime());
+    return true;
 
-      /* Check whether the object is populated */
-      if (_recv_msg_container.IsPopulated()) {
+  }
 
-	/* Copy the shared message */
-	sick_message = _recv_msg_container;
-	_recv_msg_container.Clear();
-	
-	/* Set the flag indicating success */
-	acquired_message = true;      
+  /**
+   * \brief Routes messages matching a pattern to the reply channel
+   * \param *byte_sequence The bytes expected to lead off the reply's payload
+   * \param byte_sequence_length The number of bytes in byte_sequence
+   * \return A (nonzero) id identifying the pattern
+   *
+   * NOTE: Register the pattern before sending the request, so the reply
+   *       can't arrive before the monitor knows to look for it. Any stale
+   *       replies still sitting on the reply channel are discarded.
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  unsigned int SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::RegisterReplyPattern( const uint8_t * const byte_sequence,
+											      const unsigned int byte_sequence_length )
+    throw( SickThreadException, SickConfigException ) {
+
+    /* Sanity check */
+    if (byte_sequence_length == 0 || byte_sequence_length > SICK_MONITOR_MAX_REPLY_PATTERN_LENGTH) {
+      throw SickConfigException("SickBufferMonitor::RegisterReplyPattern: Invalid pattern length!");
+    }
+
+    if (pthread_mutex_lock(&_reply_mutex) != 0) {
+      throw SickThreadException("SickBufferMonitor::RegisterReplyPattern: pthread_mutex_lock() failed!");
+    }
+
+    /* Find a free slot */
+    unsigned int pattern_id = 0;
+    for (unsigned int i = 0; i < SICK_MONITOR_MAX_REPLY_PATTERNS; i++) {
+
+      if (!_reply_patterns[i].in_use) {
+	_reply_patterns[i].in_use = true;
+	_reply_patterns[i].length = byte_sequence_length;
+	memcpy(_reply_patterns[i].bytes,byte_sequence,byte_sequence_length);
+	_num_reply_patterns++;
+	pattern_id = i + 1;
+	break;
       }
 
-      /* Release message container */
-      _releaseMessageContainer();      
+    }
 
+    /* Nobody is waiting on whatever is left over */
+    if (_num_reply_patterns == 1) {
+      _reply_msg_queue.Clear();
     }
 
-    /* Handle a thread exception */
-    catch(SickThreadException &sick_thread_exception) {
-      std::cerr << sick_thread_exception.what() << std::endl;
-      throw;
+    pthread_mutex_unlock(&_reply_mutex);
+
+    if (pattern_id == 0) {
+      throw SickConfigException("SickBufferMonitor::RegisterReplyPattern: Too many patterns!");
     }
 
-    /* Handle an unknown exception */
-    catch(...) {
-      std::cerr << "SickBufferMonitor::CheckMessageContainer: Unknown exception!" << std::endl;
-      throw;
+    return pattern_id;
+
+  }
+
+  /**
+   * \brief Stops routing messages matching a pattern to the reply channel
+   * \param pattern_id The id returned by RegisterReplyPattern()
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::UnregisterReplyPattern( const unsigned int pattern_id ) throw( SickThreadException ) {
+
+    if (pthread_mutex_lock(&_reply_mutex) != 0) {
+      throw SickThreadException("SickBufferMonitor::UnregisterReplyPattern: pthread_mutex_lock() failed!");
     }
-    
-    /* Return the flag */
-    return acquired_message;    
+
+    if (pattern_id > 0 && pattern_id <= SICK_MONITOR_MAX_REPLY_PATTERNS && _reply_patterns[pattern_id-1].in_use) {
+      _reply_patterns[pattern_id-1].in_use = false;
+      _num_reply_patterns--;
+    }
+
+    pthread_mutex_unlock(&_reply_mutex);
+
+  }
+
+  /**
+   * \brief Pops the next reply off of the reply channel, blocking until one arrives
+   * \param &sick_message The message object that is to be populated with the results
+   * \param timeout_value The max time (usecs) to wait for a reply
+   * \return True if a reply was acquired, false if the timeout expired
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::GetNextReplyFromMonitor( SICK_MSG_CLASS &sick_message,
+											 const unsigned int timeout_value ) throw( SickThreadException ) {
+
+    return _waitForMessage(_reply_msg_queue,sick_message,timeout_value);
+
+  }
+  
+  /**
+   * \brief Sets the depth and overflow policy of the message queue
+   * \param queue_depth Number of messages the monitor can hold (rounded up to a power of two)
+   * \param overflow_policy Whether to drop the oldest or newest message when the queue is full
+   *
+   * NOTE: This discards any queued messages, so it may only be called while
+   *       the monitor is stopped.
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SetMessageQueueParams( const unsigned int queue_depth,
+										       const sick_message_queue_overflow_policy_t overflow_policy )
+    throw( SickConfigException ) {
+
+    /* Can't pull the queue out from under the monitor thread */
+    if (_monitor_running) {
+      throw SickConfigException("SickBufferMonitor::SetMessageQueueParams: Monitor is running!");
+    }
+
+    _recv_msg_queue.Reset(queue_depth,overflow_policy);
+
+  }
+
+  /**
+   * \brief Copies out the monitor's counters and latency histograms
+   * \param &sick_stats The destination
+   *
+   * NOTE: Each field is read atomically, but the snapshot as a whole is
+   *       not (the monitor may be updating it concurrently).
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::GetStats( sick_stats_t &sick_stats ) const {
+
+    _sick_stats.GetSnapshot(sick_stats);
+    sick_stats.num_frames_dropped = _recv_msg_queue.GetNumDropped();
+
   }
   
   /**
@@ -235,10 +806,27 @@ namespace SickToolbox {
       _continue_grabbing = false;
       ReleaseDataStream();
 
+      /* Make sure the reactor is done w/ us */
+      if (_isReactorDriven()) {
+	_sick_reactor->Unregister(_sick_fd);
+	_monitor_running = false;
+	return;
+      }
+
+      /* Stopped from a callback (i.e. on the monitor thread), which exits once the callback returns */
+      if (pthread_equal(pthread_self(),_monitor_thread_id)) {
+	pthread_detach(_monitor_thread_id);
+	_monitor_thread_id = 0;
+	_monitor_running = false;
+	return;
+      }
+      
       /* Wait for the buffer monitor to exit */
       if (pthread_join(_monitor_thread_id,&monitor_result) != 0) {
       	throw SickThreadException("SickBufferMonitor::StopMonitor: pthread_join() failed!");      
       }
+      _monitor_thread_id = 0;
+      _monitor_running = false;
 
     }
 
@@ -287,119 +875,622 @@ namespace SickToolbox {
   template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::~SickBufferMonitor( ) throw( SickThreadException ) {
 
-    /* Destroy the message container mutex */
-    if (pthread_mutex_destroy(&_container_mutex) != 0) {
+    /* Destroy the data stream container mutex */
+    if (pthread_mutex_destroy(&_stream_mutex) != 0) {
       throw SickThreadException("SickBufferMonitor::~SickBufferMonitor: pthread_mutex_destroy() failed!");
     }
 
-    /* Destroy the data stream container mutex */
-    if (pthread_mutex_destroy(&_stream_mutex) != 0) {
+    /* Destroy the message arrival condition and its mutex */
+    if (pthread_cond_destroy(&_arrival_cond) != 0 || pthread_mutex_destroy(&_arrival_mutex) != 0) {
+      throw SickThreadException("SickBufferMonitor::~SickBufferMonitor: pthread_cond_destroy() failed!");
+    }
+
+    /* Destroy the reply pattern mutex */
+    if (pthread_mutex_destroy(&_reply_mutex) != 0) {
       throw SickThreadException("SickBufferMonitor::~SickBufferMonitor: pthread_mutex_destroy() failed!");
     }
     
   }
 
   /**
-   * \brief Locks access to the message container
+   * \brief Attempt to read a certain number of bytes from the stream
+   * \param *dest_buffer A pointer to the destination buffer
+   * \param num_bytes_to_read The number of bytes to read into the buffer
+   * \param timeout_value The max time (usecs) allowed for the whole message (zero to wait forever)
+   * \return True if the number of requested bytes were successfully read
+   *
+   * NOTE: Bytes are served from the receive buffer, which is only refilled
+   *       (in bulk) from the data stream once it has been exhausted. The
+   *       timeout runs from when the monitor began framing the message, so
+   *       it doesn't stretch w/ the number of reads the message takes.
    */
-  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
-  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_acquireMessageContainer( ) throw( SickThreadException ) {
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_readBytes( uint8_t * const dest_buffer, const int num_bytes_to_read, const unsigned int timeout_value )
+    throw ( SickTimeoutException, SickIOException ) {
 
-    /* Lock the mutex */
-    if (pthread_mutex_lock(&_container_mutex) != 0) {
-      throw SickThreadException("SickBufferMonitor::_acquireMessageContainer: pthread_mutex_lock() failed!");
-    }	
-  
+    unsigned int num_bytes_read = 0;
+    _readBytes(dest_buffer,(unsigned int)num_bytes_to_read,num_bytes_read,timeout_value);
+    
   }
 
   /**
-   * \brief Unlocks access to the message container
+   * \brief Attempt to read a certain number of bytes from the stream
+   * \param *dest_buffer A pointer to the destination buffer
+   * \param num_bytes_to_read The number of bytes to read into the buffer
+   * \param &num_bytes_read The number of bytes read (short of num_bytes_to_read on a timeout)
+   * \param timeout_value The max time (usecs) allowed for the whole message (zero to wait forever)
+   *
+   * NOTE: The bytes counted in num_bytes_read have been consumed even if
+   *       the read times out, so a caller holding on to them can pick up
+   *       where it left off.
    */
-  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
-  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_releaseMessageContainer( ) throw( SickThreadException ) {
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_readBytes( uint8_t * const dest_buffer, const unsigned int num_bytes_to_read, unsigned int &num_bytes_read,
+									   const unsigned int timeout_value )
+    throw ( SickTimeoutException, SickIOException ) {
+    
+    /* Some helpful variables */
+    unsigned int num_bytes_to_copy = 0;
 
-    /* Unlock the mutex */
-    if (pthread_mutex_unlock(&_container_mutex) != 0) {
-      throw SickThreadException("SickBufferMonitor::_releaseMessageContainer: pthread_mutex_unlock() failed!");
-    }	
+    /* Nothing read yet */
+    num_bytes_read = 0;
+    
+    /* Attempt to fetch the bytes */
+    while ( num_bytes_read < num_bytes_to_read ) {
+
+      /* Refill the receive buffer if it has run dry */
+      if (_recv_buffer_count == 0) {
+	_checkWouldBlock();
+	_fillRecvBuffer(timeout_value);
+      }
+
+      /* Copy out as much as is contiguous in the ring (or as much as was requested) */
+      num_bytes_to_copy = RECV_BUFFER_SIZE - _recv_buffer_tail;
+      if (num_bytes_to_copy > _recv_buffer_count) {
+	num_bytes_to_copy = _recv_buffer_count;
+      }
+      if (num_bytes_to_copy > num_bytes_to_read - num_bytes_read) {
+	num_bytes_to_copy = num_bytes_to_read - num_bytes_read;
+      }
+
+      memcpy(&dest_buffer[num_bytes_read],&_recv_buffer[_recv_buffer_tail],num_bytes_to_copy);
+
+      /* Consume the bytes */
+      _recv_buffer_tail = (_recv_buffer_tail + num_bytes_to_copy) % RECV_BUFFER_SIZE;
+      _recv_buffer_count -= num_bytes_to_copy;
+      num_bytes_read += num_bytes_to_copy;
+      
+    }
     
   }
 
   /**
-   * \brief Attempt to read a certain number of bytes from the stream
+   * \brief Reads bytes from the stream up to and including the given delimiter
    * \param *dest_buffer A pointer to the destination buffer
-   * \param num_bytes_to_read The number of bytes to read into the buffer
-   * \param timeout_value The number of microseconds allowed between subsequent bytes in a message
-   * \return True if the number of requested bytes were successfully read
+   * \param max_bytes_to_read The max number of bytes that can be read into the buffer
+   * \param delimiter The byte value terminating the sequence
+   * \param &num_bytes_read The number of bytes read (including the delimiter)
+   * \param timeout_value The max time (usecs) allowed for the whole message (zero to wait forever)
+   *
+   * NOTE: If the delimiter isn't found within max_bytes_to_read bytes then
+   *       num_bytes_read will equal max_bytes_to_read and the last byte in
+   *       the destination buffer will not be the delimiter.
    */
   template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
-  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_readBytes( uint8_t * const dest_buffer, const int num_bytes_to_read, const unsigned int timeout_value ) const
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_readBytesUntil( uint8_t * const dest_buffer, const unsigned int max_bytes_to_read, const uint8_t delimiter,
+										unsigned int &num_bytes_read, const unsigned int timeout_value )
     throw ( SickTimeoutException, SickIOException ) {
+
+    unsigned int num_bytes_to_copy = 0;
+    const uint8_t *delimiter_pos = NULL;
+
+    /* Nothing read yet */
+    num_bytes_read = 0;
     
+    while ( num_bytes_read < max_bytes_to_read ) {
+
+      /* Refill the receive buffer if it has run dry */
+      if (_recv_buffer_count == 0) {
+	_checkWouldBlock();
+	_fillRecvBuffer(timeout_value);
+      }
+
+      /* Search the contiguous region of the ring for the delimiter */
+      num_bytes_to_copy = RECV_BUFFER_SIZE - _recv_buffer_tail;
+      if (num_bytes_to_copy > _recv_buffer_count) {
+	num_bytes_to_copy = _recv_buffer_count;
+      }
+      if (num_bytes_to_copy > max_bytes_to_read - num_bytes_read) {
+	num_bytes_to_copy = max_bytes_to_read - num_bytes_read;
+      }
+
+      delimiter_pos = (const uint8_t *)memchr(&_recv_buffer[_recv_buffer_tail],delimiter,num_bytes_to_copy);
+      if (delimiter_pos != NULL) {
+	num_bytes_to_copy = (delimiter_pos - &_recv_buffer[_recv_buffer_tail]) + 1;
+      }
+
+      memcpy(&dest_buffer[num_bytes_read],&_recv_buffer[_recv_buffer_tail],num_bytes_to_copy);
+
+      /* Consume the bytes */
+      _recv_buffer_tail = (_recv_buffer_tail + num_bytes_to_copy) % RECV_BUFFER_SIZE;
+      _recv_buffer_count -= num_bytes_to_copy;
+      num_bytes_read += num_bytes_to_copy;
+
+      /* Found it! */
+      if (delimiter_pos != NULL) {
+	break;
+      }
+      
+    }
+
+  }
+  
+  /**
+   * \brief Drains all bytes awaiting read on the stream into the receive buffer
+   * \param timeout_value The max time (usecs) allowed for the whole message (zero to wait forever)
+   *
+   * NOTE: A single readv() pulls as many bytes as the ring can hold, so the
+   *       cost of a system call is amortized over every byte it returns.
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_fillRecvBuffer( const unsigned int timeout_value )
+    throw ( SickTimeoutException, SickIOException ) {
+
     /* Some helpful variables */
-    int num_bytes_read = 0;
-    int total_num_bytes_read = 0;
     int num_active_files = 0;
     
-    struct timeval timeout_val;                     // This structure will be used for setting our timeout values
-    fd_set file_desc_set;                           // File descriptor set for monitoring I/O    
+    struct timespec remaining_time;                 // What is left of the message's timeout
+    struct pollfd poll_fd;                          // The data stream
+
+    /* Nothing to do if the ring is full */
+    if (_recv_buffer_count == RECV_BUFFER_SIZE) {
+      return;
+    }
+
+    poll_fd.fd = _sick_fd;
+    poll_fd.events = POLLIN;
+
+    /* Wait for the OS to tell us that data is waiting! */
+    do {
+
+      /* Only wait for whatever is left of the deadline (recomputed if interrupted) */
+      if (timeout_value > 0) {
+	_remainingFrameTime(timeout_value,remaining_time);
+      }
+
+      poll_fd.revents = 0;
+      num_active_files = ppoll(&poll_fd,1,(timeout_value > 0) ? &remaining_time : NULL,NULL);
+      
+    } while (num_active_files < 0 && errno == EINTR);
+      
+    /* Figure out what to do based on the output of poll */
+    if (num_active_files == 0) {
+      
+      /* A timeout has occurred! */
+      throw SickTimeoutException("SickBufferMonitor::_fillRecvBuffer: poll() timeout!");	
+      
+    }
+    else if (num_active_files < 0) {
+      
+      /* An error has occurred! */
+      throw SickIOException("SickBufferMonitor::_fillRecvBuffer: poll() failed!");	
+      
+    }
+
+    /* Grab everything that is waiting */
+    _readIntoRecvBuffer();
     
-    /* Attempt to fetch the bytes */
-    while ( total_num_bytes_read < num_bytes_to_read ) {
+  }
+
+  /**
+   * \brief Reads as many bytes as are waiting (and will fit) into the receive buffer
+   *
+   * NOTE: A single readv() fills both free regions of the ring. The stream
+   *       must be readable (and the ring not full) or this will block.
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_readIntoRecvBuffer( ) throw ( SickIOException ) {
+
+    int num_bytes_read = 0;
+    int num_segments = 0;
+    struct iovec recv_segments[2];                  // Free regions of the ring
+    struct timespec arrival_time;                   // When the bytes arrived
+    bool arrival_time_known = false;
+
+    /* Maximize the contiguous free space when the ring is empty */
+    if (_recv_buffer_count == 0) {
+      _recv_buffer_head = _recv_buffer_tail = 0;
+    }
+    
+    /* Describe the free region(s) of the ring */
+    if (_recv_buffer_head >= _recv_buffer_tail) {
+
+      recv_segments[num_segments].iov_base = &_recv_buffer[_recv_buffer_head];
+      recv_segments[num_segments].iov_len = RECV_BUFFER_SIZE - _recv_buffer_head;
+      num_segments++;
+
+      if (_recv_buffer_tail > 0) {
+	recv_segments[num_segments].iov_base = &_recv_buffer[0];
+	recv_segments[num_segments].iov_len = _recv_buffer_tail;
+	num_segments++;
+      }
       
-      /* Initialize and set the file descriptor set for select */
-      FD_ZERO(&file_desc_set);
-      FD_SET(_sick_fd,&file_desc_set);
+    }
+    else {
+      recv_segments[num_segments].iov_base = &_recv_buffer[_recv_buffer_head];
+      recv_segments[num_segments].iov_len = _recv_buffer_tail - _recv_buffer_head;
+      num_segments++;
+    }
+    
+    /* Grab everything that is waiting in a single call */
+    if (_recv_kernel_stamps) {
+
+      /* Let the kernel tell us when the bytes came in */
+      struct msghdr recv_header;
+      uint8_t recv_control[CMSG_SPACE(sizeof(struct timespec))];
+
+      memset(&recv_header,0,sizeof(recv_header));
+      recv_header.msg_iov = recv_segments;
+      recv_header.msg_iovlen = num_segments;
+      recv_header.msg_control = recv_control;
+      recv_header.msg_controllen = sizeof(recv_control);
+
+      num_bytes_read = recvmsg(_sick_fd,&recv_header,0);
+
+      for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&recv_header); num_bytes_read > 0 && cmsg != NULL; cmsg = CMSG_NXTHDR(&recv_header,cmsg)) {
+	if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPNS) {
+	  memcpy(&arrival_time,CMSG_DATA(cmsg),sizeof(struct timespec));
+	  arrival_time_known = true;
+	}
+      }
       
-      /* Setup the timeout structure */
-      memset(&timeout_val,0,sizeof(timeout_val));   // Initialize the buffer
-      timeout_val.tv_usec = timeout_value;          // Wait for specified time before throwing a timeout
+    }
+    else {
+      num_bytes_read = readv(_sick_fd,recv_segments,num_segments);
+    }
 
-      /* Wait for the OS to tell us that data is waiting! */
-      num_active_files = select(getdtablesize(),&file_desc_set,0,0,(timeout_value > 0) ? &timeout_val : 0);
+    /* The other end hung up, so nothing more will come (the caller stops reading) */
+    if (num_bytes_read == 0) {
+      _stream_closed = true;
+      throw SickIOException("SickBufferMonitor::_readIntoRecvBuffer: Stream closed!");
+    }
+
+    /* Decide what to do based on the output of read */
+    if (num_bytes_read < 0) {
       
-      /* Figure out what to do based on the output of select */
-      if (num_active_files > 0) {
-	
-  	/* A file is ready for reading!
-  	 *
-  	 * NOTE: The following conditional is just a sanity check. Since
-  	 *       the file descriptor set only contains the sick device fd,
-  	 *       it likely unnecessary to use FD_ISSET
-  	 */
-  	if (FD_ISSET(_sick_fd,&file_desc_set)) {
-	  
-  	  /* Read a single byte from the stream! */
-  	  num_bytes_read = read(_sick_fd,&dest_buffer[total_num_bytes_read],1);
-
-  	  /* Decide what to do based on the output of read */
-  	  if (num_bytes_read > 0) { //Update the number of bytes read so far
-  	    total_num_bytes_read += num_bytes_read;
-  	  }
-  	  else {
-  	    /* If this happens, something is wrong */
-  	    throw SickIOException("SickBufferMonitor::_readBytes: read() failed!");
-  	  }	  
-	  
-  	}
-	
+      /* If this happens, something is wrong */
+      throw SickIOException("SickBufferMonitor::_readIntoRecvBuffer: read() failed!");
+      
+    }
+
+    /* Otherwise the read just completed, which is as close as we can get */
+    if (!arrival_time_known) {
+      clock_gettime(CLOCK_REALTIME,&arrival_time);
+    }
+
+    /* Commit the new bytes */
+    _recv_buffer_head = (_recv_buffer_head + num_bytes_read) % RECV_BUFFER_SIZE;
+    _recv_buffer_count += num_bytes_read;
+    _pushRecvStamp(num_bytes_read,arrival_time);
+    _sick_stats.RecordRead(num_bytes_read);
+    
+  }
+
+  /**
+   * \brief Refuses to wait on the stream when it is being serviced by a reactor
+   *
+   * NOTE: Framing code treats the resulting timeout like any other, and
+   *       OnReadable() rewinds to the start of the message.
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_checkWouldBlock( ) throw ( SickTimeoutException ) {
+
+    if (_isReactorDriven()) {
+      _frame_incomplete = true;
+      throw SickTimeoutException("SickBufferMonitor::_checkWouldBlock: Message incomplete!");
+    }
+    
+  }
+  
+  /**
+   * \brief Asks the OS to timestamp bytes arriving on the data stream
+   *
+   * NOTE: This only succeeds for sockets. Other streams (e.g. a serial
+   *       port) are stamped when each read returns.
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_enableRecvStamps( ) {
+
+    int enable_stamps = 1;
+    _recv_kernel_stamps = (setsockopt(_sick_fd,SOL_SOCKET,SO_TIMESTAMPNS,&enable_stamps,sizeof(enable_stamps)) == 0);
+    
+  }
+
+  /**
+   * \brief Remembers the arrival time of the bytes returned by a read
+   * \param num_bytes_read The number of bytes the read returned
+   * \param &arrival_time When they arrived
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_pushRecvStamp( const unsigned int num_bytes_read, const struct timespec &arrival_time ) {
+
+    _recv_stream_pos += num_bytes_read;
+
+    /* Forget reads that ended before the current message began... */
+    while (_recv_stamp_count > 0 && (long)(_recv_stamps[_recv_stamp_head].end_pos - _recv_frame_start_pos) <= 0) {
+      _recv_stamp_head = (_recv_stamp_head + 1) % SICK_MONITOR_MAX_RECV_STAMPS;
+      _recv_stamp_count--;
+    }
+
+    /* ...and if there are still too many, lump the oldest in w/ its successor */
+    if (_recv_stamp_count == SICK_MONITOR_MAX_RECV_STAMPS) {
+      _recv_stamp_head = (_recv_stamp_head + 1) % SICK_MONITOR_MAX_RECV_STAMPS;
+      _recv_stamp_count--;
+    }
+
+    sick_recv_stamp_t &recv_stamp = _recv_stamps[(_recv_stamp_head + _recv_stamp_count) % SICK_MONITOR_MAX_RECV_STAMPS];
+    recv_stamp.end_pos = _recv_stream_pos;
+    recv_stamp.arrival_time = arrival_time;
+    _recv_stamp_count++;
+    
+  }
+
+  /**
+   * \brief Notes that the next unconsumed byte starts a new message
+   *
+   * NOTE: This also starts the clock the message's timeout runs against.
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_markFrameStart( ) {
+
+    _recv_frame_start_pos = _recv_stream_pos - _recv_buffer_count;
+    clock_gettime(CLOCK_MONOTONIC,&_frame_beg_time);
+    
+  }
+
+  /**
+   * \brief Computes how much of the current message's timeout is left
+   * \param timeout_value The max time (usecs) allowed for the whole message
+   * \param &remaining_time Set to the time left (zero if the deadline has passed)
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_remainingFrameTime( const unsigned int timeout_value, struct timespec &remaining_time ) const {
+
+    struct timespec curr_time;
+    clock_gettime(CLOCK_MONOTONIC,&curr_time);
+
+    unsigned long elapsed_usecs = SickStats::ElapsedUsecs(_frame_beg_time,curr_time);
+    unsigned long remaining_usecs = (elapsed_usecs < timeout_value) ? timeout_value - elapsed_usecs : 0;
+
+    remaining_time.tv_sec = remaining_usecs / 1000000;
+    remaining_time.tv_nsec = (remaining_usecs % 1000000) * 1000;
+    
+  }
+
+  /**
+   * \brief Stamps a message w/ the arrival time of its first byte
+   * \param &sick_message The message that was just framed
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_stampFrame( SICK_MSG_CLASS &sick_message ) const {
+
+    /* Find the first read that returned bytes past the start of the message */
+    for (unsigned int i = 0; i < _recv_stamp_count; i++) {
+
+      const sick_recv_stamp_t &recv_stamp = _recv_stamps[(_recv_stamp_head + i) % SICK_MONITOR_MAX_RECV_STAMPS];
+      if ((long)(recv_stamp.end_pos - _recv_frame_start_pos) > 0) {
+	sick_message.SetArrivalTime(recv_stamp.arrival_time);
+	return;
       }
-      else if (num_active_files == 0) {
-	
-	/* A timeout has occurred! */
-	throw SickTimeoutException("SickBufferMonitor::_readBytes: select() timeout!");	
+      
+    }
+    
+  }
+  
+  /**
+   * \brief Queues a message and signals any threads blocked waiting for one
+   * \param &msg_queue The channel to queue the message on
+   * \param &sick_message The message to queue (handed off by swapping buffers)
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_queueMessage( SickMessageQueue< SICK_MSG_CLASS > &msg_queue,
+									       SICK_MSG_CLASS &sick_message ) throw( SickThreadException ) {
+
+    /* Make the message visible first... */
+    msg_queue.Push(sick_message);
+    __sync_synchronize();
+
+    /* ...then only pay for the mutex if somebody is actually waiting */
+    if (_num_arrival_waiters > 0) {
 
+      if (pthread_mutex_lock(&_arrival_mutex) != 0) {
+	throw SickThreadException("SickBufferMonitor::_queueMessage: pthread_mutex_lock() failed!");
       }
-      else {
-	
-	/* An error has occurred! */
-	throw SickIOException("SickBufferMonitor::_readBytes: select() failed!");	
 
+      pthread_cond_broadcast(&_arrival_cond);
+
+      if (pthread_mutex_unlock(&_arrival_mutex) != 0) {
+	throw SickThreadException("SickBufferMonitor::_queueMessage: pthread_mutex_unlock() failed!");
       }
       
     }
     
   }
+
+  /**
+   * \brief Offers a message to the handler and queues it if the handler doesn't consume it
+   * \param &sick_message The framed message
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_deliverMessage( SICK_MSG_CLASS &sick_message ) throw( SickThreadException ) {
+
+    /* Replies to outstanding requests go to their own channel */
+    if (_num_reply_patterns > 0 && _isReply(sick_message)) {
+      _queueMessage(_reply_msg_queue,sick_message);
+      return;
+    }
+
+    if (_message_handler != NULL) {
+
+      /* Measure latency before the handler gets to work on it */
+      struct timespec arrival_time = sick_message.GetArrivalTime();
+      if (_message_handler(sick_message,_message_handler_args)) {
+	_sick_stats.RecordConsumed(arrival_time);
+	return;
+      }
+
+    }
+
+    _queueMessage(_recv_msg_queue,sick_message);
+
+  }
+
+  /**
+   * \brief Pops a message from a channel, blocking until one arrives
+   * \param &msg_queue The channel to pop from
+   * \param &sick_message The message object that is to be populated with the results
+   * \param timeout_value The max time (usecs) to wait for a message
+   * \return True if a message was acquired, false if the timeout expired
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_waitForMessage( SickMessageQueue< SICK_MSG_CLASS > &msg_queue,
+										 SICK_MSG_CLASS &sick_message,
+										 const unsigned int timeout_value ) throw( SickThreadException ) {
+
+    /* Don't bother w/ the condition if something is already waiting */
+    if (msg_queue.Pop(sick_message)) {
+      _sick_stats.RecordConsumed(sick_message.GetArrivalTime());
+      return true;
+    }
+
+    /* Compute the absolute deadline */
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC,&deadline);
+    deadline.tv_sec += timeout_value / 1000000;
+    deadline.tv_nsec += (timeout_value % 1000000) * 1000;
+    if (deadline.tv_nsec >= 1000000000) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000;
+    }
+
+    bool acquired_message = false;
+    
+    if (pthread_mutex_lock(&_arrival_mutex) != 0) {
+      throw SickThreadException("SickBufferMonitor::_waitForMessage: pthread_mutex_lock() failed!");
+    }
+
+    /* Announce ourselves before re-checking, so the monitor can't miss us */
+    __sync_fetch_and_add(&_num_arrival_waiters,1);
+
+    for (;;) {
+
+      if ((acquired_message = msg_queue.Pop(sick_message))) {
+	break;
+      }
+      
+      int wait_result = pthread_cond_timedwait(&_arrival_cond,&_arrival_mutex,&deadline);
+      if (wait_result == ETIMEDOUT) {
+	acquired_message = msg_queue.Pop(sick_message);
+	break;
+      }
+      else if (wait_result != 0 && wait_result != EINTR) {
+	__sync_fetch_and_sub(&_num_arrival_waiters,1);
+	pthread_mutex_unlock(&_arrival_mutex);
+	throw SickThreadException("SickBufferMonitor::_waitForMessage: pthread_cond_timedwait() failed!");
+      }
+      
+    }
+
+    __sync_fetch_and_sub(&_num_arrival_waiters,1);
+    
+    if (pthread_mutex_unlock(&_arrival_mutex) != 0) {
+      throw SickThreadException("SickBufferMonitor::_waitForMessage: pthread_mutex_unlock() failed!");
+    }
+
+    if (acquired_message) {
+      _sick_stats.RecordConsumed(sick_message.GetArrivalTime());
+    }
+    
+    return acquired_message;
+
+  }
+
+  /**
+   * \brief Checks a message against the registered reply patterns
+   * \param &sick_message The framed message
+   * \return True if its payload begins w/ one of the patterns
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_isReply( const SICK_MSG_CLASS &sick_message ) throw( SickThreadException ) {
+
+    bool is_reply = false;
+
+    if (pthread_mutex_lock(&_reply_mutex) != 0) {
+      throw SickThreadException("SickBufferMonitor::_isReply: pthread_mutex_lock() failed!");
+    }
+
+    for (unsigned int i = 0; i < SICK_MONITOR_MAX_REPLY_PATTERNS && !is_reply; i++) {
+      is_reply = _reply_patterns[i].in_use &&
+	         sick_message.GetPayloadLength() >= _reply_patterns[i].length &&
+	         memcmp(sick_message.GetPayloadPtr(),_reply_patterns[i].bytes,_reply_patterns[i].length) == 0;
+    }
+
+    pthread_mutex_unlock(&_reply_mutex);
+
+    return is_reply;
+
+  }
+
+  /**
+   * \brief Waits for the stream to become readable
+   * \param timeout_value The max time (usecs) to wait
+   * \return True if there are bytes to frame, False if the timeout expired
+   *
+   * NOTE: This is called w/o holding the data stream so that other threads
+   *       (e.g. flushing the stream or stopping the monitor) are not locked
+   *       out while the device is quiet.
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_waitForData( const unsigned int timeout_value ) const {
+
+    /* Left over bytes from the last read? */
+    return _recv_buffer_count > 0 || _streamReadable(timeout_value);
+    
+  }
+
+  /**
+   * \brief Waits for the data stream to become readable
+   * \param timeout_value The max time (usecs) to wait (zero to just check)
+   * \return True if the stream is readable, False if the timeout expired
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  bool SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_streamReadable( const unsigned int timeout_value ) const {
+
+    struct timespec timeout_time;
+    struct pollfd poll_fd;
+
+    poll_fd.fd = _sick_fd;
+    poll_fd.events = POLLIN;
+    poll_fd.revents = 0;
+
+    timeout_time.tv_sec = timeout_value / 1000000;
+    timeout_time.tv_nsec = (timeout_value % 1000000) * 1000;
+
+    /* Errors are left to the read itself to report */
+    return ppoll(&poll_fd,1,&timeout_time,NULL) != 0;
+    
+  }
+  
+  /**
+   * \brief Called by the reactor when the data stream is readable
+   * \param *handler_args The buffer monitor instance
+   */
+  template < class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_reactorHandler( void * handler_args ) {
+
+    ((SickBufferMonitor< SICK_MONITOR_CLASS, SICK_MSG_CLASS > *)handler_args)->OnReadable();
+    
+  }
   
   /**
    * \brief The monitor thread
@@ -419,6 +1510,21 @@ namespace SickToolbox {
 
       try {
 
+	/* Block until there is something to read (or it is time to check the flag) */
+	if (!buffer_monitor->_waitForData(DEFAULT_SICK_MONITOR_IDLE_TIMEOUT)) {
+
+	  /* Nothing to frame, so only hold the stream long enough to read the flag */
+	  buffer_monitor->AcquireDataStream();
+	  bool continue_grabbing = buffer_monitor->_continue_grabbing;
+	  buffer_monitor->ReleaseDataStream();
+
+	  if (!continue_grabbing) {
+	    break;
+	  }
+
+	  continue;
+	}
+
 	/* Reset the sick message object */
  	curr_message.Clear();	
 
@@ -430,33 +1536,56 @@ namespace SickToolbox {
 	  break;
 	}
 
-	buffer_monitor->GetNextMessageFromDataStream(curr_message);
+	/* Don't leave the stream locked if framing fails */
+	try {
+	  buffer_monitor->_markFrameStart();
+	  buffer_monitor->GetNextMessageFromDataStream(curr_message);
+	}
+	catch(...) {
+	  buffer_monitor->ReleaseDataStream();
+	  throw;
+	}
+
+	/* Look up the arrival time before the stamps can be pruned */
+	if (curr_message.IsPopulated()) {
+	  struct timespec framing_end_time;
+	  clock_gettime(CLOCK_MONOTONIC,&framing_end_time);
+	  buffer_monitor->_sick_stats.RecordFrame(SickStats::ElapsedUsecs(buffer_monitor->_frame_beg_time,framing_end_time));
+	  buffer_monitor->_stampFrame(curr_message);
+	}
+	
 	buffer_monitor->ReleaseDataStream();
 	
-	/* Update message container contents */
-	buffer_monitor->_acquireMessageContainer();	
-	buffer_monitor->_recv_msg_container = curr_message;
- 	buffer_monitor->_releaseMessageContainer();
+	/* Deliver the message (a timeout leaves it unpopulated) */
+	if (curr_message.IsPopulated()) {
+	  buffer_monitor->_deliverMessage(curr_message);
+	}
 
       }
 
       /* Make sure there wasn't a serious error reading from the buffer */
       catch(SickIOException &sick_io_exception) {
 	std::cerr << sick_io_exception.what() << std::endl;
+
+	/* A closed stream stays readable, so stop polling it (StopMonitor still reaps the thread) */
+	if (buffer_monitor->_stream_closed) {
+	  break;
+	}
+
+	usleep(DEFAULT_SICK_MONITOR_ERROR_BACKOFF);
       }
 
       /* Catch any thread exceptions */
       catch(SickThreadException &sick_thread_exception) {
 	std::cerr << sick_thread_exception.what() << std::endl;
+	usleep(DEFAULT_SICK_MONITOR_ERROR_BACKOFF);
       }
       
       /* A failsafe */
       catch(...) {
 	std::cerr << "SickBufferMonitor::_bufferMonitorThread: Unknown exception!" << std::endl;
+	usleep(DEFAULT_SICK_MONITOR_ERROR_BACKOFF);
       }
-
-      /* sleep a bit! */
-      usleep(1000);
       
     }    
 
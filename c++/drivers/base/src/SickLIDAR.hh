@@ -35,11 +35,18 @@
 #include <string>
 #include <iomanip>
 #include <iostream>
+#include <time.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
 #include <pthread.h>
 #include <arpa/inet.h>
 #include <sys/time.h>
 #include "SickException.hh"
+#include "SickMessageQueue.hh"
+#include "SickReactor.hh"
+#include "SickStats.hh"
 
 /* Associate the namespace */
 namespace SickToolbox {
@@ -58,12 +65,49 @@ namespace SickToolbox {
 
     /** Indicates whether device is initialized */
     bool IsInitialized() { return _sick_initialized; }
+
+    /** Sets how many received messages are held for the application (call before Initialize) */
+    void SetSickMessageQueueParams( const unsigned int queue_depth,
+				    const sick_message_queue_overflow_policy_t overflow_policy = SICK_MESSAGE_QUEUE_DROP_OLDEST ) throw( SickConfigException );
+
+    /** Has the driver hand back only the newest received message, discarding any the application fell behind on */
+    void SetSickSkipToLatest( const bool skip_to_latest ) { _sick_skip_to_latest = skip_to_latest; }
+
+    /** Services the device from a reactor shared w/ other devices instead of its own thread (call before Initialize) */
+    void SetSickReactor( SickReactor * const sick_reactor ) throw( SickConfigException );
+
+    /** Gets the number of received messages dropped because the application fell behind */
+    unsigned long GetSickNumMessagesDropped( ) const { return _sick_buffer_monitor->GetNumMessagesDropped(); }
+
+    /** Gets a snapshot of the counters and latency histograms for the acquisition path */
+    void GetSickStats( sick_stats_t &sick_stats ) const { _sick_buffer_monitor->GetStats(sick_stats); }
+
+    /** Zeroes the counters and latency histograms for the acquisition path */
+    void ResetSickStats( ) { _sick_buffer_monitor->ResetStats(); }
+
+    /** Gets the number of scans (according to the device's counter) that were lost just before the last one returned */
+    unsigned int GetSickNumScansLostBeforeLast( ) const { return _sick_buffer_monitor->GetNumScansLostBeforeLast(); }
+
+    /** Indicates whether the device closed the data stream (nothing more will be read from it) */
+    bool IsSickStreamClosed( ) const { return _sick_buffer_monitor->IsStreamClosed(); }
     
     /** A virtual destructor */
     virtual ~SickLIDAR( );
 
   protected:
 
+    /**
+     * \struct sick_pending_reply_t
+     * \brief The reply expected to one of several pipelined requests
+     */
+    struct sick_pending_reply_t {
+      const uint8_t *byte_sequence;                                       ///< Leading payload bytes identifying the reply
+      unsigned int byte_sequence_length;                                  ///< Number of bytes in the sequence
+      SICK_MSG_CLASS *recv_message;                                       ///< Where the reply goes
+      bool received;                                                      ///< Whether the reply has arrived
+      unsigned int pattern_id;                                            ///< The id the monitor assigned the sequence (0 if unregistered)
+    };
+
     /** Sick device file descriptor */
     int _sick_fd;
 
@@ -76,6 +120,9 @@ namespace SickToolbox {
     /** Indicates whether the Sick buffer monitor is running */
     bool _sick_monitor_running;
 
+    /** Indicates whether received messages older than the newest one are discarded */
+    bool _sick_skip_to_latest;
+
     /** A method for setting up a general connection */
     virtual void _setupConnection( ) = 0;
     
@@ -101,7 +148,7 @@ namespace SickToolbox {
     void _sendMessage( const SICK_MSG_CLASS &sick_message, const unsigned int byte_interval ) const
       throw( SickIOException );
     
-    /** Acquire the next message from the message container */
+    /** Acquire the next message from the message queue */
     void _recvMessage( SICK_MSG_CLASS &sick_message, const unsigned int timeout_value ) const throw ( SickTimeoutException );
 
     /** Search the stream for a payload with a particular "header" byte string */
@@ -112,6 +159,18 @@ namespace SickToolbox {
     
     /** An inline function for computing elapsed time */
     double _computeElapsedTime( const struct timeval &beg_time, const struct timeval &end_time ) const { return ((end_time.tv_sec*1e6)+(end_time.tv_usec))-((beg_time.tv_sec*1e6)+beg_time.tv_usec); }
+
+    /** An inline function for computing elapsed time (usecs) between monotonic clock readings */
+    double _computeElapsedTime( const struct timespec &beg_time, const struct timespec &end_time ) const { return ((end_time.tv_sec*1e6)+(end_time.tv_nsec/1e3))-((beg_time.tv_sec*1e6)+(beg_time.tv_nsec/1e3)); }
+
+    /** Records the time since beg_time (a monotonic clock reading) as the time spent decoding a scan */
+    void _recordDecodeTime( const struct timespec &beg_time ) const;
+
+    /** Checks a decoded scan's device counter for continuity (returns the number of scans lost just before it) */
+    unsigned int _recordScanCounter( const unsigned int counter, const unsigned int counter_modulus ) const { return _sick_buffer_monitor->RecordScanCounter(counter,counter_modulus); }
+
+    /** Forgets the last scan counter (call whenever the device (re)starts its stream) */
+    void _restartScanSequence( ) const { _sick_buffer_monitor->RestartScanSequence(); }
     
     /** Sends a request to the Sick and acquires looks for the reply */
     virtual void _sendMessageAndGetReply( const SICK_MSG_CLASS &send_message,
@@ -121,6 +180,30 @@ namespace SickToolbox {
 					  const unsigned int byte_interval,
 					  const unsigned int timeout_value,
 					  const unsigned int num_tries ) throw( SickTimeoutException, SickIOException);
+
+    /** Sends several requests back to back, setting aside the replies expected to any of them */
+    void _sendPipelinedMessages( const SICK_MSG_CLASS * const send_messages[],
+				 const unsigned int num_send_messages,
+				 sick_pending_reply_t pending_replies[],
+				 const unsigned int num_pending_replies,
+				 const unsigned int byte_interval ) throw( SickIOException );
+
+    /** Waits for a particular reply to pipelined requests (filing any others that arrive first) */
+    void _recvPipelinedReply( sick_pending_reply_t pending_replies[],
+			      const unsigned int num_pending_replies,
+			      const unsigned int reply_index,
+			      const unsigned int timeout_value ) const throw( SickTimeoutException );
+
+    /** Hands whatever matches the pending replies back to the data channel */
+    void _endPipeline( sick_pending_reply_t pending_replies[], const unsigned int num_pending_replies ) const;
+
+    /** Sends several requests back to back and waits for all of their replies */
+    void _sendMessagesAndGetReplies( const SICK_MSG_CLASS * const send_messages[],
+				     const unsigned int num_send_messages,
+				     sick_pending_reply_t pending_replies[],
+				     const unsigned int num_pending_replies,
+				     const unsigned int byte_interval,
+				     const unsigned int timeout_value ) throw( SickTimeoutException, SickIOException );
     
   };
 
@@ -129,7 +212,7 @@ namespace SickToolbox {
    */
   template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SickLIDAR( ) :
-    _sick_fd(0), _sick_initialized(false), _sick_buffer_monitor(NULL), _sick_monitor_running(false) {
+    _sick_fd(0), _sick_initialized(false), _sick_buffer_monitor(NULL), _sick_monitor_running(false), _sick_skip_to_latest(false) {
 
     try {
       /* Attempt to instantiate a new SickBufferMonitor for the device */
@@ -154,6 +237,43 @@ namespace SickToolbox {
     
   }
 
+  /**
+   * \brief Sets the depth and overflow policy of the received message queue
+   * \param queue_depth Number of messages held for the application (rounded up to a power of two)
+   * \param overflow_policy Whether to drop the oldest or newest message when the queue is full
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SetSickMessageQueueParams( const unsigned int queue_depth,
+										   const sick_message_queue_overflow_policy_t overflow_policy )
+    throw( SickConfigException ) {
+
+    /* The queue can only be resized while nobody is filling it */
+    if (_sick_monitor_running) {
+      throw SickConfigException("SickLIDAR::SetSickMessageQueueParams: Device is already initialized!");
+    }
+
+    _sick_buffer_monitor->SetMessageQueueParams(queue_depth,overflow_policy);
+
+  }
+
+  /**
+   * \brief Attaches the driver to a shared reactor
+   * \param *sick_reactor The reactor (NULL to go back to a dedicated monitor thread)
+   *
+   * NOTE: The reactor must outlive the driver.
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::SetSickReactor( SickReactor * const sick_reactor ) throw( SickConfigException ) {
+
+    /* The monitor can't switch modes while it is running */
+    if (_sick_monitor_running) {
+      throw SickConfigException("SickLIDAR::SetSickReactor: Device is already initialized!");
+    }
+
+    _sick_buffer_monitor->SetReactor(sick_reactor);
+
+  }
+
   /**
    * \brief Activates the buffer monitor for the driver
    */
@@ -251,13 +371,16 @@ namespace SickToolbox {
   /**
    * \brief Sends a message to the Sick device
    * \param &sick_message A reference to the well-formed message that is to be sent to the Sick
-   * \param byte_interval Minimum time in microseconds between transmitted bytes
+   * \param byte_interval Minimum time in microseconds between transmitted bytes (zero to send the whole frame at once)
+   *
+   * NOTE: Per-byte pacing is only meant for slow serial links (e.g. the
+   *       Sick LMS 2xx). Over TCP it turns every byte into its own segment.
    */
   template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_sendMessage( const SICK_MSG_CLASS &sick_message, const unsigned int byte_interval ) const
     throw( SickIOException ) {
 
-    uint8_t message_buffer[SICK_MSG_CLASS::MESSAGE_MAX_LENGTH] = {0};
+    uint8_t message_buffer[SICK_MSG_CLASS::MESSAGE_MAX_LENGTH];
 
     /* Copy the given message and get the message length */
     sick_message.GetMessage(message_buffer);
@@ -266,9 +389,20 @@ namespace SickToolbox {
     /* Check whether a transmission delay between bytes is requested */
     if (byte_interval == 0) {
       
-      /* Write the message to the stream */
-      if ((unsigned int)write(_sick_fd,message_buffer,message_length) != message_length) {      
-	throw SickIOException("SickLIDAR::_sendMessage: write() failed!");
+      /* Write the message to the stream (picking up where a short write left off) */
+      unsigned int num_bytes_written = 0;
+      while (num_bytes_written < message_length) {
+
+	ssize_t write_return = write(_sick_fd,&message_buffer[num_bytes_written],message_length - num_bytes_written);
+	if (write_return < 0 && errno == EINTR) {
+	  continue;
+	}
+	else if (write_return <= 0) {
+	  throw SickIOException("SickLIDAR::_sendMessage: write() failed!");
+	}
+
+	num_bytes_written += write_return;
+	
       }
 
     }
@@ -290,6 +424,19 @@ namespace SickToolbox {
 
   }
 
+  /**
+   * \brief Records the time spent decoding a scan
+   * \param &beg_time When decoding began (CLOCK_MONOTONIC)
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_recordDecodeTime( const struct timespec &beg_time ) const {
+
+    struct timespec end_time;
+    clock_gettime(CLOCK_MONOTONIC,&end_time);
+    _sick_buffer_monitor->RecordDecodeTime(SickStats::ElapsedUsecs(beg_time,end_time));
+
+  }
+
   /**
    * \brief Attempt to acquire the latest available message from the device
    * \param &sick_message A reference to the container that will hold the most recent message
@@ -300,24 +447,13 @@ namespace SickToolbox {
   void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_recvMessage( SICK_MSG_CLASS &sick_message,
 								      const unsigned int timeout_value ) const throw ( SickTimeoutException ) {
 
-    /* Timeval structs for handling timeouts */
-    struct timeval beg_time, end_time;
-
-    /* Acquire the elapsed time since epoch */
-    gettimeofday(&beg_time,NULL);
+    /* Block until the monitor hands us a message (the newest one if we are skipping ahead) */
+    bool acquired_message = _sick_skip_to_latest ?
+      _sick_buffer_monitor->GetLatestMessageFromMonitor(sick_message,timeout_value) :
+      _sick_buffer_monitor->GetNextMessageFromMonitor(sick_message,timeout_value);
     
-    /* Check the shared object */
-    while(!_sick_buffer_monitor->GetNextMessageFromMonitor(sick_message)) {    
-      
-      /* Sleep a little bit */
-      usleep(1000);
-    
-      /* Check whether the allowed time has expired */
-      gettimeofday(&end_time,NULL);    
-      if (_computeElapsedTime(beg_time,end_time) > timeout_value) {
-	throw SickTimeoutException("SickLIDAR::_recvMessage: Timeout occurred!");
-      }
-      
+    if (!acquired_message) {
+      throw SickTimeoutException("SickLIDAR::_recvMessage: Timeout occurred!");
     }
     
   }
@@ -330,7 +466,11 @@ namespace SickToolbox {
    * \param timeout_value The time in usecs to wait before throwing a timeout error
    * \return True if a new message was received, False otherwise
    *
-   * NOTE: This method is intended to be a helper for _sendMessageAndGetReply
+   * NOTE: This method is intended to be a helper for _sendMessageAndGetReply. It
+   *       only looks at the reply channel, so the byte sequence must have been
+   *       registered w/ the monitor (see RegisterReplyPattern) beforehand.
+   *       Replies that don't match (e.g. a late reply to an earlier request)
+   *       are discarded. Scans stay on the data channel untouched.
    */
   template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
   void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_recvMessage( SICK_MSG_CLASS &sick_message,
@@ -338,45 +478,36 @@ namespace SickToolbox {
 								      const unsigned int byte_sequence_length,
 								      const unsigned int timeout_value ) const throw( SickTimeoutException ) {
 
-    /* Define a buffer */
-    uint8_t payload_buffer[SICK_MSG_CLASS::MESSAGE_PAYLOAD_MAX_LENGTH];
-    
-    /* Timeval structs for handling timeouts */
-    struct timeval beg_time, end_time;    
+    /* Timespec structs for handling timeouts */
+    struct timespec beg_time, end_time;    
+    double elapsed_time = 0;
     
     /* A container for the message */
     SICK_MSG_CLASS curr_message;
     
-    /* Get the elapsed time since epoch */
-    gettimeofday(&beg_time,NULL);
+    /* Get the current (monotonic) time */
+    clock_gettime(CLOCK_MONOTONIC,&beg_time);
 
     /* Check until it is found or a timeout */
     for(;;) {
       
-      /* Attempt to acquire the message */
-      unsigned int i = 0;
-      if (_sick_buffer_monitor->GetNextMessageFromMonitor(curr_message)) {	
-	
-	/* Extract the payload subregion */
-	curr_message.GetPayloadSubregion(payload_buffer,0,byte_sequence_length-1);
+      /* Attempt to acquire the reply (waiting out whatever time remains) */
+      if (_sick_buffer_monitor->GetNextReplyFromMonitor(curr_message,timeout_value - (unsigned int)elapsed_time)) {	
 	
-	/* Match the byte sequence */
-	for (i=0; (i < byte_sequence_length) && (payload_buffer[i] == byte_sequence[i]); i++);
+	/* Match the byte sequence against the start of the payload */
+	if (curr_message.GetPayloadLength() >= byte_sequence_length &&
+	    memcmp(curr_message.GetPayloadPtr(),byte_sequence,byte_sequence_length) == 0) {
 
-	/* Our message was found! */
-	if (i == byte_sequence_length) {
-	  sick_message = curr_message;
+	  /* Our message was found! */
+	  sick_message.Swap(curr_message);
 	  break;
 	}
 	
       }
       
-      /* Sleep a little bit */
-      usleep(1000);     
-
       /* Check whether the allowed time has expired */
-      gettimeofday(&end_time,NULL);        
-      if (_computeElapsedTime(beg_time,end_time) > timeout_value) {
+      clock_gettime(CLOCK_MONOTONIC,&end_time);        
+      if ((elapsed_time = _computeElapsedTime(beg_time,end_time)) >= timeout_value) {
       	throw SickTimeoutException();
       }      
       
@@ -400,6 +531,18 @@ namespace SickToolbox {
 										 const unsigned int timeout_value,
 										 const unsigned int num_tries ) 
 										 throw( SickTimeoutException, SickIOException ) {
+
+    /* Have the monitor set the reply aside for us (before it can possibly arrive) */
+    unsigned int pattern_id = 0;
+    try {
+      pattern_id = _sick_buffer_monitor->RegisterReplyPattern(byte_sequence,byte_sequence_length);
+    }
+
+    /* Handle a bad pattern */
+    catch (SickConfigException &sick_config_exception) {
+      std::cerr << sick_config_exception.what() << std::endl;
+      throw SickIOException("SickLIDAR::_sendMessageAndGetReply: Unable to register reply pattern!");
+    }
     
     /* Send the message for at most num_tries number of times */
     for(unsigned int i = 0; i < num_tries; i++) {
@@ -422,6 +565,7 @@ namespace SickToolbox {
 	
 	/* Check if it was found! */
 	if (i == num_tries - 1) {
+	  _sick_buffer_monitor->UnregisterReplyPattern(pattern_id);
 	  throw SickTimeoutException("SickLIDAR::_sendMessageAndGetReply: Attempted max number of tries w/o success!");
 	}
 	
@@ -433,18 +577,224 @@ namespace SickToolbox {
       /* Handle write buffer exceptions */
       catch (SickIOException &sick_io_error) {
 	std::cerr << sick_io_error.what() << std::endl;
+	_sick_buffer_monitor->UnregisterReplyPattern(pattern_id);
 	throw;
       }
       
       /* A safety net */
       catch (...) {
 	std::cerr << "SickLIDAR::_sendMessageAndGetReply: Unknown exception!!!" << std::endl;
+	_sick_buffer_monitor->UnregisterReplyPattern(pattern_id);
 	throw;
       }
       
     }
+
+    /* Subsequent matches belong on the data channel again */
+    _sick_buffer_monitor->UnregisterReplyPattern(pattern_id);
     
   }
+
+  /**
+   * \brief Sends several requests back to back, setting aside the replies expected to any of them
+   * \param send_messages The requests (sent in order)
+   * \param num_send_messages The number of requests
+   * \param pending_replies The expected replies (their byte sequences and destinations must be set)
+   * \param num_pending_replies The number of expected replies (at most SICK_MONITOR_MAX_REPLY_PATTERNS)
+   * \param byte_interval Minimum time between transmitted bytes (usecs)
+   *
+   * NOTE: Every reply pattern is registered before the first request goes
+   *       out, so the requests needn't wait on each other's round trips. A
+   *       request may have any number of replies (including none), and the
+   *       replies may arrive in any order. Call _endPipeline once done
+   *       w/ the replies (it is called here if sending fails).
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_sendPipelinedMessages( const SICK_MSG_CLASS * const send_messages[],
+										const unsigned int num_send_messages,
+										sick_pending_reply_t pending_replies[],
+										const unsigned int num_pending_replies,
+										const unsigned int byte_interval ) throw( SickIOException ) {
+
+    for (unsigned int i = 0; i < num_pending_replies; i++) {
+      pending_replies[i].received = false;
+      pending_replies[i].pattern_id = 0;
+    }
+
+    try {
+
+      /* Have the monitor set the replies aside (before any can possibly arrive) */
+      for (unsigned int i = 0; i < num_pending_replies; i++) {
+	pending_replies[i].pattern_id = _sick_buffer_monitor->RegisterReplyPattern(pending_replies[i].byte_sequence,pending_replies[i].byte_sequence_length);
+      }
+
+      /* Put all of the requests on the wire */
+      for (unsigned int i = 0; i < num_send_messages; i++) {
+	_sendMessage(*send_messages[i],byte_interval);
+      }
+
+    }
+
+    /* Handle a bad pattern (or too many of them) */
+    catch (SickConfigException &sick_config_exception) {
+      std::cerr << sick_config_exception.what() << std::endl;
+      _endPipeline(pending_replies,num_pending_replies);
+      throw SickIOException("SickLIDAR::_sendPipelinedMessages: Unable to register reply pattern!");
+    }
+
+    /* Handle write buffer exceptions */
+    catch (SickIOException &sick_io_error) {
+      std::cerr << sick_io_error.what() << std::endl;
+      _endPipeline(pending_replies,num_pending_replies);
+      throw;
+    }
+
+    /* A safety net */
+    catch (...) {
+      std::cerr << "SickLIDAR::_sendPipelinedMessages: Unknown exception!!!" << std::endl;
+      _endPipeline(pending_replies,num_pending_replies);
+      throw;
+    }
+
+  }
+
+  /**
+   * \brief Waits for a particular reply to pipelined requests
+   * \param pending_replies The expected replies
+   * \param num_pending_replies The number of expected replies
+   * \param reply_index The reply to wait for
+   * \param timeout_value The max time to wait (usecs)
+   *
+   * NOTE: Replies to the other requests that show up in the meantime are
+   *       filed in their slots (the first pending slot w/ a matching
+   *       sequence), so no reply is lost to the order of the waits.
+   *       Replies that match no pending slot are discarded.
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_recvPipelinedReply( sick_pending_reply_t pending_replies[],
+									     const unsigned int num_pending_replies,
+									     const unsigned int reply_index,
+									     const unsigned int timeout_value ) const throw( SickTimeoutException ) {
+
+    /* Timespec structs for handling timeouts */
+    struct timespec beg_time, end_time;
+    double elapsed_time = 0;
+
+    /* A container for the message */
+    SICK_MSG_CLASS curr_message;
+
+    /* Get the current (monotonic) time */
+    clock_gettime(CLOCK_MONOTONIC,&beg_time);
+
+    /* Check until it is found or a timeout */
+    while (!pending_replies[reply_index].received) {
+
+      /* Attempt to acquire a reply (waiting out whatever time remains) */
+      if (_sick_buffer_monitor->GetNextReplyFromMonitor(curr_message,timeout_value - (unsigned int)elapsed_time)) {
+
+	/* File it w/ the first pending reply it matches */
+	for (unsigned int i = 0; i < num_pending_replies; i++) {
+
+	  sick_pending_reply_t &pending_reply = pending_replies[i];
+	  if (!pending_reply.received &&
+	      curr_message.GetPayloadLength() >= pending_reply.byte_sequence_length &&
+	      memcmp(curr_message.GetPayloadPtr(),pending_reply.byte_sequence,pending_reply.byte_sequence_length) == 0) {
+	    pending_reply.recv_message->Swap(curr_message);
+	    pending_reply.received = true;
+	    break;
+	  }
+
+	}
+
+      }
+
+      /* Check whether the allowed time has expired */
+      clock_gettime(CLOCK_MONOTONIC,&end_time);
+      if ((elapsed_time = _computeElapsedTime(beg_time,end_time)) >= timeout_value && !pending_replies[reply_index].received) {
+	throw SickTimeoutException("SickLIDAR::_recvPipelinedReply: Timeout occurred!");
+      }
+
+    }
+
+  }
+
+  /**
+   * \brief Hands whatever matches the pending replies back to the data channel
+   * \param pending_replies The expected replies
+   * \param num_pending_replies The number of expected replies
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_endPipeline( sick_pending_reply_t pending_replies[], const unsigned int num_pending_replies ) const {
+
+    for (unsigned int i = 0; i < num_pending_replies; i++) {
+      if (pending_replies[i].pattern_id != 0) {
+	_sick_buffer_monitor->UnregisterReplyPattern(pending_replies[i].pattern_id);
+	pending_replies[i].pattern_id = 0;
+      }
+    }
+
+  }
+
+  /**
+   * \brief Sends several requests back to back and waits for all of their replies
+   * \param send_messages The requests (sent in order)
+   * \param num_send_messages The number of requests
+   * \param pending_replies The expected replies (their byte sequences and destinations must be set)
+   * \param num_pending_replies The number of expected replies
+   * \param byte_interval Minimum time between transmitted bytes (usecs)
+   * \param timeout_value The max time to wait for all of the replies (usecs)
+   *
+   * NOTE: Only suitable for requests that don't depend on one another.
+   *       Nothing is resent; the whole batch costs a single round trip.
+   */
+  template< class SICK_MONITOR_CLASS, class SICK_MSG_CLASS >
+  void SickLIDAR< SICK_MONITOR_CLASS, SICK_MSG_CLASS >::_sendMessagesAndGetReplies( const SICK_MSG_CLASS * const send_messages[],
+										    const unsigned int num_send_messages,
+										    sick_pending_reply_t pending_replies[],
+										    const unsigned int num_pending_replies,
+										    const unsigned int byte_interval,
+										    const unsigned int timeout_value )
+										    throw( SickTimeoutException, SickIOException ) {
+
+    _sendPipelinedMessages(send_messages,num_send_messages,pending_replies,num_pending_replies,byte_interval);
+
+    /* Timespec structs for sharing the timeout among the replies */
+    struct timespec beg_time, end_time;
+    clock_gettime(CLOCK_MONOTONIC,&beg_time);
+
+    try {
+
+      for (unsigned int i = 0; i < num_pending_replies; i++) {
+
+	clock_gettime(CLOCK_MONOTONIC,&end_time);
+	const double elapsed_time = _computeElapsedTime(beg_time,end_time);
+	if (elapsed_time >= timeout_value) {
+	  throw SickTimeoutException("SickLIDAR::_sendMessagesAndGetReplies: Timeout occurred!");
+	}
+
+	_recvPipelinedReply(pending_replies,num_pending_replies,i,timeout_value - (unsigned int)elapsed_time);
+
+      }
+
+    }
+
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout) {
+      _endPipeline(pending_replies,num_pending_replies);
+      throw;
+    }
+
+    /* A safety net */
+    catch (...) {
+      std::cerr << "SickLIDAR::_sendMessagesAndGetReplies: Unknown exception!!!" << std::endl;
+      _endPipeline(pending_replies,num_pending_replies);
+      throw;
+    }
+
+    /* Subsequent matches belong on the data channel again */
+    _endPipeline(pending_replies,num_pending_replies);
+
+  }
   
 } /* namespace SickToolbox */
 
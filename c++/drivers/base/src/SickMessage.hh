@@ -18,6 +18,8 @@
 
 /* Dependencies */
 #include <arpa/inet.h>
+#include <time.h>
+#include <string.h>
 #include <iomanip>
 #include <iostream>
 
@@ -42,6 +44,15 @@ namespace SickToolbox {
     /** A standard constructor */
     SickMessage( );
 
+    /** A copy constructor (copies only the populated portion of the buffer) */
+    SickMessage( const SickMessage &sick_message );
+
+    /** An assignment operator (copies only the populated portion of the buffer) */
+    SickMessage & operator=( const SickMessage &sick_message );
+
+    /** Exchanges contents w/ another message w/o copying either buffer */
+    void Swap( SickMessage &sick_message );
+
     /** Construct a well-formed Sick message */
     void BuildMessage( const uint8_t * const payload_buffer, const unsigned int payload_length );
     
@@ -57,6 +68,9 @@ namespace SickToolbox {
     /** Returns a copy of the raw message payload */
     void GetPayload( uint8_t * const payload_buffer ) const;
 
+    /** Returns a read-only view of the payload (valid until the message is modified, cleared or swapped) */
+    const uint8_t * GetPayloadPtr( ) const { return &_message_buffer[MESSAGE_HEADER_LENGTH]; }
+
     /** Returns a copy of the payload as a C String */
     void GetPayloadAsCStr( char * const payload_str ) const;
     
@@ -69,6 +83,12 @@ namespace SickToolbox {
     
     /** Indicates whether the message container is populated */
     bool IsPopulated( ) const { return _populated; };
+
+    /** Records when the first byte of the message arrived (CLOCK_REALTIME) */
+    void SetArrivalTime( const struct timespec &arrival_time ) { _arrival_time = arrival_time; }
+
+    /** Gets when the first byte of the message arrived (zero if unknown) */
+    const struct timespec & GetArrivalTime( ) const { return _arrival_time; }
     
     /** Clear the contents of the message container/object */
     virtual void Clear( );
@@ -87,12 +107,15 @@ namespace SickToolbox {
     /** The length of the message in bytes */
     unsigned int _message_length;
 
-    /** The message as a raw sequence of bytes */
-    uint8_t _message_buffer[MESSAGE_MAX_LENGTH];
+    /** The message as a raw sequence of bytes (heap allocated so it can be handed off by swapping) */
+    uint8_t *_message_buffer;
 
     /** Indicates whether the message container/object is populated */
     bool _populated;
 
+    /** When the first byte of the message arrived */
+    struct timespec _arrival_time;
+
   };
 
 
@@ -100,7 +123,82 @@ namespace SickToolbox {
    * \brief A default constructor
    */
   template< unsigned int MSG_HEADER_LENGTH, unsigned int MSG_PAYLOAD_MAX_LENGTH, unsigned int MSG_TRAILER_LENGTH >
-  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::SickMessage( ) { }
+  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::SickMessage( ) :
+    _payload_length(0), _message_length(0), _message_buffer(new uint8_t[MESSAGE_MAX_LENGTH]), _populated(false) {
+
+    /* Start w/ a clean buffer (Clear() doesn't bother zeroing it) */
+    memset(_message_buffer,0,MESSAGE_MAX_LENGTH);
+    memset(&_arrival_time,0,sizeof(_arrival_time));
+
+  }
+
+  /**
+   * \brief A copy constructor
+   * \param &sick_message The message to copy
+   */
+  template< unsigned int MSG_HEADER_LENGTH, unsigned int MSG_PAYLOAD_MAX_LENGTH, unsigned int MSG_TRAILER_LENGTH >
+  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::SickMessage( const SickMessage &sick_message ) :
+    _payload_length(sick_message._payload_length), _message_length(sick_message._message_length),
+    _message_buffer(new uint8_t[MESSAGE_MAX_LENGTH]), _populated(sick_message._populated),
+    _arrival_time(sick_message._arrival_time) {
+
+    memset(_message_buffer,0,MESSAGE_MAX_LENGTH);
+    memcpy(_message_buffer,sick_message._message_buffer,_message_length);
+
+  }
+
+  /**
+   * \brief An assignment operator
+   * \param &sick_message The message to copy
+   * \return A reference to this message
+   */
+  template< unsigned int MSG_HEADER_LENGTH, unsigned int MSG_PAYLOAD_MAX_LENGTH, unsigned int MSG_TRAILER_LENGTH >
+  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH > &
+  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::operator=( const SickMessage &sick_message ) {
+
+    if (this != &sick_message) {
+      _payload_length = sick_message._payload_length;
+      _message_length = sick_message._message_length;
+      _populated = sick_message._populated;
+      _arrival_time = sick_message._arrival_time;
+      memcpy(_message_buffer,sick_message._message_buffer,_message_length);
+    }
+
+    return *this;
+  }
+
+  /**
+   * \brief Exchanges the contents of two messages
+   * \param &sick_message The message to swap with
+   *
+   * NOTE: Only the buffer pointers are exchanged, so this is how messages
+   *       are handed between the buffer monitor and its consumers. Derived
+   *       classes w/ additional fields must swap those as well.
+   */
+  template< unsigned int MSG_HEADER_LENGTH, unsigned int MSG_PAYLOAD_MAX_LENGTH, unsigned int MSG_TRAILER_LENGTH >
+  void SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::Swap( SickMessage &sick_message ) {
+
+    uint8_t *message_buffer = _message_buffer;
+    _message_buffer = sick_message._message_buffer;
+    sick_message._message_buffer = message_buffer;
+
+    unsigned int length = _payload_length;
+    _payload_length = sick_message._payload_length;
+    sick_message._payload_length = length;
+
+    length = _message_length;
+    _message_length = sick_message._message_length;
+    sick_message._message_length = length;
+
+    bool populated = _populated;
+    _populated = sick_message._populated;
+    sick_message._populated = populated;
+
+    struct timespec arrival_time = _arrival_time;
+    _arrival_time = sick_message._arrival_time;
+    sick_message._arrival_time = arrival_time;
+
+  }
 
   /**
    * \brief Constructs a Sick message given the parameter values
@@ -179,7 +277,10 @@ namespace SickToolbox {
   }
   
   /**
-   * \brief Reset all internal fields and buffers
+   * \brief Reset all internal fields
+   *
+   * NOTE: The buffer itself isn't zeroed; nothing past _message_length is
+   *       meaningful.
    */
   template< unsigned int MSG_HEADER_LENGTH, unsigned int MSG_PAYLOAD_MAX_LENGTH, unsigned int MSG_TRAILER_LENGTH >
   void SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::Clear( ) {
@@ -187,11 +288,11 @@ namespace SickToolbox {
     /* Reset the parent integer variables */
     _message_length = _payload_length = 0;
 
-    /* Clear the message buffer */
-    memset(_message_buffer,0,MESSAGE_MAX_LENGTH);
-
     /* Set the flag indicating this message object/container is empty */
     _populated = false;
+
+    /* Whatever arrives next gets its own timestamp */
+    _arrival_time.tv_sec = _arrival_time.tv_nsec = 0;
   }
   
   /**
@@ -223,7 +324,12 @@ namespace SickToolbox {
    * \brief A destructor
    */
   template< unsigned int MSG_HEADER_LENGTH, unsigned int MSG_PAYLOAD_MAX_LENGTH, unsigned int MSG_TRAILER_LENGTH >
-  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::~SickMessage() { }
+  SickMessage< MSG_HEADER_LENGTH, MSG_PAYLOAD_MAX_LENGTH, MSG_TRAILER_LENGTH >::~SickMessage() {
+
+    /* Release the buffer */
+    delete [] _message_buffer;
+    
+  }
   
 } /* namespace SickToolbox */
 
@@ -0,0 +1,378 @@
+/*!
+ * \file SickMessageQueue.hh
+ * \brief Defines a bounded queue for passing messages between a
+ *        buffer monitor and the driver.
+ *
+ * Code by Jason C. Derenick and Thomas H. Miller.
+ * Contact derenick(at)lehigh(dot)edu
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * Copyright (c) 2008, Jason C. Derenick and Thomas H. Miller
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_MESSAGE_QUEUE
+#define SICK_MESSAGE_QUEUE
+
+/* Macros */
+#define DEFAULT_SICK_MESSAGE_QUEUE_DEPTH                   (16)  ///< Default number of messages the monitor will hold
+
+/* Dependencies */
+#include <new>
+#include <iostream>
+#include "SickException.hh"
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \enum sick_message_queue_overflow_policy_t
+   * \brief Defines what happens when a message arrives and the queue is full
+   */
+  enum sick_message_queue_overflow_policy_t {
+    SICK_MESSAGE_QUEUE_DROP_OLDEST = 0x00,                                ///< Discard the oldest queued message to make room
+    SICK_MESSAGE_QUEUE_DROP_NEWEST = 0x01                                 ///< Discard the newly arrived message
+  };
+
+  /**
+   * \class SickMessageQueue
+   * \brief A bounded, lock-free ring of messages
+   *
+   * Each slot carries a sequence number telling producers and consumers
+   * whether it is free or holds a message for the current lap of the ring,
+   * so neither side ever takes a lock. Although the buffer monitor is the
+   * only producer, it is also allowed to pop (to drop the oldest message
+   * on overflow), so the dequeue side is safe for multiple consumers.
+   *
+   * Messages are moved in and out by swapping buffers w/ the caller, so
+   * handing a message off never copies it.
+   */
+  template < class SICK_MSG_CLASS >
+  class SickMessageQueue {
+
+  public:
+
+    /** A standard constructor */
+    SickMessageQueue( const unsigned int queue_depth = DEFAULT_SICK_MESSAGE_QUEUE_DEPTH,
+		      const sick_message_queue_overflow_policy_t overflow_policy = SICK_MESSAGE_QUEUE_DROP_OLDEST ) throw( SickConfigException );
+
+    /** Resizes the queue, discarding its contents (not thread safe!) */
+    void Reset( const unsigned int queue_depth, const sick_message_queue_overflow_policy_t overflow_policy ) throw( SickConfigException );
+
+    /** Appends a message to the queue (applying the overflow policy if it is full) */
+    bool Push( SICK_MSG_CLASS &sick_message );
+
+    /** Removes the oldest message from the queue */
+    bool Pop( SICK_MSG_CLASS &sick_message );
+
+    /** Discards all queued messages */
+    void Clear( );
+
+    /** Gets the number of slots in the queue */
+    unsigned int GetDepth( ) const { return _queue_mask + 1; }
+
+    /** Gets the overflow policy */
+    sick_message_queue_overflow_policy_t GetOverflowPolicy( ) const { return _overflow_policy; }
+
+    /** Gets the number of messages discarded due to overflow */
+    unsigned long GetNumDropped( ) const { return _num_dropped; }
+
+    /** A standard destructor */
+    ~SickMessageQueue( );
+
+  private:
+
+    /**
+     * \struct sick_message_queue_cell_t
+     * \brief A single slot in the ring
+     */
+    struct sick_message_queue_cell_t {
+      volatile unsigned long sequence;                                    ///< Position the slot is waiting to be pushed/popped at
+      SICK_MSG_CLASS message;                                             ///< The queued message
+    };
+
+    /** The ring of slots */
+    sick_message_queue_cell_t *_queue_cells;
+
+    /** Number of slots minus one (the depth is a power of two) */
+    unsigned long _queue_mask;
+
+    /** What to do when the queue is full */
+    sick_message_queue_overflow_policy_t _overflow_policy;
+
+    /** Position of the next push */
+    volatile unsigned long _enqueue_pos;
+
+    /** Position of the next pop */
+    volatile unsigned long _dequeue_pos;
+
+    /** Number of messages discarded due to overflow */
+    volatile unsigned long _num_dropped;
+
+    /** Attempts to append a message (fails if the queue is full) */
+    bool _tryPush( SICK_MSG_CLASS &sick_message );
+
+    /** Allocates and initializes the ring */
+    void _allocateCells( const unsigned int queue_depth ) throw( SickConfigException );
+
+    /** Deallocates the ring */
+    void _deallocateCells( );
+
+    /** Prevent copying (the queue owns its ring) */
+    SickMessageQueue( const SickMessageQueue & );
+    SickMessageQueue & operator=( const SickMessageQueue & );
+
+  };
+
+  /**
+   * \brief A standard constructor
+   * \param queue_depth Number of messages the queue can hold (rounded up to a power of two)
+   * \param overflow_policy What to do when a message arrives and the queue is full
+   */
+  template < class SICK_MSG_CLASS >
+  SickMessageQueue< SICK_MSG_CLASS >::SickMessageQueue( const unsigned int queue_depth,
+							 const sick_message_queue_overflow_policy_t overflow_policy ) throw( SickConfigException ) :
+    _queue_cells(NULL), _queue_mask(0), _overflow_policy(overflow_policy), _enqueue_pos(0), _dequeue_pos(0), _num_dropped(0) {
+
+    /* Setup the ring */
+    _allocateCells(queue_depth);
+
+  }
+
+  /**
+   * \brief Resizes the queue and sets its overflow policy
+   * \param queue_depth Number of messages the queue can hold (rounded up to a power of two)
+   * \param overflow_policy What to do when a message arrives and the queue is full
+   *
+   * NOTE: Any queued messages are discarded. No other thread may be
+   *       accessing the queue while it is being reset.
+   */
+  template < class SICK_MSG_CLASS >
+  void SickMessageQueue< SICK_MSG_CLASS >::Reset( const unsigned int queue_depth,
+						   const sick_message_queue_overflow_policy_t overflow_policy ) throw( SickConfigException ) {
+
+    /* Swap in a new ring */
+    _deallocateCells();
+    _allocateCells(queue_depth);
+
+    _overflow_policy = overflow_policy;
+    _num_dropped = 0;
+
+  }
+
+  /**
+   * \brief Appends a message to the queue
+   * \param &sick_message The message to append (swapped w/ an empty buffer if queued)
+   * \return True if the given message was queued, False if it was dropped
+   *
+   * NOTE: When the queue is full and the policy is drop-oldest, the oldest
+   *       message is popped to make room. Should that slot still be in use
+   *       by a consumer, the new message is dropped instead so the caller
+   *       never blocks.
+   */
+  template < class SICK_MSG_CLASS >
+  bool SickMessageQueue< SICK_MSG_CLASS >::Push( SICK_MSG_CLASS &sick_message ) {
+
+    /* The common case */
+    if (_tryPush(sick_message)) {
+      return true;
+    }
+
+    /* Make room by discarding the oldest message(s) */
+    if (_overflow_policy == SICK_MESSAGE_QUEUE_DROP_OLDEST) {
+
+      SICK_MSG_CLASS oldest_message;
+      while (Pop(oldest_message)) {
+
+	__sync_fetch_and_add(&_num_dropped,1);
+
+	if (_tryPush(sick_message)) {
+	  return true;
+	}
+
+      }
+
+    }
+
+    /* The new message goes */
+    __sync_fetch_and_add(&_num_dropped,1);
+    return false;
+
+  }
+
+  /**
+   * \brief Removes the oldest message from the queue
+   * \param &sick_message Populated with the oldest message
+   * \return True if a message was popped, False if the queue is empty
+   */
+  template < class SICK_MSG_CLASS >
+  bool SickMessageQueue< SICK_MSG_CLASS >::Pop( SICK_MSG_CLASS &sick_message ) {
+
+    sick_message_queue_cell_t *cell = NULL;
+    unsigned long pos = _dequeue_pos;
+
+    /* Claim the slot at the head of the queue */
+    for (;;) {
+
+      cell = &_queue_cells[pos & _queue_mask];
+      long difference = (long)cell->sequence - (long)(pos + 1);
+      __sync_synchronize();
+
+      if (difference == 0) {
+
+	/* Populated for this lap, try to claim it */
+	if (__sync_bool_compare_and_swap(&_dequeue_pos,pos,pos + 1)) {
+	  break;
+	}
+
+      }
+      else if (difference < 0) {
+
+	/* Nothing has been pushed here yet */
+	return false;
+
+      }
+
+      /* Somebody beat us to it */
+      pos = _dequeue_pos;
+
+    }
+
+    /* Take the message (the slot keeps the caller's old buffer) */
+    sick_message.Swap(cell->message);
+    cell->message.Clear();
+
+    /* Hand the slot back to the producer for the next lap */
+    __sync_synchronize();
+    cell->sequence = pos + _queue_mask + 1;
+
+    return true;
+
+  }
+
+  /**
+   * \brief Discards all queued messages
+   */
+  template < class SICK_MSG_CLASS >
+  void SickMessageQueue< SICK_MSG_CLASS >::Clear( ) {
+
+    SICK_MSG_CLASS discarded_message;
+    while (Pop(discarded_message));
+
+  }
+
+  /**
+   * \brief A standard destructor
+   */
+  template < class SICK_MSG_CLASS >
+  SickMessageQueue< SICK_MSG_CLASS >::~SickMessageQueue( ) {
+
+    /* Release the ring */
+    _deallocateCells();
+
+  }
+
+  /**
+   * \brief Attempts to append a message to the queue
+   * \param &sick_message The message to append (swapped w/ the slot's empty buffer if queued)
+   * \return True if the message was queued, False if the queue is full
+   */
+  template < class SICK_MSG_CLASS >
+  bool SickMessageQueue< SICK_MSG_CLASS >::_tryPush( SICK_MSG_CLASS &sick_message ) {
+
+    sick_message_queue_cell_t *cell = NULL;
+    unsigned long pos = _enqueue_pos;
+
+    /* Claim the slot at the tail of the queue */
+    for (;;) {
+
+      cell = &_queue_cells[pos & _queue_mask];
+      long difference = (long)cell->sequence - (long)pos;
+      __sync_synchronize();
+
+      if (difference == 0) {
+
+	/* Free for this lap, try to claim it */
+	if (__sync_bool_compare_and_swap(&_enqueue_pos,pos,pos + 1)) {
+	  break;
+	}
+
+      }
+      else if (difference < 0) {
+
+	/* The slot hasn't been consumed yet (full) */
+	return false;
+
+      }
+
+      /* Somebody beat us to it */
+      pos = _enqueue_pos;
+
+    }
+
+    /* Store the message */
+    cell->message.Swap(sick_message);
+
+    /* Publish it to the consumer(s) */
+    __sync_synchronize();
+    cell->sequence = pos + 1;
+
+    return true;
+
+  }
+
+  /**
+   * \brief Allocates the ring
+   * \param queue_depth Number of messages the queue can hold (rounded up to a power of two)
+   */
+  template < class SICK_MSG_CLASS >
+  void SickMessageQueue< SICK_MSG_CLASS >::_allocateCells( const unsigned int queue_depth ) throw( SickConfigException ) {
+
+    /* Sanity check */
+    if (queue_depth == 0) {
+      throw SickConfigException("SickMessageQueue::_allocateCells: Queue depth must be nonzero!");
+    }
+
+    /* Round up to the nearest power of two (so positions can be masked) */
+    unsigned long num_cells = 1;
+    while (num_cells < queue_depth) {
+      num_cells <<= 1;
+    }
+
+    try {
+      _queue_cells = new sick_message_queue_cell_t[num_cells];
+    }
+    catch ( std::bad_alloc &allocation_exception ) {
+      std::cerr << "SickMessageQueue::_allocateCells: Allocation error - " << allocation_exception.what() << std::endl;
+      throw SickConfigException("SickMessageQueue::_allocateCells: Allocation failed!");
+    }
+
+    /* Each slot starts out free for the first lap */
+    for (unsigned long i = 0; i < num_cells; i++) {
+      _queue_cells[i].sequence = i;
+    }
+
+    _queue_mask = num_cells - 1;
+    _enqueue_pos = _dequeue_pos = 0;
+
+  }
+
+  /**
+   * \brief Deallocates the ring
+   */
+  template < class SICK_MSG_CLASS >
+  void SickMessageQueue< SICK_MSG_CLASS >::_deallocateCells( ) {
+
+    if (_queue_cells) {
+      delete [] _queue_cells;
+      _queue_cells = NULL;
+    }
+
+  }
+
+} /* namespace SickToolbox */
+
+#endif /* SICK_MESSAGE_QUEUE */
@@ -0,0 +1,385 @@
+/*!
+ * \file SickReactor.hh
+ * \brief Defines a reactor for servicing the data streams of
+ *        several Sick LIDARs from a single thread.
+ *
+ * Code by Jason C. Derenick and Thomas H. Miller.
+ * Contact derenick(at)lehigh(dot)edu
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * Copyright (c) 2008, Jason C. Derenick and Thomas H. Miller
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_REACTOR
+#define SICK_REACTOR
+
+/* Macros */
+#define SICK_REACTOR_MAX_EVENTS                            (16)  ///< Max number of events handled per epoll_wait()
+
+/* Dependencies */
+#include <map>
+#include <utility>
+#include <iostream>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include "SickException.hh"
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /** Called from the reactor thread when a registered fd is readable */
+  typedef void (*sick_reactor_handler_t)( void * handler_args );
+
+  /**
+   * \class SickReactor
+   * \brief Multiplexes the data streams of any number of devices onto one thread
+   *
+   * Each buffer monitor attached to a reactor registers its data stream
+   * rather than spawning its own thread. The reactor waits on all of them
+   * with epoll and hands each readable stream back to its monitor, which
+   * frames whatever bytes are available without blocking.
+   *
+   * Handlers (and so any scan callbacks they run) share the reactor
+   * thread, so a handler that blocks stalls every stream on the reactor.
+   * A reactor must outlive every driver attached to it.
+   */
+  class SickReactor {
+
+  public:
+
+    /** A standard constructor */
+    SickReactor( ) throw( SickThreadException );
+
+    /** Registers a data stream and the handler to call when it is readable */
+    void Register( const int fd, const sick_reactor_handler_t handler, void * const handler_args ) throw( SickThreadException );
+
+    /** Unregisters a data stream (the handler will not be called once this returns, unless it is the caller) */
+    void Unregister( const int fd ) throw( SickThreadException );
+
+    /** Gets the number of registered data streams */
+    unsigned int GetNumRegistered( ) const { return _handlers.size(); }
+
+    /** A standard destructor (stops the reactor thread) */
+    ~SickReactor( );
+
+  private:
+
+    /** The epoll instance */
+    int _epoll_fd;
+
+    /** A pipe used to wake the reactor thread */
+    int _wake_pipe[2];
+
+    /** Reactor thread ID */
+    pthread_t _reactor_thread_id;
+
+    /** Indicates whether the reactor thread is running */
+    volatile bool _reactor_running;
+
+    /** Guards the handler map and the running handler's fd */
+    pthread_mutex_t _handler_mutex;
+
+    /** Signaled when a handler returns */
+    pthread_cond_t _handler_cond;
+
+    /** The fd whose handler is running (-1 if none) */
+    int _running_fd;
+
+    /** Maps each registered fd to its handler and the handler's argument */
+    std::map< int, std::pair< sick_reactor_handler_t, void * > > _handlers;
+
+    /** Starts the reactor thread */
+    void _startReactor( ) throw( SickThreadException );
+
+    /** Stops the reactor thread */
+    void _stopReactor( ) throw( SickThreadException );
+
+    /** Entry point for the reactor thread */
+    static void * _reactorThread( void * thread_args );
+
+    /** Prevent copying (the reactor owns its fds) */
+    SickReactor( const SickReactor & );
+    SickReactor & operator=( const SickReactor & );
+
+  };
+
+  /**
+   * \brief A standard constructor
+   */
+  inline SickReactor::SickReactor( ) throw( SickThreadException ) :
+    _epoll_fd(-1), _reactor_thread_id(0), _reactor_running(false), _running_fd(-1) {
+
+    _wake_pipe[0] = _wake_pipe[1] = -1;
+
+    /* Create the epoll instance */
+    if ((_epoll_fd = epoll_create(SICK_REACTOR_MAX_EVENTS)) < 0) {
+      throw SickThreadException("SickReactor::SickReactor: epoll_create() failed!");
+    }
+
+    /* Create the wake pipe (the read end is non-blocking so it can be drained) */
+    if (pipe(_wake_pipe) != 0 || fcntl(_wake_pipe[0],F_SETFL,fcntl(_wake_pipe[0],F_GETFL) | O_NONBLOCK) < 0) {
+      throw SickThreadException("SickReactor::SickReactor: pipe() failed!");
+    }
+
+    struct epoll_event wake_event;
+    wake_event.events = EPOLLIN;
+    wake_event.data.fd = _wake_pipe[0];
+    if (epoll_ctl(_epoll_fd,EPOLL_CTL_ADD,_wake_pipe[0],&wake_event) != 0) {
+      throw SickThreadException("SickReactor::SickReactor: epoll_ctl() failed!");
+    }
+
+    /* Initialize the handler mutex */
+    if (pthread_mutex_init(&_handler_mutex,NULL) != 0) {
+      throw SickThreadException("SickReactor::SickReactor: pthread_mutex_init() failed!");
+    }
+
+    /* Initialize the handler condition */
+    if (pthread_cond_init(&_handler_cond,NULL) != 0) {
+      throw SickThreadException("SickReactor::SickReactor: pthread_cond_init() failed!");
+    }
+
+  }
+
+  /**
+   * \brief Registers a data stream with the reactor
+   * \param fd The data stream file descriptor
+   * \param handler The handler to call when the stream is readable
+   * \param *handler_args The argument passed to the handler
+   */
+  inline void SickReactor::Register( const int fd, const sick_reactor_handler_t handler, void * const handler_args ) throw( SickThreadException ) {
+
+    if (pthread_mutex_lock(&_handler_mutex) != 0) {
+      throw SickThreadException("SickReactor::Register: pthread_mutex_lock() failed!");
+    }
+
+    /* Start servicing streams on the first registration */
+    if (!_reactor_running) {
+
+      try {
+	_startReactor();
+      }
+      catch(...) {
+	pthread_mutex_unlock(&_handler_mutex);
+	throw;
+      }
+      
+    }
+
+    _handlers[fd] = std::make_pair(handler,handler_args);
+
+    struct epoll_event stream_event;
+    stream_event.events = EPOLLIN;
+    stream_event.data.fd = fd;
+    int ctl_result = epoll_ctl(_epoll_fd,EPOLL_CTL_ADD,fd,&stream_event);
+
+    if (ctl_result != 0) {
+      _handlers.erase(fd);
+    }
+
+    pthread_mutex_unlock(&_handler_mutex);
+
+    if (ctl_result != 0) {
+      throw SickThreadException("SickReactor::Register: epoll_ctl() failed!");
+    }
+
+  }
+
+  /**
+   * \brief Unregisters a data stream
+   * \param fd The data stream file descriptor
+   *
+   * NOTE: If the stream's handler is running on another thread, this waits
+   *       for it to return, so once this returns the handler is guaranteed
+   *       not to be running or to run again. Called from the handler itself
+   *       (e.g. a scan callback stopping its driver), it returns at once and
+   *       the handler won't be run again once it returns.
+   */
+  inline void SickReactor::Unregister( const int fd ) throw( SickThreadException ) {
+
+    if (pthread_mutex_lock(&_handler_mutex) != 0) {
+      throw SickThreadException("SickReactor::Unregister: pthread_mutex_lock() failed!");
+    }
+
+    /* It may already have been dropped from epoll after an error */
+    epoll_ctl(_epoll_fd,EPOLL_CTL_DEL,fd,NULL);
+    _handlers.erase(fd);
+
+    /* Wait out the handler (unless we are it) */
+    if (!_reactor_running || !pthread_equal(pthread_self(),_reactor_thread_id)) {
+      while (_running_fd == fd) {
+	pthread_cond_wait(&_handler_cond,&_handler_mutex);
+      }
+    }
+
+    pthread_mutex_unlock(&_handler_mutex);
+
+  }
+
+  /**
+   * \brief A standard destructor
+   */
+  inline SickReactor::~SickReactor( ) {
+
+    try {
+      _stopReactor();
+    }
+
+    /* Handle thread exception */
+    catch(SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+    }
+
+    /* Release the fds */
+    close(_wake_pipe[0]);
+    close(_wake_pipe[1]);
+    close(_epoll_fd);
+
+    pthread_cond_destroy(&_handler_cond);
+    pthread_mutex_destroy(&_handler_mutex);
+
+  }
+
+  /**
+   * \brief Starts the reactor thread
+   */
+  inline void SickReactor::_startReactor( ) throw( SickThreadException ) {
+
+    _reactor_running = true;
+
+    if (pthread_create(&_reactor_thread_id,NULL,SickReactor::_reactorThread,this) != 0) {
+      _reactor_running = false;
+      throw SickThreadException("SickReactor::_startReactor: pthread_create() failed!");
+    }
+
+  }
+
+  /**
+   * \brief Stops the reactor thread
+   */
+  inline void SickReactor::_stopReactor( ) throw( SickThreadException ) {
+
+    if (!_reactor_running) {
+      return;
+    }
+
+    /* Tell the thread to quit and poke it */
+    _reactor_running = false;
+
+    const char wake_byte = 0;
+    if (write(_wake_pipe[1],&wake_byte,1) != 1) {
+      throw SickThreadException("SickReactor::_stopReactor: write() failed!");
+    }
+
+    /* Wait for it to exit */
+    void *reactor_result = NULL;
+    if (pthread_join(_reactor_thread_id,&reactor_result) != 0) {
+      throw SickThreadException("SickReactor::_stopReactor: pthread_join() failed!");
+    }
+
+  }
+
+  /**
+   * \brief The reactor thread
+   * \param *thread_args The reactor instance
+   */
+  inline void * SickReactor::_reactorThread( void * thread_args ) {
+
+    SickReactor *reactor = (SickReactor *)thread_args;
+    struct epoll_event events[SICK_REACTOR_MAX_EVENTS];
+
+    while (reactor->_reactor_running) {
+
+      int num_events = epoll_wait(reactor->_epoll_fd,events,SICK_REACTOR_MAX_EVENTS,-1);
+      if (num_events < 0) {
+
+	if (errno != EINTR) {
+	  std::cerr << "SickReactor::_reactorThread: epoll_wait() failed!" << std::endl;
+	  usleep(1000);
+	}
+
+	continue;
+      }
+
+      for (int i = 0; i < num_events; i++) {
+
+	int fd = events[i].data.fd;
+
+	/* Drain wake-ups (the loop condition does the rest) */
+	if (fd == reactor->_wake_pipe[0]) {
+	  char wake_buffer[16];
+	  while (read(fd,wake_buffer,sizeof(wake_buffer)) > 0);
+	  continue;
+	}
+
+	pthread_mutex_lock(&reactor->_handler_mutex);
+
+	/* It may have been unregistered since epoll_wait() returned */
+	std::map< int, std::pair< sick_reactor_handler_t, void * > >::iterator handler_it = reactor->_handlers.find(fd);
+	if (handler_it == reactor->_handlers.end()) {
+	  pthread_mutex_unlock(&reactor->_handler_mutex);
+	  continue;
+	}
+
+	/* Run the handler w/o the mutex, so it can't hold up (un)registration */
+	std::pair< sick_reactor_handler_t, void * > handler = handler_it->second;
+	reactor->_running_fd = fd;
+	pthread_mutex_unlock(&reactor->_handler_mutex);
+
+	bool stream_broken = false;
+	
+	try {
+	  handler.first(handler.second);
+	}
+
+	/* A broken stream would otherwise keep the (level-triggered) fd firing */
+	catch(SickIOException &sick_io_exception) {
+	  std::cerr << sick_io_exception.what() << std::endl;
+	  stream_broken = true;
+	}
+
+	/* Handle thread exception */
+	catch(SickThreadException &sick_thread_exception) {
+	  std::cerr << sick_thread_exception.what() << std::endl;
+	}
+
+	/* A failsafe */
+	catch(...) {
+	  std::cerr << "SickReactor::_reactorThread: Unknown exception!" << std::endl;
+	}
+
+	/* Hung up w/ nothing left to read (epoll reports this whether asked to or not) */
+	if ((events[i].events & (EPOLLHUP | EPOLLERR)) && !(events[i].events & EPOLLIN)) {
+	  stream_broken = true;
+	}
+
+	pthread_mutex_lock(&reactor->_handler_mutex);
+
+	/* Only drop the fd if it is still ours (the handler may have unregistered it) */
+	if (stream_broken && reactor->_handlers.find(fd) != reactor->_handlers.end()) {
+	  std::cerr << "SickReactor::_reactorThread: No longer servicing fd " << fd << "!" << std::endl;
+	  epoll_ctl(reactor->_epoll_fd,EPOLL_CTL_DEL,fd,NULL);
+	}
+	
+	reactor->_running_fd = -1;
+	pthread_cond_broadcast(&reactor->_handler_cond);
+	pthread_mutex_unlock(&reactor->_handler_mutex);
+
+      }
+
+    }
+
+    /* Thread is done */
+    return NULL;
+
+  }
+
+} /* namespace SickToolbox */
+
+#endif /* SICK_REACTOR */
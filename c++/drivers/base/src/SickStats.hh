@@ -0,0 +1,455 @@
+/*!
+ * \file SickStats.hh
+ * \brief Defines counters and latency histograms for instrumenting
+ *        the acquisition path of a Sick LIDAR.
+ *
+ * Code by Jason C. Derenick and Thomas H. Miller.
+ * Contact derenick(at)lehigh(dot)edu
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * Copyright (c) 2008, Jason C. Derenick and Thomas H. Miller
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_STATS
+#define SICK_STATS
+
+/* Macros */
+#define SICK_STATS_NUM_HISTOGRAM_BINS                       (32)  ///< Number of (power of two) bins in a latency histogram
+
+/* Dependencies */
+#include <time.h>
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /*!
+   * \struct sick_stats_histogram_tag
+   * \brief A snapshot of a latency histogram
+   *
+   * Bin 0 counts samples of 0 usecs and bin i > 0 counts samples in
+   * [2^(i-1), 2^i) usecs (the last bin also takes anything larger).
+   */
+  /*!
+   * \typedef sick_stats_histogram_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_stats_histogram_tag {
+    unsigned long num_samples;                                            ///< Number of samples recorded
+    unsigned long total_usecs;                                            ///< Sum of the samples (usecs)
+    unsigned long max_usecs;                                              ///< Largest sample (usecs)
+    unsigned long bins[SICK_STATS_NUM_HISTOGRAM_BINS];                    ///< Sample counts per bin
+  } sick_stats_histogram_t;
+
+  /*!
+   * \struct sick_stats_tag
+   * \brief A snapshot of the counters kept for a device
+   */
+  /*!
+   * \typedef sick_stats_t
+   * \brief Adopt c-style convention
+   */
+  typedef struct sick_stats_tag {
+    unsigned long num_bytes_read;                                         ///< Bytes read from the data stream
+    unsigned long num_reads;                                              ///< Reads issued on the data stream
+    unsigned long num_frames;                                             ///< Messages framed
+    unsigned long num_checksum_failures;                                  ///< Frames discarded due to a bad checksum
+    unsigned long num_frames_dropped;                                     ///< Messages dropped because the queue was full
+    unsigned long num_frames_skipped;                                     ///< Messages passed over by a consumer skipping to the latest one
+    unsigned long num_scans_sequenced;                                    ///< Scans whose device counter was checked for continuity
+    unsigned long num_scans_lost;                                         ///< Scans missing from the device's sequence (never decoded)
+    unsigned long num_scan_gaps;                                          ///< Breaks in the sequence (each losing one or more scans)
+    unsigned long num_scans_duplicated;                                   ///< Scans repeating the previous counter value
+    unsigned long num_scans_reordered;                                    ///< Scans arriving after a later one
+    unsigned long num_frames_consumed;                                    ///< Messages handed to the driver/application
+    sick_stats_histogram_t framing_time;                                  ///< Time spent framing each message (w/ a monitor thread this includes waiting on the wire)
+    sick_stats_histogram_t decode_time;                                   ///< Time spent decoding scan payloads
+    sick_stats_histogram_t consumer_latency;                              ///< Time from a frame's arrival to its hand-off to the consumer
+  } sick_stats_t;
+
+  /**
+   * \class SickHistogram
+   * \brief A lock-free histogram of latencies
+   */
+  class SickHistogram {
+
+  public:
+
+    /** A standard constructor */
+    SickHistogram( ) { Reset(); }
+
+    /** Records a sample */
+    void Record( const unsigned long sample_usecs );
+
+    /** Copies out the current contents */
+    void GetSnapshot( sick_stats_histogram_t &histogram ) const;
+
+    /** Clears all samples */
+    void Reset( );
+
+  private:
+
+    /** Number of samples recorded */
+    volatile unsigned long _num_samples;
+
+    /** Sum of the samples */
+    volatile unsigned long _total_usecs;
+
+    /** Largest sample */
+    volatile unsigned long _max_usecs;
+
+    /** Sample counts per bin */
+    volatile unsigned long _bins[SICK_STATS_NUM_HISTOGRAM_BINS];
+
+  };
+
+  /**
+   * \class SickSequenceTracker
+   * \brief Follows a device's (wrapping) scan counter to account for missed scans
+   *
+   * A counter that moves ahead by less than half its range is taken as
+   * progress (anything skipped was lost), one that moves back by less
+   * than half its range as a late (reordered) scan. The counters may be
+   * read from any thread, but only one thread may record at a time.
+   */
+  class SickSequenceTracker {
+
+  public:
+
+    /** A standard constructor */
+    SickSequenceTracker( ) { Reset(); }
+
+    /** Records the counter of the next scan (returns the number of scans lost just before it) */
+    unsigned int Record( const unsigned int counter, const unsigned int counter_modulus );
+
+    /** Forgets the last counter (e.g. when the device restarts its stream) w/o touching the totals */
+    void Restart( ) { _sequence_started = false; }
+
+    /** Gets the number of scans lost just before the last one recorded */
+    unsigned int GetNumLostBeforeLast( ) const { return _num_lost_before_last; }
+
+    /** Copies the totals into a stats snapshot */
+    void GetSnapshot( sick_stats_t &sick_stats ) const;
+
+    /** Zeroes the totals and forgets the last counter */
+    void Reset( );
+
+  private:
+
+    /** Whether a counter has been recorded since the last restart */
+    volatile bool _sequence_started;
+
+    /** The newest counter recorded */
+    unsigned int _last_counter;
+
+    /** Scans lost just before the last one recorded */
+    volatile unsigned int _num_lost_before_last;
+
+    /** Scans recorded */
+    volatile unsigned long _num_scans;
+
+    /** Scans missing from the sequence */
+    volatile unsigned long _num_lost;
+
+    /** Breaks in the sequence */
+    volatile unsigned long _num_gaps;
+
+    /** Repeated counters */
+    volatile unsigned long _num_duplicates;
+
+    /** Late arrivals */
+    volatile unsigned long _num_reordered;
+
+  };
+
+  /**
+   * \class SickStats
+   * \brief Counters and histograms for the stages of the acquisition path
+   *
+   * Every update is a single atomic add (or compare-and-swap for a new
+   * maximum), so recording never takes a lock and may be done from any
+   * thread. Snapshots are consistent per field, not across fields.
+   */
+  class SickStats {
+
+  public:
+
+    /** A standard constructor */
+    SickStats( ) { Reset(); }
+
+    /** Records a read from the data stream */
+    void RecordRead( const unsigned int num_bytes_read ) {
+      __sync_fetch_and_add(&_num_reads,1);
+      __sync_fetch_and_add(&_num_bytes_read,num_bytes_read);
+    }
+
+    /** Records a framed message and how long framing it took */
+    void RecordFrame( const unsigned long framing_usecs ) {
+      __sync_fetch_and_add(&_num_frames,1);
+      _framing_time.Record(framing_usecs);
+    }
+
+    /** Records a frame discarded due to a bad checksum */
+    void RecordChecksumFailure( ) { __sync_fetch_and_add(&_num_checksum_failures,1); }
+
+    /** Records how long decoding a scan took */
+    void RecordDecode( const unsigned long decode_usecs ) { _decode_time.Record(decode_usecs); }
+
+    /** Records a message handed to its consumer (latency is measured from its arrival time) */
+    void RecordConsumed( const struct timespec &arrival_time );
+
+    /** Records messages passed over by a consumer skipping to the latest one */
+    void RecordSkipped( const unsigned long num_frames_skipped ) { __sync_fetch_and_add(&_num_frames_skipped,num_frames_skipped); }
+
+    /** Records a decoded scan's device counter (returns the number of scans lost just before it) */
+    unsigned int RecordScanCounter( const unsigned int counter, const unsigned int counter_modulus ) { return _scan_sequence.Record(counter,counter_modulus); }
+
+    /** Forgets the last scan counter (call when the device restarts its stream) */
+    void RestartScanSequence( ) { _scan_sequence.Restart(); }
+
+    /** Gets the number of scans lost just before the last one decoded */
+    unsigned int GetNumScansLostBeforeLast( ) const { return _scan_sequence.GetNumLostBeforeLast(); }
+
+    /** Copies out the current counters (the number of dropped frames is kept by the queue) */
+    void GetSnapshot( sick_stats_t &sick_stats ) const;
+
+    /** Zeroes everything */
+    void Reset( );
+
+    /** Computes the elapsed time (usecs) between two clock readings (zero if negative) */
+    static unsigned long ElapsedUsecs( const struct timespec &beg_time, const struct timespec &end_time );
+
+  private:
+
+    /** Bytes read from the data stream */
+    volatile unsigned long _num_bytes_read;
+
+    /** Reads issued on the data stream */
+    volatile unsigned long _num_reads;
+
+    /** Messages framed */
+    volatile unsigned long _num_frames;
+
+    /** Frames discarded due to a bad checksum */
+    volatile unsigned long _num_checksum_failures;
+
+    /** Messages handed to the driver/application */
+    volatile unsigned long _num_frames_consumed;
+
+    /** Messages passed over by a consumer skipping to the latest one */
+    volatile unsigned long _num_frames_skipped;
+
+    /** Time spent framing */
+    SickHistogram _framing_time;
+
+    /** Time spent decoding */
+    SickHistogram _decode_time;
+
+    /** Time from arrival to consumption */
+    SickHistogram _consumer_latency;
+
+    /** Continuity of the device's scan counter */
+    SickSequenceTracker _scan_sequence;
+
+  };
+
+  /**
+   * \brief Records a sample
+   * \param sample_usecs The sample (usecs)
+   */
+  inline void SickHistogram::Record( const unsigned long sample_usecs ) {
+
+    /* Bin by the position of the highest set bit */
+    unsigned int bin = 0;
+    if (sample_usecs > 0) {
+      bin = sizeof(unsigned long)*8 - __builtin_clzl(sample_usecs);
+      if (bin >= SICK_STATS_NUM_HISTOGRAM_BINS) {
+	bin = SICK_STATS_NUM_HISTOGRAM_BINS - 1;
+      }
+    }
+
+    __sync_fetch_and_add(&_bins[bin],1);
+    __sync_fetch_and_add(&_num_samples,1);
+    __sync_fetch_and_add(&_total_usecs,sample_usecs);
+
+    /* Only contend when there is a new max */
+    unsigned long max_usecs = _max_usecs;
+    while (sample_usecs > max_usecs && !__sync_bool_compare_and_swap(&_max_usecs,max_usecs,sample_usecs)) {
+      max_usecs = _max_usecs;
+    }
+
+  }
+
+  /**
+   * \brief Copies out the current contents of the histogram
+   * \param &histogram The destination
+   */
+  inline void SickHistogram::GetSnapshot( sick_stats_histogram_t &histogram ) const {
+
+    histogram.num_samples = _num_samples;
+    histogram.total_usecs = _total_usecs;
+    histogram.max_usecs = _max_usecs;
+
+    for (unsigned int i = 0; i < SICK_STATS_NUM_HISTOGRAM_BINS; i++) {
+      histogram.bins[i] = _bins[i];
+    }
+
+  }
+
+  /**
+   * \brief Clears all samples
+   */
+  inline void SickHistogram::Reset( ) {
+
+    _num_samples = _total_usecs = _max_usecs = 0;
+
+    for (unsigned int i = 0; i < SICK_STATS_NUM_HISTOGRAM_BINS; i++) {
+      _bins[i] = 0;
+    }
+
+  }
+
+  /**
+   * \brief Records the counter of the next scan
+   * \param counter The device's counter for the scan
+   * \param counter_modulus The value at which the device's counter wraps (e.g. 256 for an 8-bit counter)
+   * \return The number of scans lost just before this one
+   */
+  inline unsigned int SickSequenceTracker::Record( const unsigned int counter, const unsigned int counter_modulus ) {
+
+    const unsigned int curr_counter = counter % counter_modulus;
+    unsigned int num_lost = 0;
+
+    __sync_fetch_and_add(&_num_scans,1);
+
+    /* The first scan has nothing to be compared against */
+    if (!_sequence_started) {
+      _sequence_started = true;
+      _last_counter = curr_counter;
+      _num_lost_before_last = 0;
+      return 0;
+    }
+
+    /* How far has the counter moved (modulo its range)? */
+    const unsigned int counter_delta = (unsigned int)(((unsigned long)curr_counter + counter_modulus - _last_counter) % counter_modulus);
+
+    if (counter_delta == 0) {
+      __sync_fetch_and_add(&_num_duplicates,1);
+    }
+    else if (counter_delta > counter_modulus/2) {
+      __sync_fetch_and_add(&_num_reordered,1);
+    }
+    else {
+
+      /* Moved ahead, so anything in between went missing */
+      num_lost = counter_delta - 1;
+      if (num_lost > 0) {
+	__sync_fetch_and_add(&_num_gaps,1);
+	__sync_fetch_and_add(&_num_lost,num_lost);
+      }
+
+      _last_counter = curr_counter;
+
+    }
+
+    _num_lost_before_last = num_lost;
+    return num_lost;
+
+  }
+
+  /**
+   * \brief Copies the totals into a stats snapshot
+   * \param &sick_stats The destination
+   */
+  inline void SickSequenceTracker::GetSnapshot( sick_stats_t &sick_stats ) const {
+
+    sick_stats.num_scans_sequenced = _num_scans;
+    sick_stats.num_scans_lost = _num_lost;
+    sick_stats.num_scan_gaps = _num_gaps;
+    sick_stats.num_scans_duplicated = _num_duplicates;
+    sick_stats.num_scans_reordered = _num_reordered;
+
+  }
+
+  /**
+   * \brief Zeroes the totals and forgets the last counter
+   */
+  inline void SickSequenceTracker::Reset( ) {
+
+    _sequence_started = false;
+    _last_counter = _num_lost_before_last = 0;
+    _num_scans = _num_lost = _num_gaps = _num_duplicates = _num_reordered = 0;
+
+  }
+
+  /**
+   * \brief Records a message handed to its consumer
+   * \param &arrival_time When the message arrived (CLOCK_REALTIME, zero if unknown)
+   */
+  inline void SickStats::RecordConsumed( const struct timespec &arrival_time ) {
+
+    __sync_fetch_and_add(&_num_frames_consumed,1);
+
+    /* No timestamp, no latency */
+    if (arrival_time.tv_sec != 0 || arrival_time.tv_nsec != 0) {
+      struct timespec curr_time;
+      clock_gettime(CLOCK_REALTIME,&curr_time);
+      _consumer_latency.Record(ElapsedUsecs(arrival_time,curr_time));
+    }
+
+  }
+
+  /**
+   * \brief Copies out the current counters
+   * \param &sick_stats The destination
+   */
+  inline void SickStats::GetSnapshot( sick_stats_t &sick_stats ) const {
+
+    sick_stats.num_bytes_read = _num_bytes_read;
+    sick_stats.num_reads = _num_reads;
+    sick_stats.num_frames = _num_frames;
+    sick_stats.num_checksum_failures = _num_checksum_failures;
+    sick_stats.num_frames_dropped = 0;
+    sick_stats.num_frames_consumed = _num_frames_consumed;
+    sick_stats.num_frames_skipped = _num_frames_skipped;
+
+    _framing_time.GetSnapshot(sick_stats.framing_time);
+    _decode_time.GetSnapshot(sick_stats.decode_time);
+    _consumer_latency.GetSnapshot(sick_stats.consumer_latency);
+    _scan_sequence.GetSnapshot(sick_stats);
+
+  }
+
+  /**
+   * \brief Zeroes all counters and histograms
+   */
+  inline void SickStats::Reset( ) {
+
+    _num_bytes_read = _num_reads = _num_frames = _num_checksum_failures = _num_frames_consumed = _num_frames_skipped = 0;
+
+    _framing_time.Reset();
+    _decode_time.Reset();
+    _consumer_latency.Reset();
+    _scan_sequence.Reset();
+
+  }
+
+  /**
+   * \brief Computes the elapsed time between two clock readings
+   * \param &beg_time The earlier reading
+   * \param &end_time The later reading
+   * \return The elapsed time (usecs), or zero if end_time precedes beg_time
+   */
+  inline unsigned long SickStats::ElapsedUsecs( const struct timespec &beg_time, const struct timespec &end_time ) {
+
+    long elapsed_usecs = (end_time.tv_sec - beg_time.tv_sec)*1000000L + (end_time.tv_nsec - beg_time.tv_nsec)/1000L;
+    return (elapsed_usecs > 0) ? (unsigned long)elapsed_usecs : 0;
+
+  }
+
+} /* namespace SickToolbox */
+
+#endif /* SICK_STATS */
@@ -0,0 +1,299 @@
+/*!
+ * \file SickSubscriberList.hh
+ * \brief Defines a list of callbacks subscribed to the scans
+ *        decoded by a driver.
+ *
+ * Code by Jason C. Derenick and Thomas H. Miller.
+ * Contact derenick(at)lehigh(dot)edu
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * Copyright (c) 2008, Jason C. Derenick and Thomas H. Miller
+ * All rights reserved.
+ *
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_SUBSCRIBER_LIST
+#define SICK_SUBSCRIBER_LIST
+
+/* Dependencies */
+#include <vector>
+#include <iostream>
+#include <pthread.h>
+#include "SickException.hh"
+
+/* Associate the namespace */
+namespace SickToolbox {
+
+  /**
+   * \class SickSubscriberList
+   * \brief Fans a decoded scan out to any number of subscribed callbacks
+   *
+   * Callbacks are run (in the order they subscribed) on the thread that
+   * decoded the scan, w/o holding the list's mutex or the data stream, so
+   * a callback may subscribe, unsubscribe or stop its driver. A callback
+   * must not block, though. Until it returns the driver frames nothing
+   * (and w/ a shared reactor, neither does any other driver on it).
+   */
+  template < class SICK_SCAN_CLASS >
+  class SickSubscriberList {
+
+  public:
+
+    /** The callback type */
+    typedef void (*callback_t)( const SICK_SCAN_CLASS &sick_scan, void * callback_args );
+
+    /** A standard constructor */
+    SickSubscriberList( ) throw( SickThreadException );
+
+    /** Adds a callback to the list (returns an id for unsubscribing) */
+    unsigned int Subscribe( const callback_t callback, void * const callback_args ) throw( SickThreadException, SickConfigException );
+
+    /** Removes a callback from the list (it will not be called once this returns, or once the calling callback returns) */
+    bool Unsubscribe( const unsigned int subscriber_id ) throw( SickThreadException );
+
+    /** Passes the scan to each subscribed callback */
+    void Dispatch( const SICK_SCAN_CLASS &sick_scan ) throw( SickThreadException );
+
+    /** Indicates whether there is anybody to dispatch to (a hint, as the list may be changing) */
+    bool HasSubscribers( ) const { return _num_subscribers > 0; }
+
+    /** A standard destructor */
+    ~SickSubscriberList( );
+
+  private:
+
+    /**
+     * \struct sick_subscriber_t
+     * \brief A single subscription
+     */
+    struct sick_subscriber_t {
+      unsigned int id;                                                    ///< Id returned to the subscriber
+      callback_t callback;                                                ///< The callback
+      void *callback_args;                                                ///< Passed through to the callback
+    };
+
+    /** The subscriptions */
+    std::vector< sick_subscriber_t > _subscribers;
+
+    /** Number of subscriptions (readable w/o the mutex) */
+    volatile unsigned int _num_subscribers;
+
+    /** The id to hand out next */
+    unsigned int _next_subscriber_id;
+
+    /** The subscriptions a dispatch is working through (kept to avoid allocating per scan) */
+    std::vector< sick_subscriber_t > _dispatch_subscribers;
+
+    /** Indicates whether a dispatch is under way */
+    bool _dispatching;
+
+    /** The thread running the dispatch */
+    pthread_t _dispatch_thread_id;
+
+    /** Guards the subscriptions and the dispatch state */
+    pthread_mutex_t _subscriber_mutex;
+
+    /** Signaled when a dispatch finishes */
+    pthread_cond_t _dispatch_cond;
+
+    /** Locks the subscriptions */
+    void _lock( ) throw( SickThreadException );
+
+    /** Unlocks the subscriptions */
+    void _unlock( ) throw( SickThreadException );
+
+    /** Prevent copying (the list owns its mutex) */
+    SickSubscriberList( const SickSubscriberList & );
+    SickSubscriberList & operator=( const SickSubscriberList & );
+
+  };
+
+  /**
+   * \brief A standard constructor
+   */
+  template < class SICK_SCAN_CLASS >
+  SickSubscriberList< SICK_SCAN_CLASS >::SickSubscriberList( ) throw( SickThreadException ) :
+    _num_subscribers(0), _next_subscriber_id(1), _dispatching(false), _dispatch_thread_id(pthread_self()) {
+
+    if (pthread_mutex_init(&_subscriber_mutex,NULL) != 0) {
+      throw SickThreadException("SickSubscriberList::SickSubscriberList: pthread_mutex_init() failed!");
+    }
+
+    if (pthread_cond_init(&_dispatch_cond,NULL) != 0) {
+      throw SickThreadException("SickSubscriberList::SickSubscriberList: pthread_cond_init() failed!");
+    }
+
+  }
+
+  /**
+   * \brief Adds a callback to the list
+   * \param callback The function to call w/ each decoded scan
+   * \param *callback_args Passed through to the callback
+   * \return A (nonzero) id identifying the subscription
+   */
+  template < class SICK_SCAN_CLASS >
+  unsigned int SickSubscriberList< SICK_SCAN_CLASS >::Subscribe( const callback_t callback, void * const callback_args )
+    throw( SickThreadException, SickConfigException ) {
+
+    /* Sanity check */
+    if (callback == NULL) {
+      throw SickConfigException("SickSubscriberList::Subscribe: Callback is NULL!");
+    }
+
+    sick_subscriber_t subscriber;
+    subscriber.callback = callback;
+    subscriber.callback_args = callback_args;
+
+    _lock();
+
+    subscriber.id = _next_subscriber_id++;
+    _subscribers.push_back(subscriber);
+    _num_subscribers = _subscribers.size();
+
+    _unlock();
+
+    return subscriber.id;
+
+  }
+
+  /**
+   * \brief Removes a callback from the list
+   * \param subscriber_id The id returned by Subscribe()
+   * \return True if the subscription was found, False otherwise
+   *
+   * NOTE: If a dispatch is under way on another thread, this waits for it
+   *       to finish. Called from a callback, it returns at once and the
+   *       callback removed is skipped for the rest of the dispatch.
+   */
+  template < class SICK_SCAN_CLASS >
+  bool SickSubscriberList< SICK_SCAN_CLASS >::Unsubscribe( const unsigned int subscriber_id ) throw( SickThreadException ) {
+
+    bool found_subscriber = false;
+
+    _lock();
+
+    for (typename std::vector< sick_subscriber_t >::iterator it = _subscribers.begin(); it != _subscribers.end(); it++) {
+      if (it->id == subscriber_id) {
+	_subscribers.erase(it);
+	found_subscriber = true;
+	break;
+      }
+    }
+    _num_subscribers = _subscribers.size();
+
+    if (_dispatching) {
+
+      /* From a callback, so just keep the dispatch from reaching it */
+      if (pthread_equal(pthread_self(),_dispatch_thread_id)) {
+	for (unsigned int i = 0; i < _dispatch_subscribers.size(); i++) {
+	  if (_dispatch_subscribers[i].id == subscriber_id) {
+	    _dispatch_subscribers[i].callback = NULL;
+	  }
+	}
+      }
+
+      /* Otherwise wait for the dispatch to finish */
+      else {
+	while (_dispatching) {
+	  pthread_cond_wait(&_dispatch_cond,&_subscriber_mutex);
+	}
+      }
+
+    }
+
+    _unlock();
+
+    return found_subscriber;
+
+  }
+
+  /**
+   * \brief Passes a decoded scan to each subscribed callback
+   * \param &sick_scan The scan
+   *
+   * NOTE: The callbacks run w/o the list's mutex, off of a copy of the
+   *       subscriptions taken as the dispatch begins.
+   */
+  template < class SICK_SCAN_CLASS >
+  void SickSubscriberList< SICK_SCAN_CLASS >::Dispatch( const SICK_SCAN_CLASS &sick_scan ) throw( SickThreadException ) {
+
+    _lock();
+
+    /* One dispatch at a time (they share the copy) */
+    while (_dispatching) {
+      pthread_cond_wait(&_dispatch_cond,&_subscriber_mutex);
+    }
+
+    _dispatch_subscribers = _subscribers;
+    _dispatching = true;
+    _dispatch_thread_id = pthread_self();
+
+    _unlock();
+
+    /* Entries are only cleared (by a callback unsubscribing) on this thread */
+    for (unsigned int i = 0; i < _dispatch_subscribers.size(); i++) {
+
+      if (_dispatch_subscribers[i].callback == NULL) {
+	continue;
+      }
+
+      /* One misbehaving subscriber shouldn't starve the rest */
+      try {
+	_dispatch_subscribers[i].callback(sick_scan,_dispatch_subscribers[i].callback_args);
+      }
+
+      catch(...) {
+	std::cerr << "SickSubscriberList::Dispatch: Callback threw an exception!" << std::endl;
+      }
+
+    }
+
+    _lock();
+
+    _dispatching = false;
+    pthread_cond_broadcast(&_dispatch_cond);
+
+    _unlock();
+
+  }
+
+  /**
+   * \brief A standard destructor
+   */
+  template < class SICK_SCAN_CLASS >
+  SickSubscriberList< SICK_SCAN_CLASS >::~SickSubscriberList( ) {
+
+    pthread_cond_destroy(&_dispatch_cond);
+    pthread_mutex_destroy(&_subscriber_mutex);
+
+  }
+
+  /**
+   * \brief Locks the subscriptions
+   */
+  template < class SICK_SCAN_CLASS >
+  void SickSubscriberList< SICK_SCAN_CLASS >::_lock( ) throw( SickThreadException ) {
+
+    if (pthread_mutex_lock(&_subscriber_mutex) != 0) {
+      throw SickThreadException("SickSubscriberList::_lock: pthread_mutex_lock() failed!");
+    }
+
+  }
+
+  /**
+   * \brief Unlocks the subscriptions
+   */
+  template < class SICK_SCAN_CLASS >
+  void SickSubscriberList< SICK_SCAN_CLASS >::_unlock( ) throw( SickThreadException ) {
+
+    if (pthread_mutex_unlock(&_subscriber_mutex) != 0) {
+      throw SickThreadException("SickSubscriberList::_unlock: pthread_mutex_unlock() failed!");
+    }
+
+  }
+
+} /* namespace SickToolbox */
+
+#endif /* SICK_SUBSCRIBER_LIST */
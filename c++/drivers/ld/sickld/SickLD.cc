@@ -25,9 +25,10 @@
 #include <sys/socket.h>       // for socket function definitions
 #include <arpa/inet.h>        // for sockaddr_in, inet_addr, and htons
 #include <sys/ioctl.h>        // for using ioctl functionality for the socket input buffer
-#include <unistd.h>           // for select functionality (e.g. FD_SET, etc...)
+#include <unistd.h>           // for close, usleep, etc...
+#include <poll.h>             // for poll functionality
 #include <sys/types.h>        // for fd data types
-#include <sys/time.h>         // for select timeout parameter
+#include <sys/time.h>         // for gettimeofday
 #include <fcntl.h>            // for getting file flags
 #include <pthread.h>          // for POSIX threads
 #include <sstream>            // for parsing ip addresses
@@ -55,7 +56,8 @@ namespace SickToolbox {
     _sick_sensor_mode(SICK_SENSOR_MODE_UNKNOWN),
     _sick_motor_mode(SICK_MOTOR_MODE_UNKNOWN),
     _sick_streaming_range_data(false),
-    _sick_streaming_range_and_echo_data(false)
+    _sick_streaming_range_and_echo_data(false),
+    _sick_scan_profile(NULL)
   {
     /* Initialize the sick identity */
     _sick_identity.sick_part_number =
@@ -78,12 +80,25 @@ namespace SickToolbox {
 
     /* Initialize the sector configuration structure */
     memset(&_sick_sector_config,0,sizeof(sick_ld_config_sector_t));
+
+    /* A profile is big, so keep the subscribers' copy off the stack */
+    _sick_scan_profile = new sick_ld_scan_profile_t;
+    memset(_sick_scan_profile,0,sizeof(sick_ld_scan_profile_t));
+
+    /* Offer streamed profiles to the subscribers before they are queued */
+    _sick_buffer_monitor->SetMessageHandler(SickLD::_scanMessageHandler,this);
   }
 
   /**
    * A standard destructor
    */
-  SickLD::~SickLD( ) { }
+  SickLD::~SickLD( ) {
+
+    if (_sick_scan_profile) {
+      delete _sick_scan_profile;
+    }
+
+  }
 
   /**
    * \brief Initializes the driver and syncs it with Sick LD unit. Uses sector config given in flash.
@@ -733,6 +748,8 @@ namespace SickToolbox {
    *                                 the ith active sector.
    * \param *sector_stop_timestamps  An array where the ith element denotes the time at which the last scan was taken for
    *                                 the ith active sector.
+   * \param *arrival_time            Set to the host time (CLOCK_REALTIME) at which the first byte of the profile arrived.
+   *                                 (Default: NULL)
    *
    * ALERT: The user is responsible for ensuring that enough space is allocated for the return buffers to avoid overflow.
    *        See the example code for an easy way to do this.
@@ -746,7 +763,8 @@ namespace SickToolbox {
 				    double * const sector_start_angles,
 				    double * const sector_stop_angles,
 				    unsigned int * const sector_start_timestamps,
-				    unsigned int * const sector_stop_timestamps )
+				    unsigned int * const sector_stop_timestamps,
+				    struct timespec * const arrival_time )
     throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException ){
 
     /* Ensure the device has been initialized */
@@ -901,11 +919,8 @@ namespace SickToolbox {
       throw;
     }
     
-    /* A single buffer for payload contents */
-    uint8_t payload_buffer[SickLDMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-
-    /* Get the message payload */
-    recv_message.GetPayload(payload_buffer);
+    /* Parse the payload in place (no need to copy it out) */
+    const uint8_t * const payload_buffer = recv_message.GetPayloadPtr();
 
     /* Define the destination Sick LD scan profile struct */
     sick_ld_scan_profile_t profile_data;
@@ -923,6 +938,11 @@ namespace SickToolbox {
       throw SickConfigException("SickLD::GetSickMeasurements: Unexpected motor mode! (Are you using a valid motor speed!)");
     }
 
+    /* Set the arrival time if requested */
+    if (arrival_time != NULL) {
+      *arrival_time = recv_message.GetArrivalTime();
+    }
+
     /* Everything is OK, so now populate the relevant return buffers */
     for (unsigned int i = 0, total_measurements = 0; i < _sick_sector_config.sick_num_active_sectors; i++) {
 
@@ -984,6 +1004,98 @@ namespace SickToolbox {
   
   }
 
+  /**
+   * \brief Registers a callback to receive each scan profile as soon as it is decoded
+   * \param scan_callback The function to call w/ each profile
+   * \param *callback_args Passed through to the callback
+   * \return An id for unregistering the callback
+   *
+   * NOTE: If the device isn't already streaming, a RANGE+ECHO stream is
+   *       requested. Profiles are delivered as sent by the device (i.e.
+   *       sector_data holds one entry per sector in the profile).
+   *
+   * NOTE: Callbacks run on the buffer monitor's thread (or the reactor's),
+   *       so they must not block. They may unregister callbacks (their own
+   *       included), but must not otherwise call back into the driver. While any callback is registered, streamed profiles are
+   *       handed to the callbacks rather than queued, so GetSickMeasurements
+   *       should not be used at the same time.
+   */
+  unsigned int SickLD::RegisterSickScanCallback( const sick_ld_scan_callback_t scan_callback, void * const callback_args )
+    throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException, SickThreadException ) {
+
+    /* Ensure the device has been initialized */
+    if (!_sick_initialized) {
+      throw SickIOException("SickLD::RegisterSickScanCallback: Device NOT Initialized!!!");
+    }
+
+    unsigned int callback_id = 0;
+
+    try {
+
+      callback_id = _sick_scan_subscribers.Subscribe(scan_callback,callback_args);
+
+      /* Profiles only arrive once the device is streaming (w/o it, the caller never gets the id, so drop the callback) */
+      try {
+	if (!_sick_streaming_range_data && !_sick_streaming_range_and_echo_data) {
+	  _getSickScanProfiles(SICK_SCAN_PROFILE_RANGE_AND_ECHO);
+	}
+      }
+      catch (...) {
+	_sick_scan_subscribers.Unsubscribe(callback_id);
+	throw;
+      }
+
+    }
+
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle I/O exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle a returned error code */
+    catch (SickErrorException &sick_error_exception) {
+      std::cerr << sick_error_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle thread exceptions */
+    catch (SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* A safety net */
+    catch (...) {
+      std::cerr << "SickLD::RegisterSickScanCallback: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+    return callback_id;
+
+  }
+
+  /**
+   * \brief Unregisters a scan callback
+   * \param callback_id The id returned by RegisterSickScanCallback
+   *
+   * NOTE: The callback will not be called once this returns. The device
+   *       keeps streaming (GetSickMeasurements may be used again).
+   */
+  void SickLD::UnregisterSickScanCallback( const unsigned int callback_id ) throw( SickThreadException ) {
+
+    if (!_sick_scan_subscribers.Unsubscribe(callback_id)) {
+      std::cerr << "SickLD::UnregisterSickScanCallback: Unknown callback id!" << std::endl;
+    }
+
+  }
+
   /**
    * \brief Attempts to set a new sensor ID for the device (in flash)
    * \param sick_sensor_id The desired sensor ID
@@ -1758,30 +1870,21 @@ namespace SickToolbox {
 	  throw SickIOException("SickLD::_setupConnection: connect() failed!");
 	}
 
-	/* Use select to wait on the socket */
+	/* Use poll to wait on the socket (unlike select, it copes w/ any fd number) */
 	int valid_opt = 0;
 	int num_active_files = 0;
-	struct timeval timeout_val;                          // This structure will be used for setting our timeout values
-	fd_set file_desc_set;                                // File descriptor set for monitoring I/O
-    
-	/* Initialize and set the file descriptor set for select */
-	FD_ZERO(&file_desc_set);
-	FD_SET(_sick_fd,&file_desc_set);
+	struct pollfd poll_fd;                               // The socket we are waiting to become writable
+	poll_fd.fd = _sick_fd;
+	poll_fd.events = POLLOUT;
+	poll_fd.revents = 0;
 
-	/* Setup the timeout structure */
-	memset(&timeout_val,0,sizeof(timeout_val));          // Initialize the buffer
-	timeout_val.tv_usec = DEFAULT_SICK_CONNECT_TIMEOUT;  // Wait for specified time before throwing a timeout
-      
 	/* Wait for the OS to tell us that the connection is established! */
-	num_active_files = select(getdtablesize(),0,&file_desc_set,0,&timeout_val);
+	do {
+	  num_active_files = poll(&poll_fd,1,DEFAULT_SICK_CONNECT_TIMEOUT/1000);
+	} while (num_active_files < 0 && errno == EINTR);
       
-	/* Figure out what to do based on the output of select */
+	/* Figure out what to do based on the output of poll */
 	if (num_active_files > 0) {
-	
-	  /* This is just a sanity check */
-	  if (!FD_ISSET(_sick_fd,&file_desc_set)) {
-  	    throw SickIOException("SickLD::_setupConnection: Unexpected file descriptor!");
-	  }	  
 
 	  /* Check for any errors on the socket - just to be sure */
 	  socklen_t len = sizeof(int);
@@ -1798,13 +1901,13 @@ namespace SickToolbox {
 	else if (num_active_files == 0) {
 	
 	  /* A timeout has occurred! */
-	  throw SickTimeoutException("SickLD::_setupConnection: select() timeout!");	
+	  throw SickTimeoutException("SickLD::_setupConnection: poll() timeout!");	
 
 	}
 	else {
 	
 	  /* An error has occurred! */
-	  throw SickIOException("SickLD::_setupConnection: select() failed!");	
+	  throw SickIOException("SickLD::_setupConnection: poll() failed!");	
 
 	}
 
@@ -2450,6 +2553,9 @@ namespace SickToolbox {
       std::cout << "\tRequesting " << num_profiles << " " << _sickProfileFormatToString(profile_format) << " profiles from Sick LD..." << std::endl;
     }
 
+    /* Follow the profile numbers afresh (before the first profile can arrive) */
+    _restartScanSequence();
+
     /* Request scan profiles from the Sick (empirically it can take the Sick up to a few seconds to respond) */
     try {
       _sendMessageAndGetReply(send_message,recv_message);
@@ -2512,12 +2618,60 @@ namespace SickToolbox {
     /* Success */
   }
 
+  /**
+   * \brief Decodes streamed scan profiles and hands them to the subscribers
+   * \param &sick_message A message framed by the buffer monitor
+   * \param *handler_args The driver instance
+   * \return True if the message was consumed, False if it should be queued
+   */
+  bool SickLD::_scanMessageHandler( SickLDMessage &sick_message, void * handler_args ) {
+
+    SickLD *sick_ld = (SickLD *)handler_args;
+
+    /* Leave everything to the pull API unless somebody is listening */
+    if (!sick_ld->_sick_scan_subscribers.HasSubscribers()) {
+      return false;
+    }
+
+    /* Streamed profiles share the GET_PROFILE reply code, but the reply only echoes the format */
+    if (sick_message.GetServiceCode() != (SICK_MEAS_SERV_CODE | 0x80) ||
+	sick_message.GetServiceSubcode() != SICK_MEAS_SERV_GET_PROFILE ||
+	sick_message.GetPayloadLength() <= 4) {
+      return false;
+    }
+
+    try {
+
+      sick_ld->_parseScanProfile(&sick_message.GetPayloadPtr()[2],*sick_ld->_sick_scan_profile);
+      sick_ld->_sick_scan_profile->arrival_time = sick_message.GetArrivalTime();
+      sick_ld->_sick_scan_subscribers.Dispatch(*sick_ld->_sick_scan_profile);
+
+    }
+
+    /* Handle thread exceptions */
+    catch (SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+    }
+
+    /* A safety net */
+    catch (...) {
+      std::cerr << "SickLD::_scanMessageHandler: Unknown exception!!!" << std::endl;
+    }
+
+    return true;
+
+  }
+
   /**
    * \brief Parses a well-formed sequence of bytes into a corresponding scan profile
    * \param *src_buffer The source data buffer
    * \param &profile_data The destination data structure
    */
-  void SickLD::_parseScanProfile( uint8_t * const src_buffer, sick_ld_scan_profile_t &profile_data ) const {
+  void SickLD::_parseScanProfile( const uint8_t * const src_buffer, sick_ld_scan_profile_t &profile_data ) const {
+
+    /* Time the decode */
+    struct timespec decode_beg_time;
+    clock_gettime(CLOCK_MONOTONIC,&decode_beg_time);
 
     uint16_t profile_format = 0;
     unsigned int data_offset = 0;
@@ -2540,8 +2694,12 @@ namespace SickToolbox {
     if (profile_format & 0x0001) {
       memcpy(&temp_buffer,&src_buffer[data_offset],2);
       profile_data.profile_number = sick_ld_to_host_byte_order(temp_buffer);
+      profile_data.num_profiles_lost = _recordScanCounter(profile_data.profile_number,SICK_PROFILE_NUMBER_MODULUS);
       data_offset += 2;
     }
+    else {
+      profile_data.num_profiles_lost = 0;
+    }
   
     /* Check if PROFILECOUNT is included */
     if (profile_format & 0x0002) {
@@ -2678,6 +2836,8 @@ namespace SickToolbox {
       profile_data.sensor_status = SICK_SENSOR_MODE_UNKNOWN;
       profile_data.motor_status = SICK_MOTOR_MODE_UNKNOWN;
     }
+
+    _recordDecodeTime(decode_beg_time);
   
   }
 
@@ -4119,13 +4279,16 @@ namespace SickToolbox {
    */
   void SickLD::_flushTCPRecvBuffer( ) throw( SickIOException, SickThreadException ) {
 
-    uint8_t null_byte;
+    uint8_t null_buffer[SickLDBufferMonitor::RECV_BUFFER_SIZE];
     int num_bytes_waiting = 0;    
 
     try {
     
       /* Acquire access to the data stream */
       _sick_buffer_monitor->AcquireDataStream();
+
+      /* Drop anything the monitor has already buffered */
+      _sick_buffer_monitor->FlushRecvBuffer();
       
       /* Acquire the number of the bytes awaiting read */
       if (ioctl(_sick_fd,FIONREAD,&num_bytes_waiting)) {
@@ -4133,8 +4296,15 @@ namespace SickToolbox {
       }
       
       /* Read off the bytes awaiting in the buffer */
-      for (int i = 0; i < num_bytes_waiting; i++) {
-      	read(_sick_fd,&null_byte,1);
+      while (num_bytes_waiting > 0) {
+
+	int num_bytes_read = read(_sick_fd,null_buffer,(num_bytes_waiting > (int)sizeof(null_buffer)) ? sizeof(null_buffer) : num_bytes_waiting);
+	if (num_bytes_read <= 0) {
+	  break;
+	}
+
+	num_bytes_waiting -= num_bytes_read;
+	
       }
       
       /* Release the stream */
@@ -34,12 +34,14 @@
 /* Definition dependencies */
 #include <string>
 #include <vector>
+#include <time.h>
 #include <pthread.h>
 #include <arpa/inet.h>
 
 #include "SickLIDAR.hh"
 #include "SickLDBufferMonitor.hh"
 #include "SickLDMessage.hh"
+#include "SickSubscriberList.hh"
 #include "SickException.hh"
 
 /**
@@ -69,6 +71,7 @@ namespace SickToolbox {
     static const uint16_t SICK_MAX_MEAN_PULSE_FREQUENCY = 10800;                        ///< Max mean pulse frequence of the current device configuration (in Hz) (see page 22 of the operator's manual)
     static const uint16_t SICK_MAX_PULSE_FREQUENCY = 14400;                             ///< Max pulse frequency of the device (in Hz) (see page 22 of the operator's manual)
     static const uint16_t SICK_NUM_TICKS_PER_MOTOR_REV = 5760;                          ///< Odometer ticks per revolution of the Sick LD scan head
+    static const unsigned int SICK_PROFILE_NUMBER_MODULUS = 65536;                      ///< The profile number (PROFILESENT) wraps at 16 bits
     static const double SICK_MAX_SCAN_ANGULAR_RESOLUTION = 0.125;                       ///< Minimum valid separation between laser pulses in active scan ares (deg)
     static const double SICK_DEGREES_PER_MOTOR_STEP = 0.0625;                           ///< Each odometer tick is equivalent to rotating the scan head this many degrees
     
@@ -358,12 +361,17 @@ namespace SickToolbox {
     typedef struct sick_ld_scan_profile_tag {
       unsigned int profile_number;                                                        ///< The number of profiles sent to the host (i.e. the current profile number)
       unsigned int profile_counter;                                                       ///< The number of profiles gathered by the Sick LD
+      unsigned int num_profiles_lost;                                                     ///< Profiles missed (by profile number) just before this one (0 w/o PROFILESENT)
       unsigned int layer_num;                                                             ///< The layer number associated with a scan (this will always be 0)
       unsigned int sensor_status;                                                         ///< The status of the Sick LD sensor
       unsigned int motor_status;                                                          ///< The status of the Sick LD motor
       unsigned int num_sectors;                                                           ///< The number of sectors returned in the profile
       sick_ld_sector_data_t sector_data[SICK_MAX_NUM_SECTORS];                            ///< The sectors associated with the scan profile 
+      struct timespec arrival_time;                                                       ///< When the first byte of the profile arrived at the host (CLOCK_REALTIME)
     } sick_ld_scan_profile_t;
+
+    /** Called w/ each scan profile decoded by the driver */
+    typedef SickSubscriberList< sick_ld_scan_profile_t >::callback_t sick_ld_scan_callback_t;
     
     /** Primary constructor */
     SickLD( const std::string sick_ip_address = DEFAULT_SICK_IP_ADDRESS,
@@ -416,9 +424,17 @@ namespace SickToolbox {
 			      double * const sector_start_angles = NULL,
 			      double * const sector_stop_angles = NULL,
 			      unsigned int * const sector_start_timestamps = NULL,
-			      unsigned int * const sector_stop_timestamps = NULL )
+			      unsigned int * const sector_stop_timestamps = NULL,
+			      struct timespec * const arrival_time = NULL )
       throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException );
 
+    /** Registers a callback to receive each scan profile as soon as it is decoded (starts the data stream) */
+    unsigned int RegisterSickScanCallback( const sick_ld_scan_callback_t scan_callback, void * const callback_args = NULL )
+      throw( SickErrorException, SickIOException, SickTimeoutException, SickConfigException, SickThreadException );
+
+    /** Unregisters a scan callback */
+    void UnregisterSickScanCallback( const unsigned int callback_id ) throw( SickThreadException );
+
     /** Attempts to set a new senor ID for the device (in flash) */
     void SetSickSensorID( const unsigned int sick_sensor_id )
       throw( SickErrorException, SickTimeoutException, SickIOException );
@@ -567,6 +583,12 @@ namespace SickToolbox {
 
     /** Indicates whether the Sick LD is currently streaming range and echo data */
     bool _sick_streaming_range_and_echo_data;
+
+    /** Callbacks subscribed to the scan stream */
+    SickSubscriberList< sick_ld_scan_profile_t > _sick_scan_subscribers;
+
+    /** Profile decoded for the subscribers (only touched by the monitor) */
+    sick_ld_scan_profile_t *_sick_scan_profile;
   
     /** The identity structure for the Sick */
     sick_ld_identity_t _sick_identity;
@@ -613,7 +635,10 @@ namespace SickToolbox {
       throw( SickErrorException, SickTimeoutException, SickIOException, SickConfigException );
 
     /** Parses a sequence of bytes and populates the profile_data struct w/ the results */
-    void _parseScanProfile( uint8_t * const src_buffer, sick_ld_scan_profile_t &profile_data ) const;
+    void _parseScanProfile( const uint8_t * const src_buffer, sick_ld_scan_profile_t &profile_data ) const;
+
+    /** Hands streamed scan profiles to the subscribers (called by the buffer monitor) */
+    static bool _scanMessageHandler( SickLDMessage &sick_message, void * handler_args );
 
     /** Cancels the active data stream */
     void _cancelSickScanProfiles( ) throw( SickErrorException, SickTimeoutException, SickIOException );
@@ -56,7 +56,7 @@ namespace SickToolbox {
       for (unsigned int i = 0; i < sizeof(sick_response_header);) {
 	
 	/* Acquire the next byte from the stream */
-	_readBytes(&byte_buffer,1,DEFAULT_SICK_BYTE_TIMEOUT);
+	_readBytes(&byte_buffer,1,DEFAULT_SICK_FRAME_TIMEOUT);
 	
 	/* Check if the current byte matches the expected header byte */
 	if (byte_buffer == sick_response_header[i]) {
@@ -72,17 +72,23 @@ namespace SickToolbox {
       memcpy(message_buffer,sick_response_header,4);
 
       /* Acquire the payload length! */
-      _readBytes(&message_buffer[4],4,DEFAULT_SICK_BYTE_TIMEOUT);
+      _readBytes(&message_buffer[4],4,DEFAULT_SICK_FRAME_TIMEOUT);
       
       /* Extract the payload size and adjust the byte order */
       memcpy(&payload_length,&message_buffer[4],4);
       payload_length = sick_ld_to_host_byte_order(payload_length);
+
+      /* Guard against a corrupt length field */
+      if (payload_length > SickLDMessage::MESSAGE_PAYLOAD_MAX_LENGTH) {
+	std::cerr << "SickLDBufferMonitor::GetNextMessageFromDataStream: Bad payload length! (Discarding)" << std::endl;
+	return;
+      }
       
       /* Read the packet payload */
-      _readBytes(&message_buffer[8],payload_length,DEFAULT_SICK_BYTE_TIMEOUT);
+      _readBytes(&message_buffer[8],payload_length,DEFAULT_SICK_FRAME_TIMEOUT);
       
       /* Read the checksum */
-      _readBytes(&checksum,1,DEFAULT_SICK_BYTE_TIMEOUT);
+      _readBytes(&checksum,1,DEFAULT_SICK_FRAME_TIMEOUT);
       
       /* Build the return message object based upon the received payload
        * and compute the associated checksum.
@@ -110,6 +116,7 @@ namespace SickToolbox {
     /* Catch a bad checksum! */
     catch(SickBadChecksumException &sick_checksum_exception) {
       sick_message.Clear(); // Clear the message container
+      _recordChecksumFailure();
     }
     
     /* Catch any serious IO buffer exceptions */
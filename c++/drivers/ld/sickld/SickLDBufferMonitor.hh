@@ -17,7 +17,7 @@
 #ifndef SICK_LD_BUFFER_MONITOR_HH
 #define SICK_LD_BUFFER_MONITOR_HH
 
-#define DEFAULT_SICK_BYTE_TIMEOUT         (35000)  ///< Max allowable time between consecutive bytes
+#define DEFAULT_SICK_FRAME_TIMEOUT       (100000)  ///< Max allowable time for receiving a whole message (usecs)
 
 /* Definition dependencies */
 #include "SickLDMessage.hh"
@@ -24,10 +24,13 @@
 #include <iomanip>
 #include <sys/socket.h>       // for socket function definitions
 #include <arpa/inet.h>        // for sockaddr_in, inet_addr, and htons
+#include <netinet/in.h>       // for IPPROTO_TCP
+#include <netinet/tcp.h>      // for TCP_NODELAY
 #include <sys/ioctl.h>        // for using ioctl functionality for the socket input buffer
-#include <unistd.h>           // for select functionality (e.g. FD_SET, etc...)
+#include <unistd.h>           // for close, usleep, etc...
+#include <poll.h>             // for poll functionality
 #include <sys/types.h>        // for fd data types
-#include <sys/time.h>         // for select timeout parameter
+#include <sys/time.h>         // for gettimeofday
 #include <fcntl.h>            // for getting file flags
 #include <pthread.h>          // for POSIX threads
 #include <sstream>            // for parsing ip addresses
@@ -48,17 +51,33 @@ namespace SickToolbox {
    * \brief A standard constructor
    * \param sick_ip_address The ip address of the Sick LD
    * \param sick_tcp_port The TCP port associated w/ the Sick LD server
+   * \param sick_protocol The telegram encoding to speak (the device must be configured to match)
    */
-  SickLMS1xx::SickLMS1xx( const std::string sick_ip_address, const uint16_t sick_tcp_port ) :
+  SickLMS1xx::SickLMS1xx( const std::string sick_ip_address, const uint16_t sick_tcp_port,
+			  const sick_lms_1xx_protocol_t sick_protocol ) :
     SickLIDAR< SickLMS1xxBufferMonitor, SickLMS1xxMessage >( ),
     _sick_ip_address(sick_ip_address),
     _sick_tcp_port(sick_tcp_port),
-    _sick_scan_format(SICK_LMS_1XX_SCAN_FORMAT_UNKNOWN),
+    _sick_protocol(sick_protocol),
     _sick_device_status(SICK_LMS_1XX_STATUS_UNKNOWN),
     _sick_temp_safe(false),
-    _sick_streaming(false)
+    _sick_streaming(false),
+    _sick_metric_output(false)
   {
     memset(&_sick_scan_config,0,sizeof(sick_lms_1xx_scan_config_t));
+    memset(&_sick_scan_data,0,sizeof(sick_lms_1xx_scan_data_t));
+    memset(&_sick_beam_table,0,sizeof(sick_lms_1xx_beam_table_t));
+
+    /* Nothing is known about the scan data format until it is set */
+    memset(&_sick_scan_data_cfg,0,sizeof(sick_lms_1xx_scan_data_cfg_t));
+    _sick_scan_data_cfg.scan_format = SICK_LMS_1XX_SCAN_FORMAT_UNKNOWN;
+    _sick_scan_data_cfg.output_interval = 1;
+
+    /* Frame the stream w/ the same encoding we send in */
+    _sick_buffer_monitor->SetSickProtocol(_sick_protocol);
+
+    /* Offer streamed scans to the subscribers before they are queued */
+    _sick_buffer_monitor->SetMessageHandler(SickLMS1xx::_scanMessageHandler,this);
   }
 
   /**
@@ -99,8 +118,7 @@ namespace SickToolbox {
       if (disp_banner) {
 	std::cout << "\tSyncing driver with Sick..." << std::endl;
       }
-      _getSickScanConfig();
-      _setAuthorizedClientAccessMode();
+      _syncWithSick();
       if (disp_banner) {
 	std::cout << "\t\tSuccess!" << std::endl;
 	_printInitFooter();  	
@@ -265,9 +283,13 @@ namespace SickToolbox {
     }
 
     /* If scan data format matches current format ignore it (perhaps a warning is in order?) */
-    if (scan_format == _sick_scan_format) {
+    if (scan_format == _sick_scan_data_cfg.scan_format) {
       return;
     }
+
+    /* Leave the other options as they are */
+    sick_lms_1xx_scan_data_cfg_t scan_data_cfg = _sick_scan_data_cfg;
+    scan_data_cfg.scan_format = scan_format;
     
     try {
       
@@ -279,7 +301,7 @@ namespace SickToolbox {
       std::cout << "\t*** Setting scan format " << _sickScanDataFormatToString(scan_format) << "..." << std::endl;
       
       /* Set the desired data format! */
-      _setSickScanDataFormat(scan_format);
+      _setSickScanDataConfig(scan_data_cfg);
 
       std::cout << "\t\tSuccess!" << std::endl;
       
@@ -306,23 +328,224 @@ namespace SickToolbox {
     
   }
   
+  /**
+   * \brief Sets everything the Sick LMS 1xx includes in a scan telegram
+   * \param &scan_data_cfg The channels, optional blocks and output interval
+   *
+   * NOTE: Leaving out the optional blocks (and the channels that aren't
+   *       consumed) shrinks every telegram, saving bandwidth and parse time.
+   *       The device is reinitialized for the change to take effect.
+   */
+  void SickLMS1xx::SetSickScanDataConfig( const sick_lms_1xx_scan_data_cfg_t &scan_data_cfg )
+    throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException, SickConfigException ) {
+
+    /* Ensure the device has been initialized */
+    if (!_sick_initialized) {
+      throw SickIOException("SickLMS1xx::SetSickScanDataConfig: Device NOT Initialized!!!");
+    }
+
+    /* The interval is sent as a 16-bit value */
+    if (scan_data_cfg.output_interval < 1 || scan_data_cfg.output_interval > 0xFFFF) {
+      throw SickConfigException("SickLMS1xx::SetSickScanDataConfig: Invalid output interval!");
+    }
+
+    /* The format is the one setting that has to be chosen */
+    if (scan_data_cfg.scan_format == SICK_LMS_1XX_SCAN_FORMAT_UNKNOWN) {
+      throw SickConfigException("SickLMS1xx::SetSickScanDataConfig: Invalid scan format!");
+    }
+    
+    try {
+      
+      /* Is the device streaming? */
+      if (_sick_streaming ) {
+	_stopStreamingMeasurements();
+      }
+
+      std::cout << "\t*** Setting scan format " << _sickScanDataFormatToString(scan_data_cfg.scan_format) << " (every " << scan_data_cfg.output_interval << " scan(s))..." << std::endl;
+      
+      /* Set the desired data format! */
+      _setSickScanDataConfig(scan_data_cfg);
+
+      std::cout << "\t\tSuccess!" << std::endl;
+      
+    }
+    
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle write buffer exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+    
+    catch (...) {
+      std::cerr << "SickLMS1xx::SetSickScanDataConfig: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+    /* Success! */
+    
+  }
+
+  /**
+   * \brief Restricts the measurements sent in each scan to an angular range
+   * \param start_angle The angle of the first measurement to send (deg)
+   * \param stop_angle The angle of the last measurement to send (deg)
+   *
+   * NOTE: The device keeps scanning its whole field of view, it just
+   *       doesn't transmit what falls outside the range. The range must
+   *       lie within the scan area (see GetSickStartAngle/GetSickStopAngle).
+   */
+  void SickLMS1xx::SetSickOutputRange( const double start_angle, const double stop_angle )
+    throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException, SickConfigException ) {
+
+    /* Ensure the device has been initialized */
+    if (!_sick_initialized) {
+      throw SickIOException("SickLMS1xx::SetSickOutputRange: Device NOT Initialized!!!");
+    }
+
+    const int sick_start_angle = _convertDegsToSickAngleUnits(start_angle);
+    const int sick_stop_angle = _convertDegsToSickAngleUnits(stop_angle);
+
+    /* Verify valid inputs */
+    if (!_validScanArea(sick_start_angle,sick_stop_angle) ||
+	sick_start_angle < _sick_scan_config.sick_start_angle || sick_stop_angle > _sick_scan_config.sick_stop_angle) {
+      throw SickConfigException("SickLMS1xx::SetSickOutputRange: Invalid output range!");
+    }
+    
+    try {
+      
+      /* Is the device streaming? */
+      if (_sick_streaming ) {
+	_stopStreamingMeasurements();
+      }
+
+      std::cout << "\t*** Setting output range [" << start_angle << "," << stop_angle << "] (deg)..." << std::endl;
+      
+      /* Set the desired range! */
+      _setSickOutputRange(sick_start_angle,sick_stop_angle);
+
+      std::cout << "\t\tSuccess!" << std::endl;
+      
+    }
+    
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle write buffer exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+    
+    catch (...) {
+      std::cerr << "SickLMS1xx::SetSickOutputRange: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+    /* Success! */
+    
+  }
+  
   /**
    * \brief Acquire multi-pulse sick range measurements
    * \param range_1_vals A buffer to hold the range measurements
    * \param range_2_vals A buffer to hold the second pulse range measurements
    * \param refelct_1_vals A buffer to hold the frist pulse reflectivity
    * \param reflect_2_vals A buffer to hold the second pulse reflectivity
+   * \param &num_measurements Set to the number of measurements in the scan
+   * \param dev_status Set to the device status (optional)
+   * \param arrival_time Set to when the first byte of the scan arrived (optional)
+   * \param scan_telegram Set to the counters, timestamps and encoder data carried w/ the scan (optional)
    */
   void SickLMS1xx::GetSickMeasurements( unsigned int * const range_1_vals,
 					unsigned int * const range_2_vals,
 					unsigned int * const reflect_1_vals,
 					unsigned int * const reflect_2_vals,
 					unsigned int & num_measurements,
-					unsigned int * const dev_status ) throw ( SickIOException, SickConfigException, SickTimeoutException ) {
+					unsigned int * const dev_status,
+					struct timespec * const arrival_time,
+					sick_lms_1xx_scan_telegram_t * const scan_telegram ) throw ( SickIOException, SickConfigException, SickTimeoutException ) {
+
+    /* Allocate receive message */
+    SickLMS1xxMessage recv_message;
+
+    /* Grab the next scan from the stream */
+    _recvScanMessage(recv_message);
+    
+    /* Decode the scan */
+    _parseSickScanMessage(recv_message,range_1_vals,range_2_vals,reflect_1_vals,reflect_2_vals,num_measurements,dev_status,scan_telegram);
+
+    /* When did it get here? */
+    if (arrival_time != NULL) {
+      *arrival_time = recv_message.GetArrivalTime();
+    }
+    
+    /* Success! */
+    
+  }
+
+  /**
+   * \brief Acquire the next scan in its entirety
+   * \param &sick_scan Set to the decoded scan
+   *
+   * NOTE: Unlike GetSickMeasurements, this doesn't complain about
+   *       channels that aren't being streamed (they are just zeroed).
+   *       The telegram and scan counters in sick_scan.scan_telegram
+   *       reveal dropped scans, and time_of_transmission (sensor clock)
+   *       vs. arrival_time (host clock) gives the transport latency.
+   */
+  void SickLMS1xx::GetSickScan( sick_lms_1xx_scan_data_t &sick_scan ) throw ( SickIOException, SickConfigException, SickTimeoutException ) {
+
+    /* Allocate receive message */
+    SickLMS1xxMessage recv_message;
+
+    /* Grab the next scan from the stream */
+    _recvScanMessage(recv_message);
+
+    /* Decode the scan */
+    _parseSickScanMessage(recv_message,sick_scan);
+
+    /* Success! */
+    
+  }
+
+  /**
+   * \brief Gets the angle, cosine and sine of every beam in the current scan area
+   * \param &beam_table Set to the beam table
+   *
+   * NOTE: The table is only rebuilt when the scan area changes, so it can
+   *       be fetched once after configuring the device. A scan's
+   *       measurements begin at beam_index in the table (the output range
+   *       may leave out beams at either end).
+   */
+  void SickLMS1xx::GetSickBeamTable( sick_lms_1xx_beam_table_t &beam_table ) const throw ( SickIOException ) {
+
+    /* Ensure the device has been initialized */
+    if (!_sick_initialized) {
+      throw SickIOException("SickLMS1xx::GetSickBeamTable: Device NOT Initialized!!!");
+    }
+
+    beam_table = _sick_beam_table;
+
+  }
+
+  /**
+   * \brief Waits for the next streamed scan message
+   * \param &recv_message Set to the scan message
+   */
+  void SickLMS1xx::_recvScanMessage( SickLMS1xxMessage &recv_message ) throw ( SickIOException, SickConfigException, SickTimeoutException ) {
     
     /* Ensure the device has been initialized */
     if (!_sick_initialized) {
-      throw SickIOException("SickLMS1xx::GetSickMeasurements: Device NOT Initialized!!!");
+      throw SickIOException("SickLMS1xx::_recvScanMessage: Device NOT Initialized!!!");
     }
     
     try {
@@ -353,17 +576,16 @@ namespace SickToolbox {
     }
     
     catch (...) {
-      std::cerr << "SickLMS1xx::GetSickMeasurements: Unknown exception!!!" << std::endl;
+      std::cerr << "SickLMS1xx::_recvScanMessage: Unknown exception!!!" << std::endl;
       throw;
     }
 
-    /* Allocate receive message */
-    SickLMS1xxMessage recv_message;
-    
     try {
       
-      /* Grab the next message from the stream */
-      _recvMessage(recv_message);
+      /* Grab the next scan from the stream (skipping anything else left on the data channel) */
+      do {
+	_recvMessage(recv_message);
+      } while (recv_message.GetCommandType() != "sSN" || recv_message.GetCommand() != "LMDscandata");
 
     }
 
@@ -374,164 +596,551 @@ namespace SickToolbox {
     }
     
     catch (...) {
-      std::cerr << "SickLMS1xx::GetSickMeasurements: Unknown exception!!!" << std::endl;
+      std::cerr << "SickLMS1xx::_recvScanMessage: Unknown exception!!!" << std::endl;
       throw;
     }
     
-    /* Allocate a single buffer for payload contents */
-    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH+1] = {0};
-    
-    recv_message.GetPayloadAsCStr((char *)payload_buffer);
+  }
+  
+  /**
+   * \brief Decodes a streamed LMDscandata message
+   * \param &recv_message The scan message
+   * \param range_1_vals A buffer to hold the range measurements
+   * \param range_2_vals A buffer to hold the second pulse range measurements
+   * \param reflect_1_vals A buffer to hold the first pulse reflectivity
+   * \param reflect_2_vals A buffer to hold the second pulse reflectivity
+   * \param &num_measurements Set to the number of measurements in the scan
+   * \param dev_status Set to the device status
+   * \param scan_telegram Set to everything but the values (counters, timestamps, etc.)
+   * \param warn_if_missing Complain when a requested section isn't being streamed
+   *
+   * NOTE: Buffers that are NULL are skipped. Each non-NULL buffer must
+   *       hold SICK_LMS_1XX_MAX_NUM_MEASUREMENTS values.
+   */
+  void SickLMS1xx::_parseSickScanMessage( const SickLMS1xxMessage &recv_message,
+					  unsigned int * const range_1_vals,
+					  unsigned int * const range_2_vals,
+					  unsigned int * const reflect_1_vals,
+					  unsigned int * const reflect_2_vals,
+					  unsigned int & num_measurements,
+					  unsigned int * const dev_status,
+					  sick_lms_1xx_scan_telegram_t * const scan_telegram,
+					  const bool warn_if_missing ) const throw ( SickIOException ) {
+
+    /* Time the decode */
+    struct timespec decode_beg_time;
+    clock_gettime(CLOCK_MONOTONIC,&decode_beg_time);
+
+    /* Where each channel's values go (indexed by sick_lms_1xx_channel_id_t) */
+    unsigned int * const channel_vals[SICK_LMS_1XX_NUM_CHANNELS] = {range_1_vals,range_2_vals,reflect_1_vals,reflect_2_vals};
+
+    /* Walk the telegram once (decoding straight into the caller's struct if there is one) */
+    sick_lms_1xx_scan_telegram_t local_scan_telegram;
+    sick_lms_1xx_scan_telegram_t &decoded_telegram = (scan_telegram != NULL) ? *scan_telegram : local_scan_telegram;
+    if (recv_message.GetProtocol() == SICK_LMS_1XX_PROTOCOL_COLA_B) {
+      _decodeColaBScanTelegram(recv_message,channel_vals,decoded_telegram);
+    }
+    else {
+      _decodeColaAScanTelegram(recv_message,channel_vals,decoded_telegram);
+    }
 
-    char * payload_str = NULL;
-    unsigned int null_int = 0;
+    /* Were any scans missed? */
+    decoded_telegram.num_scans_lost = _recordScanCounter(decoded_telegram.telegram_counter,SICK_LMS_1XX_TELEGRAM_COUNTER_MODULUS);
 
-    /*
-     * Acquire status
-     */
-    if (dev_status != NULL) {
+    /* Did we get everything that was asked for? */
+    if (range_1_vals != NULL && !decoded_telegram.channels[SICK_LMS_1XX_CHANNEL_DIST_1].present) {
+      throw SickIOException("SickLMS1xx::_parseSickScanMessage: DIST1 not found!");
+    }
+
+    if (warn_if_missing) {
+
+      if (range_2_vals != NULL && !decoded_telegram.channels[SICK_LMS_1XX_CHANNEL_DIST_2].present) {
+	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting double-pulse range values, which are not being streamed! ";
+	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
+      }
+
+      if (reflect_1_vals != NULL && !decoded_telegram.channels[SICK_LMS_1XX_CHANNEL_RSSI_1].present) {
+	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting single-pulse reflectivity values, which are not being streamed! ";
+	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
+      }
 
-      payload_str = (char *)&payload_buffer[16];      
-      for (unsigned int i = 0; i < 3; i++) {
-	payload_str = _convertNextTokenToUInt(payload_str,null_int);
+      if (reflect_2_vals != NULL && !decoded_telegram.channels[SICK_LMS_1XX_CHANNEL_RSSI_2].present) {
+	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting double-pulse reflectivity values, which are not being streamed! ";
+	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
       }
 
-      /* Grab the contaimination value */
-      _convertNextTokenToUInt(payload_str,*dev_status);
+    }
 
+    /* Grab the device status */
+    if (dev_status != NULL) {
+      *dev_status = decoded_telegram.device_status[0];
     }
 
-    /*
-     * Process DIST1
-     */
-    unsigned int num_dist_1_vals = 0;
-    unsigned int num_dist_2_vals = 0;
-    unsigned int num_rssi_1_vals = 0;
-    unsigned int num_rssi_2_vals = 0;
-    
-    /* Locate DIST1 Section */
-    if (range_1_vals != NULL) {
-
-      const char * substr_dist_1 = "DIST1";
-      unsigned int substr_dist_1_pos = 0;
-      if (!_findSubString((char *)payload_buffer,substr_dist_1,recv_message.GetPayloadLength()+1,5,substr_dist_1_pos)) {
-	throw SickIOException("SickLMS1xx::GetSickMeasurements: _findSubString() failed!");
+    /* Assign number of measurements */
+    num_measurements = decoded_telegram.channels[SICK_LMS_1XX_CHANNEL_DIST_1].num_vals;
+
+    _recordDecodeTime(decode_beg_time);
+
+  }
+
+  /**
+   * \brief Decodes a streamed LMDscandata message into a scan data struct
+   * \param &recv_message The scan message
+   * \param &sick_scan Set to the decoded scan
+   *
+   * NOTE: Channels that aren't being streamed are zeroed (w/o complaint).
+   */
+  void SickLMS1xx::_parseSickScanMessage( const SickLMS1xxMessage &recv_message,
+					  sick_lms_1xx_scan_data_t &sick_scan ) const throw ( SickIOException ) {
+
+    _parseSickScanMessage(recv_message,
+			  sick_scan.range_1_vals,
+			  sick_scan.range_2_vals,
+			  sick_scan.reflect_1_vals,
+			  sick_scan.reflect_2_vals,
+			  sick_scan.num_measurements,
+			  &sick_scan.dev_status,
+			  &sick_scan.scan_telegram,
+			  false);
+
+    /* Only clear what the telegram didn't fill in */
+    unsigned int * const channel_vals[SICK_LMS_1XX_NUM_CHANNELS] = {sick_scan.range_1_vals,sick_scan.range_2_vals,sick_scan.reflect_1_vals,sick_scan.reflect_2_vals};
+    for (unsigned int i = 0; i < SICK_LMS_1XX_NUM_CHANNELS; i++) {
+      if (!sick_scan.scan_telegram.channels[i].present) {
+	memset(channel_vals[i],0,SICK_LMS_1XX_MAX_NUM_MEASUREMENTS*sizeof(unsigned int));
       }
-      
-      /* Extract Num DIST1 Values */
-      payload_str = (char *)&payload_buffer[substr_dist_1_pos+6];
-      for (unsigned int i = 0; i < 4; i++) {
-	payload_str = _convertNextTokenToUInt(payload_str,null_int);
+    }
+    
+    sick_scan.arrival_time = recv_message.GetArrivalTime();
+
+    /* Convert to meters if asked to */
+    if (_sick_metric_output) {
+      _convertSickScanToMetric(sick_scan);
+    }
+    else {
+      sick_scan.metric_valid = sick_scan.points_valid = false;
+    }
+    
+  }
+
+  /**
+   * \brief Fills in the metric fields of a decoded scan
+   * \param &sick_scan The decoded scan
+   *
+   * NOTE: Ranges are scaled by the factor and offset each telegram
+   *       carries. Points are only set when the scan's first angle and
+   *       angular step line up w/ the beam table, which is always the
+   *       case unless the scan config changed behind the driver's back.
+   */
+  void SickLMS1xx::_convertSickScanToMetric( sick_lms_1xx_scan_data_t &sick_scan ) const {
+
+    const unsigned int num_measurements = sick_scan.num_measurements;
+
+    /* Scale the range channels (mm) to meters */
+    const unsigned int range_channels[2] = {SICK_LMS_1XX_CHANNEL_DIST_1,SICK_LMS_1XX_CHANNEL_DIST_2};
+    const unsigned int * const range_vals[2] = {sick_scan.range_1_vals,sick_scan.range_2_vals};
+    float * const range_meters[2] = {sick_scan.range_1_meters,sick_scan.range_2_meters};
+    for (unsigned int j = 0; j < 2; j++) {
+
+      const sick_lms_1xx_channel_info_t &channel = sick_scan.scan_telegram.channels[range_channels[j]];
+      if (!channel.present) {
+	memset(range_meters[j],0,num_measurements*sizeof(float));
+	continue;
       }
-      
-      payload_str = _convertNextTokenToUInt(payload_str,num_dist_1_vals);
-      
-      /* Grab the DIST1 values */
-      for (unsigned int i = 0; i < num_dist_1_vals; i++) {
-	payload_str = _convertNextTokenToUInt(payload_str,range_1_vals[i]);
+
+      const float scale = channel.scale_factor/1000;
+      const float offset = channel.scale_offset/1000;
+      for (unsigned int i = 0; i < num_measurements; i++) {
+	range_meters[j][i] = range_vals[j][i]*scale + offset;
       }
 
     }
-      
+
+    sick_scan.metric_valid = true;
+
+    /* Find where the scan starts in the beam table */
+    const sick_lms_1xx_channel_info_t &dist_1 = sick_scan.scan_telegram.channels[SICK_LMS_1XX_CHANNEL_DIST_1];
+    const int angle_offset = dist_1.start_angle - _sick_beam_table.start_angle;
+    sick_scan.points_valid = (dist_1.angular_step == _sick_beam_table.angular_step && dist_1.angular_step > 0 &&
+			      angle_offset >= 0 && angle_offset % dist_1.angular_step == 0 &&
+			      angle_offset/dist_1.angular_step + num_measurements <= _sick_beam_table.num_beams);
+
+    if (!sick_scan.points_valid) {
+      sick_scan.beam_index = 0;
+      return;
+    }
+
+    /* Project the first pulse ranges w/ the cached cosines and sines */
+    sick_scan.beam_index = angle_offset/dist_1.angular_step;
+    const float * const cos_vals = &_sick_beam_table.cos_vals[sick_scan.beam_index];
+    const float * const sin_vals = &_sick_beam_table.sin_vals[sick_scan.beam_index];
+    for (unsigned int i = 0; i < num_measurements; i++) {
+      sick_scan.x_1_vals[i] = sick_scan.range_1_meters[i]*cos_vals[i];
+      sick_scan.y_1_vals[i] = sick_scan.range_1_meters[i]*sin_vals[i];
+    }
+
+  }
+
+  /**
+   * \brief Rebuilds the beam table if the scan area has changed
+   */
+  void SickLMS1xx::_updateSickBeamTable( ) {
+
+    const int32_t start_angle = _sick_scan_config.sick_start_angle;
+    const unsigned int angular_step = (unsigned int)_sick_scan_config.sick_scan_res;
+
+    /* Nothing to do if the scan area hasn't changed */
+    if (_sick_beam_table.start_angle == start_angle && _sick_beam_table.angular_step == angular_step && _sick_beam_table.num_beams > 0) {
+      return;
+    }
+
+    /* How many beams fit in the scan area? */
+    unsigned int num_beams = 0;
+    if (angular_step > 0 && _sick_scan_config.sick_stop_angle >= start_angle) {
+      num_beams = (_sick_scan_config.sick_stop_angle - start_angle)/angular_step + 1;
+      if (num_beams > (unsigned int)SICK_LMS_1XX_MAX_NUM_MEASUREMENTS) {
+	num_beams = SICK_LMS_1XX_MAX_NUM_MEASUREMENTS;
+      }
+    }
+
+    _sick_beam_table.start_angle = start_angle;
+    _sick_beam_table.angular_step = angular_step;
+    _sick_beam_table.num_beams = num_beams;
+
+    for (unsigned int i = 0; i < num_beams; i++) {
+      const double angle = _convertSickAngleUnitsToDegs(start_angle + (int)(i*angular_step))*M_PI/180.0;
+      _sick_beam_table.angles[i] = (float)angle;
+      _sick_beam_table.cos_vals[i] = (float)cos(angle);
+      _sick_beam_table.sin_vals[i] = (float)sin(angle);
+    }
+
+  }
+
+  /**
+   * \brief Decodes a CoLa-A LMDscandata telegram in a single pass
+   * \param &recv_message The scan message
+   * \param channel_vals Where to put each channel's values (NULL to skip the channel)
+   * \param &scan_telegram Set to everything else the telegram carries
+   *
+   * NOTE: Every field is visited exactly once, in order. The values of
+   *       channels that weren't asked for are stepped over w/o being
+   *       converted.
+   */
+  void SickLMS1xx::_decodeColaAScanTelegram( const SickLMS1xxMessage &recv_message,
+					     unsigned int * const channel_vals[SICK_LMS_1XX_NUM_CHANNELS],
+					     sick_lms_1xx_scan_telegram_t &scan_telegram ) const throw ( SickIOException ) {
+
+    memset(&scan_telegram,0,sizeof(sick_lms_1xx_scan_telegram_t));
+
+    /* The fields follow "sSN LMDscandata " */
+    const char * const payload = (const char *)recv_message.GetPayloadPtr();
+    const char * const payload_end = payload + recv_message.GetPayloadLength();
+    const char * payload_str = payload + 16;
+
+    if (payload_str > payload_end) {
+      throw SickIOException("SickLMS1xx::_parseSickScanMessage: Scan message truncated!");
+    }
+
     /*
-     * Process DIST2
+     * Device and scan info
      */
-    
-    /* Locate DIST2 Section */
-    if (range_2_vals != NULL) {
-      
-      const char * substr_dist_2 = "DIST2";
-      unsigned int substr_dist_2_pos = 0;
-      if (_findSubString((char *)payload_buffer,substr_dist_2,recv_message.GetPayloadLength()+1,5,substr_dist_2_pos)) {
-
-	/* Extract Num DIST2 Values */
-	payload_str = (char *)&payload_buffer[substr_dist_2_pos+6];
-	for (unsigned int i = 0; i < 4; i++) {
-	  payload_str = _convertNextTokenToUInt(payload_str,null_int);
+    unsigned int null_int = 0;
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.version);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.device_number);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.serial_number);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.device_status[0]);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.device_status[1]);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.telegram_counter);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.scan_counter);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.time_since_startup);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.time_of_transmission);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.input_status[0]);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.input_status[1]);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.output_status[0]);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.output_status[1]);
+    _convertNextTokenToUInt(payload_str,payload_end,null_int); // Reserved
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.scan_freq);
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.measurement_freq);
+
+    /*
+     * Encoders (position and speed apiece, only the first is kept)
+     */
+    _convertNextTokenToUInt(payload_str,payload_end,scan_telegram.num_encoders);
+    for (unsigned int i = 0; i < scan_telegram.num_encoders; i++) {
+      _convertNextTokenToUInt(payload_str,payload_end,(i == 0) ? scan_telegram.encoder_position : null_int);
+      _convertNextTokenToUInt(payload_str,payload_end,(i == 0) ? scan_telegram.encoder_speed : null_int);
+    }
+
+    /*
+     * The 16-bit channel block and then the 8-bit one (they only differ in binary)
+     */
+    for (unsigned int block = 0; block < 2; block++) {
+
+      unsigned int num_channels = 0;
+      _convertNextTokenToUInt(payload_str,payload_end,num_channels);
+
+      for (unsigned int i = 0; i < num_channels; i++) {
+
+	/* Which channel is it? */
+	const unsigned int name_length = sick_lms_1xx_next_field(payload_str,payload_end);
+	const int channel_id = _channelNameToId(payload_str - name_length,name_length);
+
+	/* Grab its description */
+	sick_lms_1xx_channel_info_t channel_info;
+	unsigned int scale_factor_bits = 0, scale_offset_bits = 0, start_angle = 0;
+
+	channel_info.present = true;
+	_convertNextTokenToUInt(payload_str,payload_end,scale_factor_bits);
+	_convertNextTokenToUInt(payload_str,payload_end,scale_offset_bits);
+	_convertNextTokenToUInt(payload_str,payload_end,start_angle);
+	_convertNextTokenToUInt(payload_str,payload_end,channel_info.angular_step);
+	_convertNextTokenToUInt(payload_str,payload_end,channel_info.num_vals);
+
+	channel_info.scale_factor = sick_lms_1xx_bits_to_float(scale_factor_bits);
+	channel_info.scale_offset = sick_lms_1xx_bits_to_float(scale_offset_bits);
+	channel_info.start_angle = (int32_t)start_angle;
+
+	if (channel_info.num_vals > (unsigned int)SICK_LMS_1XX_MAX_NUM_MEASUREMENTS) {
+	  throw SickIOException("SickLMS1xx::_parseSickScanMessage: Too many measurements!");
 	}
-	
-	payload_str = _convertNextTokenToUInt(payload_str,num_dist_2_vals);
-	
-	/* Acquire the DIST2 values */
-	for (unsigned int i = 0; i < num_dist_2_vals; i++) {
-	  payload_str = _convertNextTokenToUInt(payload_str,range_2_vals[i]);
+
+	/* Grab its values (or step over them) */
+	unsigned int * const vals = (channel_id < 0) ? NULL : channel_vals[channel_id];
+	if (vals != NULL) {
+	  for (unsigned int j = 0; j < channel_info.num_vals; j++) {
+	    _convertNextTokenToUInt(payload_str,payload_end,vals[j]);
+	  }
 	}
+	else {
+	  for (unsigned int j = 0; j < channel_info.num_vals; j++) {
+	    if (sick_lms_1xx_next_field(payload_str,payload_end) == 0) {
+	      throw SickIOException("SickLMS1xx::_parseSickScanMessage: Scan message truncated!");
+	    }
+	  }
+	}
+
+	if (channel_id >= 0) {
+	  scan_telegram.channels[channel_id] = channel_info;
+	}
+
       }
-      else {
-	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting double-pulse range values, which are not being streamed! ";
-	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
-      }
-	
+
     }
-      
+
+    /* The rest (position, name, comment, time and event info) isn't used */
+
+  }
+
+  /**
+   * \brief Decodes a CoLa-B LMDscandata telegram in a single pass
+   * \param &recv_message The scan message
+   * \param channel_vals Where to put each channel's values (NULL to skip the channel)
+   * \param &scan_telegram Set to everything else the telegram carries
+   *
+   * NOTE: Every field is big-endian and sits at a fixed offset from the
+   *       start of its block, so nothing is searched for or converted
+   *       from text. The 16-bit channels (DIST* and 16-bit RSSI*) come
+   *       first, followed by the 8-bit ones.
+   */
+  void SickLMS1xx::_decodeColaBScanTelegram( const SickLMS1xxMessage &recv_message,
+					     unsigned int * const channel_vals[SICK_LMS_1XX_NUM_CHANNELS],
+					     sick_lms_1xx_scan_telegram_t &scan_telegram ) const throw ( SickIOException ) {
+
+    memset(&scan_telegram,0,sizeof(sick_lms_1xx_scan_telegram_t));
+
+    const uint8_t * const payload = recv_message.GetPayloadPtr();
+    const unsigned int payload_length = recv_message.GetPayloadLength();
+
     /*
-     * Process RSSI1
+     * The fixed header: "sSN LMDscandata ", version (2), device number (2),
+     * serial number (4), device status (2), telegram and scan counters (2+2),
+     * times since startup and transmission (4+4), input and output status (2+2),
+     * reserved (2), scan and measurement frequencies (4+4), number of encoders (2)
      */
+    unsigned int idx = 52;
+    if (payload_length < idx + 2) {
+      throw SickIOException("SickLMS1xx::_parseSickScanMessage: Scan message truncated!");
+    }
+
+    scan_telegram.version = sick_lms_1xx_cola_b_to_host_uint16(&payload[16]);
+    scan_telegram.device_number = sick_lms_1xx_cola_b_to_host_uint16(&payload[18]);
+    scan_telegram.serial_number = sick_lms_1xx_cola_b_to_host_uint32(&payload[20]);
+    scan_telegram.device_status[0] = payload[24];
+    scan_telegram.device_status[1] = payload[25];
+    scan_telegram.telegram_counter = sick_lms_1xx_cola_b_to_host_uint16(&payload[26]);
+    scan_telegram.scan_counter = sick_lms_1xx_cola_b_to_host_uint16(&payload[28]);
+    scan_telegram.time_since_startup = sick_lms_1xx_cola_b_to_host_uint32(&payload[30]);
+    scan_telegram.time_of_transmission = sick_lms_1xx_cola_b_to_host_uint32(&payload[34]);
+    scan_telegram.input_status[0] = payload[38];
+    scan_telegram.input_status[1] = payload[39];
+    scan_telegram.output_status[0] = payload[40];
+    scan_telegram.output_status[1] = payload[41];
+    scan_telegram.scan_freq = sick_lms_1xx_cola_b_to_host_uint32(&payload[44]);
+    scan_telegram.measurement_freq = sick_lms_1xx_cola_b_to_host_uint32(&payload[48]);
+
+    /* Encoders (position (4) and speed (2) apiece, only the first is kept) */
+    scan_telegram.num_encoders = sick_lms_1xx_cola_b_to_host_uint16(&payload[idx]);
+    idx += 2;
+
+    if (payload_length < idx + 6*scan_telegram.num_encoders) {
+      throw SickIOException("SickLMS1xx::_parseSickScanMessage: Scan message truncated!");
+    }
+
+    if (scan_telegram.num_encoders > 0) {
+      scan_telegram.encoder_position = sick_lms_1xx_cola_b_to_host_uint32(&payload[idx]);
+      scan_telegram.encoder_speed = sick_lms_1xx_cola_b_to_host_uint16(&payload[idx+4]);
+    }
+    idx += 6*scan_telegram.num_encoders;
+
+    /* Walk the 16-bit channel block and then the 8-bit one */
+    for (unsigned int bytes_per_val = 2; bytes_per_val > 0; bytes_per_val--) {
+
+      if (payload_length < idx + 2) {
+	throw SickIOException("SickLMS1xx::_parseSickScanMessage: Scan message truncated!");
+      }
 
-    if (reflect_1_vals != NULL) {
-    
-      /* Locate RSSI1 Section */
-      const char * substr_rssi_1 = "RSSI1";
-      unsigned int substr_rssi_1_pos = 0;
-      if (_findSubString((char *)payload_buffer,substr_rssi_1,recv_message.GetPayloadLength()+1,5,substr_rssi_1_pos)) {
-      
-	/* Extract Num RSSI1 Values */
-	payload_str = (char *)&payload_buffer[substr_rssi_1_pos+6];
-	for (unsigned int i = 0; i < 4; i++) {
-	  payload_str = _convertNextTokenToUInt(payload_str,null_int);
+      const unsigned int num_channels = sick_lms_1xx_cola_b_to_host_uint16(&payload[idx]);
+      idx += 2;
+
+      for (unsigned int i = 0; i < num_channels; i++) {
+
+	/* Name (5), scale factor (4), offset (4), start angle (4), step (2) and count (2) */
+	if (payload_length < idx + 21) {
+	  throw SickIOException("SickLMS1xx::_parseSickScanMessage: Scan message truncated!");
 	}
-	
-	payload_str = _convertNextTokenToUInt(payload_str,num_rssi_1_vals);
-	
-	/* Grab the RSSI1 values */
-	for (unsigned int i = 0; i < num_rssi_1_vals; i++) {
-	  payload_str = _convertNextTokenToUInt(payload_str,reflect_1_vals[i]);
+
+	const int channel_id = _channelNameToId((const char *)&payload[idx],5);
+
+	sick_lms_1xx_channel_info_t channel_info;
+	channel_info.present = true;
+	channel_info.scale_factor = sick_lms_1xx_bits_to_float(sick_lms_1xx_cola_b_to_host_uint32(&payload[idx+5]));
+	channel_info.scale_offset = sick_lms_1xx_bits_to_float(sick_lms_1xx_cola_b_to_host_uint32(&payload[idx+9]));
+	channel_info.start_angle = (int32_t)sick_lms_1xx_cola_b_to_host_uint32(&payload[idx+13]);
+	channel_info.angular_step = sick_lms_1xx_cola_b_to_host_uint16(&payload[idx+17]);
+	channel_info.num_vals = sick_lms_1xx_cola_b_to_host_uint16(&payload[idx+19]);
+	idx += 21;
+
+	if (channel_info.num_vals > (unsigned int)SICK_LMS_1XX_MAX_NUM_MEASUREMENTS) {
+	  throw SickIOException("SickLMS1xx::_parseSickScanMessage: Too many measurements!");
 	}
+
+	if (payload_length < idx + channel_info.num_vals*bytes_per_val) {
+	  throw SickIOException("SickLMS1xx::_parseSickScanMessage: Scan message truncated!");
+	}
+
+	/* Extract the values */
+	unsigned int * const vals = (channel_id < 0) ? NULL : channel_vals[channel_id];
+	if (vals != NULL) {
+	  if (bytes_per_val == 2) {
+	    for (unsigned int j = 0; j < channel_info.num_vals; j++) {
+	      vals[j] = sick_lms_1xx_cola_b_to_host_uint16(&payload[idx+2*j]);
+	    }
+	  }
+	  else {
+	    for (unsigned int j = 0; j < channel_info.num_vals; j++) {
+	      vals[j] = payload[idx+j];
+	    }
+	  }
+	}
+
+	if (channel_id >= 0) {
+	  scan_telegram.channels[channel_id] = channel_info;
+	}
+
+	idx += channel_info.num_vals*bytes_per_val;
+
       }
-      else {
-	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting single-pulse reflectivity values, which are not being streamed! ";
-	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
-      }
-	  
+
     }
-    
-    /*
-     * Process RSSI2
-     */
 
-    if (reflect_2_vals != NULL) {
-    
-      /* Locate RSSI2 Section */
-      const char * substr_rssi_2 = "RSSI2";
-      unsigned int substr_rssi_2_pos = 0;
-      if (_findSubString((char *)payload_buffer,substr_rssi_2,recv_message.GetPayloadLength()+1,5,substr_rssi_2_pos)) {
+  }
+
+  /**
+   * \brief Registers a callback to receive each scan as soon as it is decoded
+   * \param scan_callback The function to call w/ each scan
+   * \param *callback_args Passed through to the callback
+   * \return An id for unregistering the callback
+   *
+   * NOTE: Callbacks run on the buffer monitor's thread (or the reactor's),
+   *       so they must not block. They may unregister callbacks (their own
+   *       included), but must not otherwise call back into the driver. While any callback is registered, streamed scans are
+   *       handed to the callbacks rather than queued, so GetSickMeasurements
+   *       should not be used at the same time.
+   */
+  unsigned int SickLMS1xx::RegisterSickScanCallback( const sick_lms_1xx_scan_callback_t scan_callback, void * const callback_args )
+    throw( SickIOException, SickConfigException, SickTimeoutException, SickThreadException ) {
+
+    /* Ensure the device has been initialized */
+    if (!_sick_initialized) {
+      throw SickIOException("SickLMS1xx::RegisterSickScanCallback: Device NOT Initialized!!!");
+    }
+
+    unsigned int callback_id = 0;
     
-	/* Extract Num RSSI1 Values */
-	payload_str = (char *)&payload_buffer[substr_rssi_2_pos+6];
-	for (unsigned int i = 0; i < 4; i++) {
-	  payload_str = _convertNextTokenToUInt(payload_str,null_int);
-	}
-	
-	payload_str = _convertNextTokenToUInt(payload_str,num_rssi_2_vals);
-	
-	/* Grab the RSSI1 values */
-	for (unsigned int i = 0; i < num_rssi_2_vals; i++) {
-	  payload_str = _convertNextTokenToUInt(payload_str,reflect_2_vals[i]);
+    try {
+
+      callback_id = _sick_scan_subscribers.Subscribe(scan_callback,callback_args);
+
+      /* Scans only arrive once the device is streaming (w/o it, the caller never gets the id, so drop the callback) */
+      try {
+	if (!_sick_streaming) {
+	  _requestDataStream();
 	}
       }
-      else {
-	std::cerr << "SickLMS1xx::GetSickMeasurements: WARNING! It seems you are expecting double-pulse reflectivity values, which are not being streamed! ";
-	std::cerr << "Use SetSickScanDataFormat to configure the LMS 1xx to stream these values - or - set the corresponding buffer input to NULL to avoid this warning." << std::endl;	
+      catch (...) {
+	_sick_scan_subscribers.Unsubscribe(callback_id);
+	throw;
       }
 
     }
-      
-    /* Assign number of measurements */
-    num_measurements = num_dist_1_vals;
+
+    /* Handle config exceptions */
+    catch (SickConfigException &sick_config_exception) {
+      std::cerr << sick_config_exception.what() << std::endl;
+      throw;
+    }
     
-    /* Success! */
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle write buffer exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle thread exceptions */
+    catch (SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+      throw;
+    }
+    
+    catch (...) {
+      std::cerr << "SickLMS1xx::RegisterSickScanCallback: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+    return callback_id;
     
   }
+
+  /**
+   * \brief Unregisters a scan callback
+   * \param callback_id The id returned by RegisterSickScanCallback
+   *
+   * NOTE: The callback will not be called once this returns. The device
+   *       keeps streaming (GetSickMeasurements may be used again).
+   */
+  void SickLMS1xx::UnregisterSickScanCallback( const unsigned int callback_id ) throw( SickThreadException ) {
+
+    if (!_sick_scan_subscribers.Unsubscribe(callback_id)) {
+      std::cerr << "SickLMS1xx::UnregisterSickScanCallback: Unknown callback id!" << std::endl;
+    }
+
+  }
   
   /**
    * \brief Tear down the connection between the host and the Sick LD
@@ -709,30 +1318,21 @@ namespace SickToolbox {
 	  throw SickIOException("SickLMS1xx::_setupConnection: connect() failed!");
 	}
 
-	/* Use select to wait on the socket */
+	/* Use poll to wait on the socket (unlike select, it copes w/ any fd number) */
 	int valid_opt = 0;
 	int num_active_files = 0;
-	struct timeval timeout_val;                                  // This structure will be used for setting our timeout values
-	fd_set file_desc_set;                                        // File descriptor set for monitoring I/O
-    
-	/* Initialize and set the file descriptor set for select */
-	FD_ZERO(&file_desc_set);
-	FD_SET(_sick_fd,&file_desc_set);
+	struct pollfd poll_fd;                               // The socket we are waiting to become writable
+	poll_fd.fd = _sick_fd;
+	poll_fd.events = POLLOUT;
+	poll_fd.revents = 0;
 
-	/* Setup the timeout structure */
-	memset(&timeout_val,0,sizeof(timeout_val));                  // Initialize the buffer
-	timeout_val.tv_usec = DEFAULT_SICK_LMS_1XX_CONNECT_TIMEOUT;  // Wait for specified time before throwing a timeout
-      
 	/* Wait for the OS to tell us that the connection is established! */
-	num_active_files = select(getdtablesize(),0,&file_desc_set,0,&timeout_val);
+	do {
+	  num_active_files = poll(&poll_fd,1,DEFAULT_SICK_LMS_1XX_CONNECT_TIMEOUT/1000);
+	} while (num_active_files < 0 && errno == EINTR);
       
-	/* Figure out what to do based on the output of select */
+	/* Figure out what to do based on the output of poll */
 	if (num_active_files > 0) {
-	
-	  /* This is just a sanity check */
-	  if (!FD_ISSET(_sick_fd,&file_desc_set)) {
-  	    throw SickIOException("SickLMS1xx::_setupConnection: Unexpected file descriptor!");
-	  }	  
 
 	  /* Check for any errors on the socket - just to be sure */
 	  socklen_t len = sizeof(int);
@@ -749,13 +1349,13 @@ namespace SickToolbox {
 	else if (num_active_files == 0) {
 	
 	  /* A timeout has occurred! */
-	  throw SickTimeoutException("SickLMS1xx::_setupConnection: select() timeout!");
+	  throw SickTimeoutException("SickLMS1xx::_setupConnection: poll() timeout!");
 
 	}
 	else {
 	
 	  /* An error has occurred! */
-	  throw SickIOException("SickLMS1xx::_setupConnection: select() failed!");	
+	  throw SickIOException("SickLMS1xx::_setupConnection: poll() failed!");	
 
 	}
 
@@ -763,6 +1363,12 @@ namespace SickToolbox {
 
       /* Restore blocking IO */
       _setBlockingIO();	
+
+      /* Commands are written as whole frames, so don't let Nagle hold them back */
+      int no_delay = 1;
+      if (setsockopt(_sick_fd,IPPROTO_TCP,TCP_NODELAY,(void *)&no_delay,sizeof(int)) < 0) {
+	throw SickIOException("SickLMS1xx::_setupConnection: setsockopt() failed!");
+      }
 	
     }
 
@@ -847,29 +1453,68 @@ namespace SickToolbox {
    }
   
   /**
-   * \brief Get the status of the Sick LMS 1xx
+   * \brief Reads the scan config and status, and logs in as an authorized client
+   *
+   * NOTE: The three requests are independent, so they share a single
+   *       round trip instead of taking one each.
    */
-  void SickLMS1xx::_updateSickStatus( ) throw( SickTimeoutException, SickIOException ) {
+  void SickLMS1xx::_syncWithSick( ) throw( SickTimeoutException, SickErrorException, SickIOException ) {
+
+    /* Construct command messages */
+    SickLMS1xxMessage scan_config_message, status_message, access_mode_message;
+    _buildSickScanConfigRequest(scan_config_message);
+    _buildSickStatusRequest(status_message);
+    _buildAccessModeRequest(access_mode_message);
+    const SickLMS1xxMessage * const send_messages[3] = {&scan_config_message,&status_message,&access_mode_message};
+
+    /* Setup containers for the replies */
+    SickLMS1xxMessage scan_config_reply, status_reply, access_mode_reply;
+    const std::string reply_strs[3] = {"sRA LMPscancfg","sRA STlms","sAN SetAccessMode"};
+    sick_pending_reply_t pending_replies[3];
+    _setPendingReply(pending_replies[0],reply_strs[0],scan_config_reply);
+    _setPendingReply(pending_replies[1],reply_strs[1],status_reply);
+    _setPendingReply(pending_replies[2],reply_strs[2],access_mode_reply);
 
-    /* Allocate a single buffer for payload contents */
-    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+    try {
 
-    /* Set the command type */
-    payload_buffer[0] = 's';
-    payload_buffer[1] = 'R';
-    payload_buffer[2] = 'N';
+      /* Send the requests and collect the replies */
+      _sendMessagesAndGetReplies(send_messages,3,pending_replies,3,DEFAULT_SICK_LMS_1XX_BYTE_INTERVAL,DEFAULT_SICK_LMS_1XX_MESSAGE_TIMEOUT);
+
+    }
+        
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
     
-    payload_buffer[3] = ' ';
+    /* Handle write buffer exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* A safety net */
+    catch (...) {
+      std::cerr << "SickLMS1xx::_syncWithSick: Unknown exception!!!" << std::endl;
+      throw;
+    }
 
-    /* Set the command */
-    payload_buffer[4] = 'S';
-    payload_buffer[5] = 'T';
-    payload_buffer[6] = 'l';
-    payload_buffer[7] = 'm';
-    payload_buffer[8] = 's';
+    /* Adopt what the device reported */
+    _parseSickScanConfigReply(scan_config_reply);
+    _parseSickStatusReply(status_reply);
+    _checkAccessModeReply(access_mode_reply);
+
+  }
+  
+  /**
+   * \brief Get the status of the Sick LMS 1xx
+   */
+  void SickLMS1xx::_updateSickStatus( ) throw( SickTimeoutException, SickIOException ) {
 
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,9);
+    SickLMS1xxMessage send_message;
+    _buildSickStatusRequest(send_message);
 
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -898,49 +1543,75 @@ namespace SickToolbox {
       std::cerr << "SickLMS1xx::_sendMessageAndGetReply: Unknown exception!!!" << std::endl;
       throw;
     }
-    
-    /* Reset the buffer (not necessary, but its better to do so just in case) */
-    memset(payload_buffer,0,9);
-  
-    /* Extract the message payload */
-    recv_message.GetPayload(payload_buffer);
 
-    _sick_device_status = _intToSickStatus(atoi((char *)&payload_buffer[10]));
-    _sick_temp_safe = (bool)atoi((char *)&payload_buffer[12]);
+    /* Adopt the reported status */
+    _parseSickStatusReply(recv_message);
 
     /* Success */
 
   }
 
   /**
-   * \brief Get the scan configuration of the Sick LMS 1xx
+   * \brief Builds the request for the device status
+   * \param &send_message Set to the request
    */
-  void SickLMS1xx::_getSickScanConfig( ) throw( SickTimeoutException, SickIOException ) {
-				      
+  void SickLMS1xx::_buildSickStatusRequest( SickLMS1xxMessage &send_message ) const {
+
     /* Allocate a single buffer for payload contents */
     uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
 
     /* Set the command type */
-    payload_buffer[0]  = 's';
-    payload_buffer[1]  = 'R';
-    payload_buffer[2]  = 'N';
+    payload_buffer[0] = 's';
+    payload_buffer[1] = 'R';
+    payload_buffer[2] = 'N';
     
-    payload_buffer[3]  = ' ';
+    payload_buffer[3] = ' ';
 
     /* Set the command */
-    payload_buffer[4]  = 'L';
-    payload_buffer[5]  = 'M';
-    payload_buffer[6]  = 'P';
-    payload_buffer[7]  = 's';
-    payload_buffer[8]  = 'c';
-    payload_buffer[9]  = 'a';
-    payload_buffer[10] = 'n';
-    payload_buffer[11] = 'c';
-    payload_buffer[12] = 'f';
-    payload_buffer[13] = 'g';    
+    payload_buffer[4] = 'S';
+    payload_buffer[5] = 'T';
+    payload_buffer[6] = 'l';
+    payload_buffer[7] = 'm';
+    payload_buffer[8] = 's';
 
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,14);
+    send_message.BuildMessage(payload_buffer,9,_sick_protocol);
+
+  }
+
+  /**
+   * \brief Adopts the device status reported by the Sick LMS 1xx
+   * \param &recv_message The reply to the status request
+   */
+  void SickLMS1xx::_parseSickStatusReply( const SickLMS1xxMessage &recv_message ) {
+
+    /* Allocate a single buffer for payload contents */
+    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+  
+    /* Extract the message payload */
+    recv_message.GetPayload(payload_buffer);
+
+    if (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) {
+      _sick_device_status = _intToSickStatus(sick_lms_1xx_cola_b_to_host_uint16(&payload_buffer[10]));
+      _sick_temp_safe = (bool)payload_buffer[12];
+    }
+    else {
+      _sick_device_status = _intToSickStatus(atoi((char *)&payload_buffer[10]));
+      _sick_temp_safe = (bool)atoi((char *)&payload_buffer[12]);
+    }
+
+    /* Success */
+
+  }
+
+  /**
+   * \brief Get the scan configuration of the Sick LMS 1xx
+   */
+  void SickLMS1xx::_getSickScanConfig( ) throw( SickTimeoutException, SickIOException ) {
+
+    /* Construct command message */
+    SickLMS1xxMessage send_message;
+    _buildSickScanConfigRequest(send_message);
 
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -969,76 +1640,116 @@ namespace SickToolbox {
       std::cerr << "SickLMS1xx::_sendMessageAndGetReply: Unknown exception!!!" << std::endl;
       throw;
     }
+
+    /* Adopt the reported configuration */
+    _parseSickScanConfigReply(recv_message);
+
+  }
+
+  /**
+   * \brief Builds the request for the scan configuration
+   * \param &send_message Set to the request
+   */
+  void SickLMS1xx::_buildSickScanConfigRequest( SickLMS1xxMessage &send_message ) const {
+				      
+    /* Allocate a single buffer for payload contents */
+    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+
+    /* Set the command type */
+    payload_buffer[0]  = 's';
+    payload_buffer[1]  = 'R';
+    payload_buffer[2]  = 'N';
     
-    /* Reset the buffer (not necessary, but its better to do so just in case) */
-    memset(payload_buffer,0,14);
+    payload_buffer[3]  = ' ';
+
+    /* Set the command */
+    payload_buffer[4]  = 'L';
+    payload_buffer[5]  = 'M';
+    payload_buffer[6]  = 'P';
+    payload_buffer[7]  = 's';
+    payload_buffer[8]  = 'c';
+    payload_buffer[9]  = 'a';
+    payload_buffer[10] = 'n';
+    payload_buffer[11] = 'c';
+    payload_buffer[12] = 'f';
+    payload_buffer[13] = 'g';    
+
+    /* Construct command message */
+    send_message.BuildMessage(payload_buffer,14,_sick_protocol);
+
+  }
+
+  /**
+   * \brief Adopts the scan configuration reported by the Sick LMS 1xx
+   * \param &recv_message The reply to the scan configuration request
+   */
+  void SickLMS1xx::_parseSickScanConfigReply( const SickLMS1xxMessage &recv_message ) throw( SickIOException ) {
+
+    /* Allocate a single buffer for payload contents */
+    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
   
     /* Extract the message payload */
     recv_message.GetPayloadAsCStr((char *)payload_buffer);
 
     /* Utility variables */
-    uint32_t scan_freq = 0, scan_res = 0;
-    uint32_t sick_start_angle = 0, sick_stop_angle = 0;
+    unsigned int scan_freq = 0, scan_res = 0;
+    unsigned int sick_start_angle = 0, sick_stop_angle = 0;
 
     /*
-     * Grab the scanning frequency
+     * A CoLa-B reply holds the frequency (4 bytes), number of segments (2),
+     * resolution (4), start angle (4) and stop angle (4) at fixed offsets
      */
-    const char * token = NULL;
-    if ((token = strtok((char *)&payload_buffer[15]," ")) == NULL) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: strtok() failed!");
-    }
+    if (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) {
 
-    if (sscanf(token,"%x",&scan_freq) == EOF) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: sscanf() failed!");
-    }
+      if (recv_message.GetPayloadLength() < 33) {
+	throw SickIOException("SickLMS1xx::_getSickConfig: Reply too short!");
+      }
 
-    sick_lms_1xx_scan_freq_t sick_scan_freq;
-    sick_scan_freq = (sick_lms_1xx_scan_freq_t)sick_lms_1xx_to_host_byte_order(scan_freq);
+      _sick_scan_config.sick_scan_freq = (sick_lms_1xx_scan_freq_t)sick_lms_1xx_cola_b_to_host_uint32(&payload_buffer[15]);
+      _sick_scan_config.sick_scan_res = (sick_lms_1xx_scan_res_t)sick_lms_1xx_cola_b_to_host_uint32(&payload_buffer[21]);
+      _sick_scan_config.sick_start_angle = (int32_t)sick_lms_1xx_cola_b_to_host_uint32(&payload_buffer[25]);
+      _sick_scan_config.sick_stop_angle = (int32_t)sick_lms_1xx_cola_b_to_host_uint32(&payload_buffer[29]);
+      _updateSickBeamTable();
+      return;
 
-    /* Ignore the number of segments value (its always 1 for the LMS 1xx) */
-    if ((token = strtok(NULL," ")) == NULL) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: strtok() failed!");
     }
 
-    /*
-     * Grab the angular resolution
-     */    
-    if ((token = strtok(NULL," ")) == NULL) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: strtok() failed!");
-    }
-    
-    if (sscanf(token,"%x",&scan_res) == EOF) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: sscanf() failed!");
-    }
+    /* The fields follow "sRA LMPscancfg " */
+    const char * payload_str = (const char *)&payload_buffer[15];
+    const char * const payload_end = (const char *)&payload_buffer[recv_message.GetPayloadLength()];
 
-    sick_lms_1xx_scan_res_t sick_scan_res;
-    sick_scan_res = (sick_lms_1xx_scan_res_t)sick_lms_1xx_to_host_byte_order(scan_res);
+    try {
 
-    /*
-     * Grab the start angle
-     */    
-    if ((token = strtok(NULL," ")) == NULL) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: strtok() failed!");
-    }
-    
-    if (sscanf(token,"%x",&sick_start_angle) == EOF) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: sscanf() failed!");
-    }
-    
-    sick_start_angle = sick_lms_1xx_to_host_byte_order(sick_start_angle);
+      /*
+       * Grab the scanning frequency
+       */
+      _convertNextTokenToUInt(payload_str,payload_end,scan_freq);
+
+      /* Ignore the number of segments value (its always 1 for the LMS 1xx) */
+      unsigned int null_int = 0;
+      _convertNextTokenToUInt(payload_str,payload_end,null_int);
+
+      /*
+       * Grab the angular resolution
+       */
+      _convertNextTokenToUInt(payload_str,payload_end,scan_res);
+
+      /*
+       * Grab the start and stop angles
+       */
+      _convertNextTokenToUInt(payload_str,payload_end,sick_start_angle);
+      _convertNextTokenToUInt(payload_str,payload_end,sick_stop_angle);
 
-    /*
-     * Grab the stop angle
-     */    
-    if ((token = strtok(NULL," ")) == NULL) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: strtok() failed!");
     }
-    
-    if (sscanf(token,"%x",&sick_stop_angle) == EOF) {
-      throw SickIOException("SickLMS1xx::_getSickConfig: sscanf() failed!");
+
+    /* Handle a malformed reply */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << "SickLMS1xx::_getSickConfig: Malformed reply!" << std::endl;
+      throw;
     }
-    
-    sick_stop_angle = sick_lms_1xx_to_host_byte_order(sick_stop_angle);
+
+    sick_lms_1xx_scan_freq_t sick_scan_freq = (sick_lms_1xx_scan_freq_t)scan_freq;
+    sick_lms_1xx_scan_res_t sick_scan_res = (sick_lms_1xx_scan_res_t)scan_res;
 
     /*
      * Assign the config values!
@@ -1047,6 +1758,9 @@ namespace SickToolbox {
     _sick_scan_config.sick_scan_res = sick_scan_res;
     _sick_scan_config.sick_start_angle = sick_start_angle;
     _sick_scan_config.sick_stop_angle = sick_stop_angle;
+
+    /* Keep the beam angles in step w/ the scan area */
+    _updateSickBeamTable();
     
     /* Success */
 
@@ -1099,64 +1813,80 @@ namespace SickToolbox {
 
     payload_buffer[18] = ' ';    
 
-    /* Desired scanning frequency */
-    std::string freq_str = int_to_str((int)scan_freq);
+    unsigned int idx = 19;
+    if (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) {
+
+      /* Frequency, number of segments (always 1), resolution, start and stop angles */
+      host_to_sick_lms_1xx_cola_b_uint32((uint32_t)scan_freq,&payload_buffer[19]);
+      host_to_sick_lms_1xx_cola_b_uint16(1,&payload_buffer[23]);
+      host_to_sick_lms_1xx_cola_b_uint32((uint32_t)scan_res,&payload_buffer[25]);
+      host_to_sick_lms_1xx_cola_b_uint32((uint32_t)start_angle,&payload_buffer[29]);
+      host_to_sick_lms_1xx_cola_b_uint32((uint32_t)stop_angle,&payload_buffer[33]);
+      idx = 37;
+
+    }
+    else {
+
+      /* Desired scanning frequency */
+      std::string freq_str = int_to_str((int)scan_freq);
     
-    payload_buffer[19] = '+';
+      payload_buffer[19] = '+';
     
-    for (int i = 0; i < 4; i++) {
-      payload_buffer[20+i] = (uint8_t)((freq_str.c_str())[i]);
-    }
+      for (int i = 0; i < 4; i++) {
+	payload_buffer[20+i] = (uint8_t)((freq_str.c_str())[i]);
+      }
 
-    payload_buffer[24] = ' ';    
+      payload_buffer[24] = ' ';    
 
-    /* Desired number of segments (always 1) */
-    payload_buffer[25] = '+';
-    payload_buffer[26] = '1';
+      /* Desired number of segments (always 1) */
+      payload_buffer[25] = '+';
+      payload_buffer[26] = '1';
 
-    payload_buffer[27] = ' ';    
+      payload_buffer[27] = ' ';    
     
-    /* Desired angular resolution */
-    std::string res_str = int_to_str((int)scan_res);
+      /* Desired angular resolution */
+      std::string res_str = int_to_str((int)scan_res);
     
-    payload_buffer[28] = '+';   
+      payload_buffer[28] = '+';   
     
-    for (int i = 0; i < 4; i++) {
-      payload_buffer[29+i] = (uint8_t)((res_str.c_str())[i]);
-    }
+      for (int i = 0; i < 4; i++) {
+	payload_buffer[29+i] = (uint8_t)((res_str.c_str())[i]);
+      }
 
-    payload_buffer[33] = ' ';
+      payload_buffer[33] = ' ';
 
-    /* Desired starting angle */
-    std::string start_angle_str = int_to_str(start_angle);
+      /* Desired starting angle */
+      std::string start_angle_str = int_to_str(start_angle);
 
-    unsigned int idx = 34;
-    if (start_angle >= 0) {
-      payload_buffer[idx] = '+';
-      idx++;
-    }
+      idx = 34;
+      if (start_angle >= 0) {
+	payload_buffer[idx] = '+';
+	idx++;
+      }
 
-    for (int i = 0; i < start_angle_str.length(); idx++, i++) {
-      payload_buffer[idx] = (uint8_t)(start_angle_str.c_str())[i];
-    }
+      for (int i = 0; i < start_angle_str.length(); idx++, i++) {
+	payload_buffer[idx] = (uint8_t)(start_angle_str.c_str())[i];
+      }
 
-    payload_buffer[idx] = ' ';
-    idx++;
+      payload_buffer[idx] = ' ';
+      idx++;
 
-    /* Desired stopping angle */
-    std::string stop_angle_str = int_to_str(stop_angle);
+      /* Desired stopping angle */
+      std::string stop_angle_str = int_to_str(stop_angle);
 
-    if (stop_angle >= 0) {
-      payload_buffer[idx] = '+';
-      idx++;
-    }
+      if (stop_angle >= 0) {
+	payload_buffer[idx] = '+';
+	idx++;
+      }
     
-    for (int i = 0; i < stop_angle_str.length(); idx++, i++) {
-      payload_buffer[idx] = (uint8_t)(stop_angle_str.c_str())[i];
+      for (int i = 0; i < stop_angle_str.length(); idx++, i++) {
+	payload_buffer[idx] = (uint8_t)(stop_angle_str.c_str())[i];
+      }
+
     }
         
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,idx);
+    SickLMS1xxMessage send_message(payload_buffer,idx,_sick_protocol);
 
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -1193,8 +1923,9 @@ namespace SickToolbox {
     recv_message.GetPayload(payload_buffer);
     
     /* Check if it worked... */
-    if (payload_buffer[19] != '0') {
-	throw SickErrorException("SickLMS1xx::_setSickScanConfig: " + _intToSickConfigErrorStr(atoi((char *)&payload_buffer[19])));
+    if (payload_buffer[19] != _encodeDigit(0)) {
+      const int error = (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) ? payload_buffer[19] : atoi((char *)&payload_buffer[19]);
+      throw SickErrorException("SickLMS1xx::_setSickScanConfig: " + _intToSickConfigErrorStr(error));
     }
 
     std::cout << "\t\tDevice configured!" << std::endl << std::endl;
@@ -1235,6 +1966,51 @@ namespace SickToolbox {
    */
   void SickLMS1xx::_setAuthorizedClientAccessMode() throw( SickTimeoutException, SickErrorException, SickIOException ) {
 
+    /* Construct command message */
+    SickLMS1xxMessage send_message;
+    _buildAccessModeRequest(send_message);
+
+    /* Setup container for recv message */
+    SickLMS1xxMessage recv_message;
+
+    /* Send message and get reply using parent's method */
+    try {
+      
+      _sendMessageAndGetReply(send_message, recv_message, "sAN", "SetAccessMode");
+
+    }
+        
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle write buffer exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* A safety net */
+    catch (...) {
+      std::cerr << "SickLMS1xx::_setAuthorizedClientAccessMode: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+    /* Check Response */
+    _checkAccessModeReply(recv_message);
+
+    /* Success! Woohoo! */
+    
+  }
+
+  /**
+   * \brief Builds the request to log in as an authorized client
+   * \param &send_message Set to the request
+   */
+  void SickLMS1xx::_buildAccessModeRequest( SickLMS1xxMessage &send_message ) const {
+
     /* Allocate a single buffer for payload contents */
     uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
     
@@ -1261,67 +2037,58 @@ namespace SickToolbox {
     payload_buffer[16] = 'e';    
 
     payload_buffer[17] = ' ';
+
+    unsigned int payload_length = 29;
+    if (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) {
+
+      /* Set as authorized client (w/ its encoded value) */
+      payload_buffer[18] = 0x03;
+      host_to_sick_lms_1xx_cola_b_uint32(0xF4724744,&payload_buffer[19]);
+      payload_length = 23;
+
+    }
+    else {
     
-    /* Set as authorized client */
-    payload_buffer[18] = '0';
-    payload_buffer[19] = '3';
+      /* Set as authorized client */
+      payload_buffer[18] = '0';
+      payload_buffer[19] = '3';
+
+      payload_buffer[20] = ' ';
 
-    payload_buffer[20] = ' ';
+      /* Encoded value for client */
+      payload_buffer[21] = 'F';
+      payload_buffer[22] = '4';
+      payload_buffer[23] = '7';
+      payload_buffer[24] = '2';
+      payload_buffer[25] = '4';
+      payload_buffer[26] = '7';
+      payload_buffer[27] = '4';
+      payload_buffer[28] = '4';
 
-    /* Encoded value for client */
-    payload_buffer[21] = 'F';
-    payload_buffer[22] = '4';
-    payload_buffer[23] = '7';
-    payload_buffer[24] = '2';
-    payload_buffer[25] = '4';
-    payload_buffer[26] = '7';
-    payload_buffer[27] = '4';
-    payload_buffer[28] = '4';
+    }
 
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,29);
+    send_message.BuildMessage(payload_buffer,payload_length,_sick_protocol);
 
-    /* Setup container for recv message */
-    SickLMS1xxMessage recv_message;
+  }
 
-    /* Send message and get reply using parent's method */
-    try {
-      
-      _sendMessageAndGetReply(send_message, recv_message, "sAN", "SetAccessMode");
+  /**
+   * \brief Checks the reply to the request to log in as an authorized client
+   * \param &recv_message The reply
+   */
+  void SickLMS1xx::_checkAccessModeReply( const SickLMS1xxMessage &recv_message ) const throw( SickErrorException ) {
 
-    }
-        
-    /* Handle a timeout! */
-    catch (SickTimeoutException &sick_timeout_exception) {
-      std::cerr << sick_timeout_exception.what() << std::endl;
-      throw;
-    }
-    
-    /* Handle write buffer exceptions */
-    catch (SickIOException &sick_io_exception) {
-      std::cerr << sick_io_exception.what() << std::endl;
-      throw;
-    }
-    
-    /* A safety net */
-    catch (...) {
-      std::cerr << "SickLMS1xx::_setAuthorizedClientAccessMode: Unknown exception!!!" << std::endl;
-      throw;
-    }
-    
-    /* Reset the buffer (not necessary, but its better to do so just in case) */
-    memset(payload_buffer,0,29);
+    /* Allocate a single buffer for payload contents */
+    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
     
     /* Extract the message payload */
     recv_message.GetPayload(payload_buffer);
 
     /* Check Response */
-    if (payload_buffer[18] != '1') {
+    if (payload_buffer[18] != _encodeDigit(1)) {
       throw SickErrorException("SickLMS1xx::_setAuthorizedClientAccessMode: Setting Access Mode Failed!");    
     }
 
-    /* Success! Woohoo! */
-    
   }
 
   /**
@@ -1353,7 +2120,7 @@ namespace SickToolbox {
     payload_buffer[14] = 'l';
 
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,15);
+    SickLMS1xxMessage send_message(payload_buffer,15,_sick_protocol);
 
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -1390,7 +2157,7 @@ namespace SickToolbox {
     recv_message.GetPayload(payload_buffer);
 
     /* Check Response */
-    if (payload_buffer[13] != '1') {
+    if (payload_buffer[16] != _encodeDigit(1)) {
       throw SickIOException("SickLMS1xx::_writeToEEPROM: Failed to Write Data!");    
     }
 
@@ -1403,31 +2170,9 @@ namespace SickToolbox {
    */
   void SickLMS1xx::_startMeasuring( ) throw( SickTimeoutException, SickIOException ) {
 
-    /* Allocate a single buffer for payload contents */
-    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
-    /* Set the command type */
-    payload_buffer[0]  = 's';
-    payload_buffer[1]  = 'M';
-    payload_buffer[2]  = 'N';
-    payload_buffer[3]  = ' ';
-    
-    /* Set the command */
-    payload_buffer[4]  = 'L';
-    payload_buffer[5]  = 'M';
-    payload_buffer[6]  = 'C';
-    payload_buffer[7]  = 's';
-    payload_buffer[8]  = 't';
-    payload_buffer[9]  = 'a';
-    payload_buffer[10] = 'r';
-    payload_buffer[11] = 't';
-    payload_buffer[12] = 'm';
-    payload_buffer[13] = 'e';
-    payload_buffer[14] = 'a';
-    payload_buffer[15] = 's';    
-
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,16);
+    SickLMS1xxMessage send_message;
+    _buildStartMeasuringRequest(send_message);
     
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -1457,14 +2202,59 @@ namespace SickToolbox {
       throw;
     }
 
-    /* Reset the buffer (not necessary, but its better to do so just in case) */
-    memset(payload_buffer,0,16);
+    /* Check if it worked... */
+    _checkStartMeasuringReply(recv_message);
+    
+  }
+
+  /**
+   * \brief Builds the request telling the device to start measuring
+   * \param &send_message Set to the request
+   */
+  void SickLMS1xx::_buildStartMeasuringRequest( SickLMS1xxMessage &send_message ) const {
+
+    /* Allocate a single buffer for payload contents */
+    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
+    
+    /* Set the command type */
+    payload_buffer[0]  = 's';
+    payload_buffer[1]  = 'M';
+    payload_buffer[2]  = 'N';
+    payload_buffer[3]  = ' ';
+    
+    /* Set the command */
+    payload_buffer[4]  = 'L';
+    payload_buffer[5]  = 'M';
+    payload_buffer[6]  = 'C';
+    payload_buffer[7]  = 's';
+    payload_buffer[8]  = 't';
+    payload_buffer[9]  = 'a';
+    payload_buffer[10] = 'r';
+    payload_buffer[11] = 't';
+    payload_buffer[12] = 'm';
+    payload_buffer[13] = 'e';
+    payload_buffer[14] = 'a';
+    payload_buffer[15] = 's';    
+
+    /* Construct command message */
+    send_message.BuildMessage(payload_buffer,16,_sick_protocol);
+
+  }
+
+  /**
+   * \brief Checks the reply to the request to start measuring
+   * \param &recv_message The reply
+   */
+  void SickLMS1xx::_checkStartMeasuringReply( const SickLMS1xxMessage &recv_message ) const throw( SickConfigException ) {
+
+    /* Allocate a single buffer for payload contents */
+    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
 
     /* Extract the message payload */
     recv_message.GetPayload(payload_buffer);
     
     /* Check if it worked... */
-    if (payload_buffer[17] != '0') {
+    if (payload_buffer[17] != _encodeDigit(0)) {
 	throw SickConfigException("SickLMS1xx::_startMeasuring: Unable to start measuring!");	      
     }
     
@@ -1498,7 +2288,7 @@ namespace SickToolbox {
     payload_buffer[14] = 's';    
     
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,15);
+    SickLMS1xxMessage send_message(payload_buffer,15,_sick_protocol);
     
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -1535,37 +2325,153 @@ namespace SickToolbox {
     recv_message.GetPayload(payload_buffer);
     
     /* Check if it worked... */
-    if (payload_buffer[16] != '0') {
+    if (payload_buffer[16] != _encodeDigit(0)) {
       throw SickConfigException("SickLMS1xx::_stopMeasuring: Unable to start measuring!");	      
     }
     
   }
 
   /**
-   * \brief Request a data data stream type
-   * \param dist_opt Desired distance returns (single-pulse or multi-pulse)
-   * \param reflect_opt Desired reflectivity returns (none, 8-bit or 16-bit)
+   * \brief Request a data data stream type
+   * \param dist_opt Desired distance returns (single-pulse or multi-pulse)
+   * \param reflect_opt Desired reflectivity returns (none, 8-bit or 16-bit)
+   */
+  void SickLMS1xx::_requestDataStream( ) throw( SickTimeoutException, SickConfigException, SickIOException ) {
+
+    std::cout << std::endl << "\tRequesting data stream..." << std::endl;
+    
+    try {
+      
+      /* Start measuring and wait for the stream to flow */
+      _startStreamingMeasurements();
+      
+    }
+    
+    /* Handle config exceptions */
+    catch (SickConfigException &sick_config_exception) {
+      std::cerr << sick_config_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle write buffer exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+    
+    catch (...) {
+      std::cerr << "SickLMS1xx::SetSickScanArea: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+    std::cout << "\t\tStream started!" << std::endl;
+
+  }
+  
+  /*
+   * \brief Start Streaming Values
+   *
+   * NOTE: LMCstartmeas and the LMDscandata subscription go out back to
+   *       back. The device only streams once it is ready to measure, so
+   *       the first scan tells us as much (the LMS 1xx has no event for
+   *       its status, which used to be polled w/ STlms until it was).
+   */
+  void SickLMS1xx::_startStreamingMeasurements( ) throw( SickTimeoutException, SickConfigException, SickIOException ) {
+
+    /* Construct command messages */
+    SickLMS1xxMessage start_measuring_message, data_stream_message;
+    _buildStartMeasuringRequest(start_measuring_message);
+    _buildDataStreamRequest(data_stream_message,true);
+    const SickLMS1xxMessage * const send_messages[2] = {&start_measuring_message,&data_stream_message};
+
+    /* Setup containers for the replies (the first scan tells us the device is ready) */
+    SickLMS1xxMessage start_measuring_reply, data_stream_reply, first_scan_message;
+    const std::string reply_strs[3] = {"sAN LMCstartmeas","sEA LMDscandata","sSN LMDscandata"};
+    sick_pending_reply_t pending_replies[3];
+    _setPendingReply(pending_replies[0],reply_strs[0],start_measuring_reply);
+    _setPendingReply(pending_replies[1],reply_strs[1],data_stream_reply);
+    _setPendingReply(pending_replies[2],reply_strs[2],first_scan_message);
+
+    /* Follow the telegram counter afresh (before the first telegram can arrive) */
+    _restartScanSequence();
+
+    try {
+
+      /* Send both requests at once */
+      _sendPipelinedMessages(send_messages,2,pending_replies,3,DEFAULT_SICK_LMS_1XX_BYTE_INTERVAL);
+
+      /* LMCstartmeas and the subscription are acknowledged right away... */
+      _recvPipelinedReply(pending_replies,3,0,DEFAULT_SICK_LMS_1XX_MESSAGE_TIMEOUT);
+      _checkStartMeasuringReply(start_measuring_reply);
+      _recvPipelinedReply(pending_replies,3,1,DEFAULT_SICK_LMS_1XX_MESSAGE_TIMEOUT);
+
+      /* ...but the scans only start once the device is ready */
+      _recvPipelinedReply(pending_replies,3,2,DEFAULT_SICK_LMS_1XX_STATUS_TIMEOUT);
+
+    }
+        
+    /* Handle a timeout! */
+    catch (SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      _endPipeline(pending_replies,3);
+      throw;
+    }
+
+    /* Handle a refusal to measure */
+    catch (SickConfigException &sick_config_exception) {
+      std::cerr << sick_config_exception.what() << std::endl;
+      _endPipeline(pending_replies,3);
+      throw;
+    }
+    
+    /* Handle write buffer exceptions */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      _endPipeline(pending_replies,3);
+      throw;
+    }
+    
+    /* A safety net */
+    catch (...) {
+      std::cerr << "SickLMS1xx::_startStreamingMeasurements: Unknown exception!!!" << std::endl;
+      _endPipeline(pending_replies,3);
+      throw;
+    }
+
+    /* Subsequent scans belong on the data channel */
+    _endPipeline(pending_replies,3);
+
+    /* Success! */
+    _sick_streaming = true;
+    
+  }
+
+  /**
+   * \brief Stop Measurment Stream
    */
-  void SickLMS1xx::_requestDataStream( ) throw( SickTimeoutException, SickConfigException, SickIOException ) {
+  void SickLMS1xx::_stopStreamingMeasurements( const bool disp_banner ) throw( SickTimeoutException, SickIOException ) {
 
-    std::cout << std::endl << "\tRequesting data stream..." << std::endl;
-    
-    try {
-      
-      /* Wait for device to be measuring */
-      _checkForMeasuringStatus();
-      
-      /* Request the data stream... */
-      _startStreamingMeasurements();
-      
+    if (disp_banner) {
+      std::cout << "\tStopping data stream..." << std::endl;
     }
-    
-    /* Handle config exceptions */
-    catch (SickConfigException &sick_config_exception) {
-      std::cerr << sick_config_exception.what() << std::endl;
-      throw;
+      
+    /* Construct command message */
+    SickLMS1xxMessage send_message, recv_message;
+    _buildDataStreamRequest(send_message,false);
+
+    try {
+
+      /* Send message and get reply (so the ack isn't left on the data channel) */
+      _sendMessageAndGetReply(send_message, recv_message, "sEA", "LMDscandata");
+
     }
-    
+        
     /* Handle a timeout! */
     catch (SickTimeoutException &sick_timeout_exception) {
       std::cerr << sick_timeout_exception.what() << std::endl;
@@ -1578,19 +2484,30 @@ namespace SickToolbox {
       throw;
     }
     
+    /* A safety net */
     catch (...) {
-      std::cerr << "SickLMS1xx::SetSickScanArea: Unknown exception!!!" << std::endl;
+      std::cerr << "SickLMS1xx::_stopStreamingMeasurements: Unknown exception!!!" << std::endl;
       throw;
     }
 
-    std::cout << "\t\tStream started!" << std::endl;
+    /* The last scans came in ahead of the ack and would be stale by the next start */
+    _sick_buffer_monitor->FlushMessageQueue();
 
+    /* Success! */
+    if (disp_banner) {
+      std::cout << "\t\tStream stopped!" << std::endl;
+    }
+    
+    _sick_streaming = false;
+    
   }
-  
-  /*
-   * \brief Start Streaming Values
+
+  /**
+   * \brief Builds the request subscribing to (or unsubscribing from) the scan data
+   * \param &send_message Set to the request
+   * \param stream Whether to start the stream (or stop it)
    */
-  void SickLMS1xx::_startStreamingMeasurements( ) throw( SickTimeoutException, SickIOException ) {
+  void SickLMS1xx::_buildDataStreamRequest( SickLMS1xxMessage &send_message, const bool stream ) const {
 
     /* Allocate a single buffer for payload contents */
     uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
@@ -1615,11 +2532,23 @@ namespace SickToolbox {
     payload_buffer[14] = 'a';
     payload_buffer[15] = ' ';
 
-    /* Start streaming! */
-    payload_buffer[16] = '1';
+    /* Start (or stop) streaming! */
+    payload_buffer[16] = _encodeDigit(stream ? 1 : 0);
+    
+    /* Construct command message */
+    send_message.BuildMessage(payload_buffer,17,_sick_protocol);
+
+  }
+
+  /**
+   * \brief Sets the scan data format and options (the device is reinitialized)
+   * \param &scan_data_cfg The channels, optional blocks and output interval
+   */
+  void SickLMS1xx::_setSickScanDataConfig( const sick_lms_1xx_scan_data_cfg_t &scan_data_cfg ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException ) {
     
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,17);
+    SickLMS1xxMessage send_message;
+    _buildScanDataConfigRequest(send_message,scan_data_cfg);
 
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -1627,8 +2556,14 @@ namespace SickToolbox {
     try {
 
       /* Send message and get reply */      
-      _sendMessageAndGetReply(send_message, recv_message, "sSN", "LMDscandata");
+      _sendMessageAndGetReply(send_message, recv_message, "sWA", "LMDscandatacfg");
+
+      /* Reinitialize the Sick so it uses the requested format */
+      _reinitialize();
 
+      /* Set the sick scan data format */
+      _sick_scan_data_cfg = scan_data_cfg;
+      
     }
         
     /* Handle a timeout! */
@@ -1642,33 +2577,41 @@ namespace SickToolbox {
       std::cerr << sick_io_exception.what() << std::endl;
       throw;
     }
+
+    /* Handle thread exception */
+    catch (SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle Sick error */
+    catch (SickErrorException &sick_error_exception) {
+      std::cerr << sick_error_exception.what() << std::endl;
+      throw;
+    }
     
-    /* A safety net */
     catch (...) {
-      std::cerr << "SickLMS1xx::_startStreamingMeasurements: Unknown exception!!!" << std::endl;
+      std::cerr << "SickLMS1xx::_setSickScanDataConfig: Unknown exception!!!" << std::endl;
       throw;
     }
 
     /* Success! */
-    _sick_streaming = true;
     
   }
 
   /**
-   * \brief Stop Measurment Stream
+   * \brief Builds the request setting the scan data format and options
+   * \param &send_message Set to the request
+   * \param &scan_data_cfg The channels, optional blocks and output interval
    */
-  void SickLMS1xx::_stopStreamingMeasurements( const bool disp_banner ) throw( SickTimeoutException, SickIOException ) {
-
-    if (disp_banner) {
-      std::cout << "\tStopping data stream..." << std::endl;
-    }
-      
+  void SickLMS1xx::_buildScanDataConfigRequest( SickLMS1xxMessage &send_message, const sick_lms_1xx_scan_data_cfg_t &scan_data_cfg ) const {
+    
     /* Allocate a single buffer for payload contents */
     uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
+
     /* Set the command type */
     payload_buffer[0]  = 's';
-    payload_buffer[1]  = 'E';
+    payload_buffer[1]  = 'W';
     payload_buffer[2]  = 'N';
     payload_buffer[3]  = ' ';
     
@@ -1684,115 +2627,146 @@ namespace SickToolbox {
     payload_buffer[12] = 'a';
     payload_buffer[13] = 't';
     payload_buffer[14] = 'a';
-    payload_buffer[15] = ' ';
+    payload_buffer[15] = 'c';
+    payload_buffer[16] = 'f';
+    payload_buffer[17] = 'g';
+    payload_buffer[18] = ' ';
 
-    /* Start streaming! */
-    payload_buffer[16] = '0';
+    const sick_lms_1xx_scan_format_t scan_format = scan_data_cfg.scan_format;
     
-    /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,17);
+    unsigned int payload_length = 0;
+    if (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) {
 
-    /* Setup container for recv message */
-    SickLMS1xxMessage recv_message;
+      /* Specify the channel (2 bytes) */
+      if (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_NONE ||
+	  scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_8BIT ||
+	  scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_16BIT) {
+	payload_buffer[19] = 0x01;
+      }
+      else {
+	payload_buffer[19] = 0x03;
+      }
+      payload_buffer[20] = 0x00;
 
-    try {
+      /* Remission values and their resolution */
+      payload_buffer[21] = (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_NONE ||
+			    scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_NONE) ? 0x00 : 0x01;
+      payload_buffer[22] = (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_16BIT ||
+			    scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_16BIT) ? 0x01 : 0x00;
 
-      /* Send message and get reply */      
-      _sendMessage(send_message);
+      /* Units (always 0) */
+      payload_buffer[23] = 0x00;
+
+      /* Encoder (2 bytes, laid out like the channel) */
+      payload_buffer[24] = scan_data_cfg.send_encoder ? 0x01 : 0x00;
+      payload_buffer[25] = 0x00;
+
+      /* Position, device name, comment and time */
+      payload_buffer[26] = scan_data_cfg.send_position ? 0x01 : 0x00;
+      payload_buffer[27] = scan_data_cfg.send_device_name ? 0x01 : 0x00;
+      payload_buffer[28] = scan_data_cfg.send_comment ? 0x01 : 0x00;
+      payload_buffer[29] = scan_data_cfg.send_time ? 0x01 : 0x00;
+
+      /* Output interval (2 bytes) */
+      host_to_sick_lms_1xx_cola_b_uint16(scan_data_cfg.output_interval,&payload_buffer[30]);
+      payload_length = 32;
 
     }
-        
-    /* Handle write buffer exceptions */
-    catch (SickIOException &sick_io_exception) {
-      std::cerr << sick_io_exception.what() << std::endl;
-      throw;
-    }
+    else {
+
+      /* Specify the channel */
+      payload_buffer[19] = '0'; 
+
+      if (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_NONE ||
+	  scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_8BIT ||
+	  scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_16BIT) {
+	payload_buffer[20] = '1';
+      }
+      else {
+	payload_buffer[20] = '3';
+      }
     
-    /* A safety net */
-    catch (...) {
-      std::cerr << "SickLMS1xx::_stopStreamingMeasurements: Unknown exception!!!" << std::endl;
-      throw;
-    }
+      payload_buffer[21] = ' ';
 
-    /* Success! */
-    if (disp_banner) {
-      std::cout << "\t\tStream stopped!" << std::endl;
-    }
+      /* Values should be 0 */
+      payload_buffer[22] = '0'; 
+      payload_buffer[23] = '0'; 
+      payload_buffer[24] = ' ';
+
+      /* Send remission values? */
+      if (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_NONE ||
+	  scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_NONE) {
+	payload_buffer[25] = '0';   // 0 = no, 1 = yes
+      }
+      else {
+	payload_buffer[25] = '1';   // 0 = no, 1 = yes
+      }
+      payload_buffer[26] = ' ';
     
-    _sick_streaming = false;
+      /* Remission resolution */
+      if (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_16BIT ||
+	  scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_16BIT) {
+	payload_buffer[27] = '1';   // 0 = 8bit, 1 = 16bit
+      }
+      else {
+	payload_buffer[27] = '0';   // 0 = 8bit, 1 = 16bit
+      }
+      payload_buffer[28] = ' ';
     
-  }
-
-  /**
-   * \brief Attempts to set and waits until device has in measuring status
-   * \param timeout_value Timeout value in usecs
-   */
-  void SickLMS1xx::_checkForMeasuringStatus( unsigned int timeout_value ) throw( SickTimeoutException, SickIOException ) {
+      /* Units (always 0) */
+      payload_buffer[29] = '0';
+      payload_buffer[30] = ' ';
+    
+      /* Encoder data? */
+      payload_buffer[31] = '0'; // (00 = no encode data, 01 = channel 1 encoder)
+      payload_buffer[32] = scan_data_cfg.send_encoder ? '1' : '0';
+      payload_buffer[33] = ' ';
 
-    /* Timeval structs for handling timeouts */
-    struct timeval beg_time, end_time;
+      /* These values should be 0 */
+      payload_buffer[34] = '0';
+      payload_buffer[35] = '0';
+      payload_buffer[36] = ' ';
 
-    /* Acquire the elapsed time since epoch */
-    gettimeofday(&beg_time,NULL);
-    
-    /* Get device status */
-    _updateSickStatus( );
+      /* Send position values? */
+      payload_buffer[37] = scan_data_cfg.send_position ? '1' : '0';  // (0 = no position, 1 = send position)
+      payload_buffer[38] = ' ';
 
-    /* Check the shared object */
-    bool first_pass = true;
-    while( _sick_device_status != SICK_LMS_1XX_STATUS_READY_FOR_MEASUREMENT ) {    
+      /* Send device name? */
+      payload_buffer[39] = scan_data_cfg.send_device_name ? '1' : '0';  // (0 = no, 1 = yes)
+      payload_buffer[40] = ' ';
 
-      if (first_pass) {
+      /* Send comment? */
+      payload_buffer[41] = scan_data_cfg.send_comment ? '1' : '0';  // (0 = no, 1 = yes)
+      payload_buffer[42] = ' ';
 
-	try {
-	  
-	  /* Tell the device to start measuring ! */
-	  _startMeasuring();
-	  first_pass = false;
-	  
-	}
-        
-	/* Handle a timeout! */
-	catch (SickTimeoutException &sick_timeout_exception) {
-	  std::cerr << sick_timeout_exception.what() << std::endl;
-	  throw;
-	}
-	
-	/* Handle write buffer exceptions */
-	catch (SickIOException &sick_io_exception) {
-	  std::cerr << sick_io_exception.what() << std::endl;
-	  throw;
-	}
-	
-	/* A safety net */
-	catch (...) {
-	  std::cerr << "SickLMS1xx::_checkForMeasuringStatus: Unknown exception!!!" << std::endl;
-	  throw;
-	}
-	
-      }
+      /* Send time info? */
+      payload_buffer[43] = scan_data_cfg.send_time ? '1' : '0';  // (0 = no, 1 = yes)
+      payload_buffer[44] = ' ';
 
-      /* Sleep a little bit */
-      usleep(1000);
+      /* Output interval */
+      std::string interval_str = int_to_str((int)scan_data_cfg.output_interval);
+      
+      payload_buffer[45] = '+';  // +1 = send all scans, +2 every second scan, etc
       
-      /* Check whether the allowed time has expired */
-      gettimeofday(&end_time,NULL);    
-      if (_computeElapsedTime(beg_time,end_time) > timeout_value) {
-    	throw SickTimeoutException("SickLMS1xx::_checkForMeasuringStatus: Timeout occurred!");
+      payload_length = 46;
+      for (unsigned int i = 0; i < interval_str.length(); payload_length++, i++) {
+	payload_buffer[payload_length] = (uint8_t)(interval_str.c_str())[i];
       }
 
-      /* Grab the latest device status */
-      _updateSickStatus();
-
     }
+    
+    /* Construct command message */
+    send_message.BuildMessage(payload_buffer,payload_length,_sick_protocol);
 
   }
-
+  
   /**
-   * Set device to output only range values
+   * \brief Sets the angular range of the measurements sent in each scan (the device is reinitialized)
+   * \param start_angle The angle of the first measurement to send (1/10000) deg
+   * \param stop_angle The angle of the last measurement to send (1/10000) deg
    */
-  void SickLMS1xx::_setSickScanDataFormat( const sick_lms_1xx_scan_format_t scan_format ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException ) {
-    
+  void SickLMS1xx::_setSickOutputRange( const int start_angle, const int stop_angle ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException ) {
+
     /* Allocate a single buffer for payload contents */
     uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
 
@@ -1805,95 +2779,83 @@ namespace SickToolbox {
     /* Set the command */
     payload_buffer[4]  = 'L';
     payload_buffer[5]  = 'M';
-    payload_buffer[6]  = 'D';
-    payload_buffer[7]  = 's';
-    payload_buffer[8]  = 'c';
-    payload_buffer[9]  = 'a';
-    payload_buffer[10] = 'n';
-    payload_buffer[11] = 'd';
-    payload_buffer[12] = 'a';
-    payload_buffer[13] = 't';
+    payload_buffer[6]  = 'P';
+    payload_buffer[7]  = 'o';
+    payload_buffer[8]  = 'u';
+    payload_buffer[9]  = 't';
+    payload_buffer[10] = 'p';
+    payload_buffer[11] = 'u';
+    payload_buffer[12] = 't';
+    payload_buffer[13] = 'R';
     payload_buffer[14] = 'a';
-    payload_buffer[15] = 'c';
-    payload_buffer[16] = 'f';
-    payload_buffer[17] = 'g';
+    payload_buffer[15] = 'n';
+    payload_buffer[16] = 'g';
+    payload_buffer[17] = 'e';
     payload_buffer[18] = ' ';
 
-    /* Specify the channel */
-    payload_buffer[19] = '0'; 
+    unsigned int idx = 19;
+    if (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) {
+
+      /* Number of segments (always 1), resolution, start and stop angles */
+      host_to_sick_lms_1xx_cola_b_uint16(1,&payload_buffer[19]);
+      host_to_sick_lms_1xx_cola_b_uint32((uint32_t)_sick_scan_config.sick_scan_res,&payload_buffer[21]);
+      host_to_sick_lms_1xx_cola_b_uint32((uint32_t)start_angle,&payload_buffer[25]);
+      host_to_sick_lms_1xx_cola_b_uint32((uint32_t)stop_angle,&payload_buffer[29]);
+      idx = 33;
 
-    if (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_NONE ||
-	scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_8BIT ||
-	scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_16BIT) {
-      payload_buffer[20] = '1';
     }
     else {
-      payload_buffer[20] = '3';
-    }
-    
-    payload_buffer[21] = ' ';
 
-    /* Values should be 0 */
-    payload_buffer[22] = '0'; 
-    payload_buffer[23] = '0'; 
-    payload_buffer[24] = ' ';
+      /* Number of segments (always 1) */
+      payload_buffer[19] = '+';
+      payload_buffer[20] = '1';
+      payload_buffer[21] = ' ';
 
-    /* Send remission values? */
-    if (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_NONE ||
-	scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_NONE) {
-      payload_buffer[25] = '0';   // 0 = no, 1 = yes
-    }
-    else {
-      payload_buffer[25] = '1';   // 0 = no, 1 = yes
-    }
-    payload_buffer[26] = ' ';
-    
-    /* Remission resolution */
-    if (scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_16BIT ||
-	scan_format == SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_16BIT) {
-      payload_buffer[27] = '1';   // 0 = 8bit, 1 = 16bit
-    }
-    else {
-      payload_buffer[27] = '0';   // 0 = 8bit, 1 = 16bit
-    }
-    payload_buffer[28] = ' ';
-    
-    /* Units (always 0) */
-    payload_buffer[29] = '0';
-    payload_buffer[30] = ' ';
-    
-    /* Encoder data? */
-    payload_buffer[31] = '0'; // (00 = no encode data, 01 = channel 1 encoder)
-    payload_buffer[32] = '0';
-    payload_buffer[33] = ' ';
+      /* Angular resolution (the current one) */
+      std::string res_str = int_to_str((int)_sick_scan_config.sick_scan_res);
+
+      idx = 22;
+      payload_buffer[idx] = '+';
+      idx++;
+      
+      for (unsigned int i = 0; i < res_str.length(); idx++, i++) {
+	payload_buffer[idx] = (uint8_t)(res_str.c_str())[i];
+      }
 
-    /* These values should be 0 */
-    payload_buffer[34] = '0';
-    payload_buffer[35] = '0';
-    payload_buffer[36] = ' ';
+      payload_buffer[idx] = ' ';
+      idx++;
+
+      /* Desired starting angle */
+      std::string start_angle_str = int_to_str(start_angle);
+
+      if (start_angle >= 0) {
+	payload_buffer[idx] = '+';
+	idx++;
+      }
 
-    /* Send position values? */
-    payload_buffer[37] = '0';  // (0 = no position, 1 = send position)
-    payload_buffer[38] = ' ';
+      for (unsigned int i = 0; i < start_angle_str.length(); idx++, i++) {
+	payload_buffer[idx] = (uint8_t)(start_angle_str.c_str())[i];
+      }
 
-    /* Send device name? */
-    payload_buffer[39] = '0';  // (0 = no, 1 = yes)
-    payload_buffer[40] = ' ';
+      payload_buffer[idx] = ' ';
+      idx++;
 
-    /* Send comment? */
-    payload_buffer[41] = '0';  // (0 = no, 1 = yes)
-    payload_buffer[42] = ' ';
+      /* Desired stopping angle */
+      std::string stop_angle_str = int_to_str(stop_angle);
 
-    /* Send time info? */
-    payload_buffer[43] = '0';  // (0 = no, 1 = yes)
-    payload_buffer[44] = ' ';
+      if (stop_angle >= 0) {
+	payload_buffer[idx] = '+';
+	idx++;
+      }
+    
+      for (unsigned int i = 0; i < stop_angle_str.length(); idx++, i++) {
+	payload_buffer[idx] = (uint8_t)(stop_angle_str.c_str())[i];
+      }
 
-    /* Send time info? */
-    payload_buffer[45] = '+';  // +1 = send all scans, +2 every second scan, etc
-    payload_buffer[46] = '1';
+    }
     
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,47);
+    SickLMS1xxMessage send_message(payload_buffer,idx,_sick_protocol);
 
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -1901,14 +2863,11 @@ namespace SickToolbox {
     try {
 
       /* Send message and get reply */      
-      _sendMessageAndGetReply(send_message, recv_message, "sWA", "LMDscandatacfg");
+      _sendMessageAndGetReply(send_message, recv_message, "sWA", "LMPoutputRange");
 
-      /* Reinitialize the Sick so it uses the requested format */
+      /* Reinitialize the Sick so it uses the requested range */
       _reinitialize();
 
-      /* Set the sick scan data format */
-      _sick_scan_format = scan_format;
-      
     }
         
     /* Handle a timeout! */
@@ -1936,7 +2895,7 @@ namespace SickToolbox {
     }
     
     catch (...) {
-      std::cerr << "SickLMS1xx::_setSickScanDataFormat: Unknown exception!!!" << std::endl;
+      std::cerr << "SickLMS1xx::_setSickOutputRange: Unknown exception!!!" << std::endl;
       throw;
     }
 
@@ -1964,7 +2923,7 @@ namespace SickToolbox {
     payload_buffer[6]  = 'n';
     
     /* Construct command message */
-    SickLMS1xxMessage send_message(payload_buffer,7);
+    SickLMS1xxMessage send_message(payload_buffer,7,_sick_protocol);
 
     /* Setup container for recv message */
     SickLMS1xxMessage recv_message;
@@ -1998,7 +2957,7 @@ namespace SickToolbox {
     recv_message.GetPayload(payload_buffer);
     
     /* Check return value */
-    if (payload_buffer[8] != '0') {
+    if (payload_buffer[8] != _encodeDigit(0)) {
       std::cerr << "SickLMS1xx::_restoreMeasuringMode: Unknown exception!!!" << std::endl;
       throw;
     }
@@ -2040,7 +2999,7 @@ namespace SickToolbox {
     try {
       
       /* Send a message using parent's method */
-      SickLIDAR< SickLMS1xxBufferMonitor, SickLMS1xxMessage >::_sendMessage(send_message,DEFAULT_SICK_LMS_1XX_BYTE_TIMEOUT);
+      SickLIDAR< SickLMS1xxBufferMonitor, SickLMS1xxMessage >::_sendMessage(send_message,DEFAULT_SICK_LMS_1XX_BYTE_INTERVAL);
       
     }
     
@@ -2082,7 +3041,7 @@ namespace SickToolbox {
     try {
 
       /* Send a message and get reply using parent's method */
-      SickLIDAR< SickLMS1xxBufferMonitor, SickLMS1xxMessage >::_sendMessageAndGetReply(send_message,recv_message,(uint8_t *)expected_str.c_str(),expected_str.length(),DEFAULT_SICK_LMS_1XX_BYTE_TIMEOUT,timeout_value,num_tries);
+      SickLIDAR< SickLMS1xxBufferMonitor, SickLMS1xxMessage >::_sendMessageAndGetReply(send_message,recv_message,(uint8_t *)expected_str.c_str(),expected_str.length(),DEFAULT_SICK_LMS_1XX_BYTE_INTERVAL,timeout_value,num_tries);
 
     }
     
@@ -2202,6 +3161,51 @@ namespace SickToolbox {
     
   }
 
+  /**
+   * \brief Decodes streamed scans and hands them to the subscribers
+   * \param &sick_message A message framed by the buffer monitor
+   * \param *handler_args The driver instance
+   * \return True if the message was consumed, False if it should be queued
+   */
+  bool SickLMS1xx::_scanMessageHandler( SickLMS1xxMessage &sick_message, void * handler_args ) {
+
+    SickLMS1xx *sick_lms = (SickLMS1xx *)handler_args;
+
+    /* Leave everything to the pull API unless somebody is listening */
+    if (!sick_lms->_sick_scan_subscribers.HasSubscribers()) {
+      return false;
+    }
+
+    /* Only streamed scans are of interest (replies are still queued) */
+    if (sick_message.GetCommandType() != "sSN" || sick_message.GetCommand() != "LMDscandata") {
+      return false;
+    }
+
+    try {
+
+      sick_lms->_parseSickScanMessage(sick_message,sick_lms->_sick_scan_data);
+      sick_lms->_sick_scan_subscribers.Dispatch(sick_lms->_sick_scan_data);
+
+    }
+
+    /* A malformed scan is dropped */
+    catch (SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+    }
+
+    /* Handle thread exceptions */
+    catch (SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+    }
+
+    catch (...) {
+      std::cerr << "SickLMS1xx::_scanMessageHandler: Unknown exception!!!" << std::endl;
+    }
+
+    return true;
+
+  }
+  
   /**
    * \brief Utility function for returning scan format as string
    * \param dist_opt Distance option corresponding to scan format
@@ -2230,65 +3234,43 @@ namespace SickToolbox {
   } 
 
   /**
-   * \brief Searches a string for a substring
-   * \param str String to be searched
-   * \param substr Substring being sought
-   * \param str_length String's length
-   * \param substr_length Substring's length
-   * \param substr_pos Reference holding the location in the main string where substr was found
-   * \param start_pos Index into main string to indicate where to start searching
-   * \return True if substring found, false otherwise
+   * \brief Utility function to map a channel name to its id
+   * \param *channel_name The name (e.g. "DIST1", needn't be NUL-terminated)
+   * \param name_length The length of the name
+   * \return The sick_lms_1xx_channel_id_t of the channel, or -1 if it isn't one we decode
    */
-  bool SickLMS1xx::_findSubString( const char * const str, const char * const substr,
-				   const unsigned int str_length, const unsigned int substr_length,
-				   unsigned int &substr_pos, unsigned int start_pos ) const {
-    
-    /* Init substring position */
-    substr_pos = 0;
-    
-    /* Look for the substring */
-    bool substr_found = false;
-    for (unsigned int i = start_pos; !substr_found && (i < (str_length - substr_length) + 1); i++) {
-      
-      unsigned int j = 0;
-      for (unsigned int k = i; (str[k] == substr[j]) && (j < substr_length); k++, j++);
-      
-      if (j == substr_length) {
-	substr_found = true;
-	substr_pos = i;
-      }
-      
+  int SickLMS1xx::_channelNameToId( const char * const channel_name, const unsigned int name_length ) const {
+
+    /* DIST1, DIST2, RSSI1 or RSSI2 */
+    if (name_length != 5 || (channel_name[4] != '1' && channel_name[4] != '2')) {
+      return -1;
     }
-    
-    /* Found! */
-    return substr_found;
-    
+
+    const int pulse = channel_name[4] - '1';
+    if (strncmp(channel_name,"DIST",4) == 0) {
+      return SICK_LMS_1XX_CHANNEL_DIST_1 + pulse;
+    }
+
+    if (strncmp(channel_name,"RSSI",4) == 0) {
+      return SICK_LMS_1XX_CHANNEL_RSSI_1 + pulse;
+    }
+
+    return -1;
+
   }
 
   /**
-   * \brief Utility function for converting next token into unsigned int
-   * \param str_buffer Source (c-string) buffer
-   * \param next_token Pointer to the next string token
-   * \param delimeter Token delimiter (default is " ")
-   * \returns Unsigned integer corresponding to numeric string token value
+   * \brief Utility function for extracting the next hex field of a CoLa-A telegram
+   * \param *&str_pos Where to start looking (advanced past the field)
+   * \param *str_end One past the last character of the telegram
+   * \param &num_val Set to the value of the field
    */
-  char * SickLMS1xx::_convertNextTokenToUInt( char * const str_buffer, unsigned int & num_val,
-					      const char * const delimeter ) const {
+  void SickLMS1xx::_convertNextTokenToUInt( const char * &str_pos, const char * const str_end, unsigned int & num_val ) const throw ( SickIOException ) {
 
-    const char * token = NULL;
-    uint32_t curr_val = 0;
-    if ((token = strtok(str_buffer,delimeter)) == NULL) {
-      throw SickIOException("SickLMS1xx::_getextTokenAsUInt: strtok() failed!");
+    if (!sick_lms_1xx_next_hex_field(str_pos,str_end,num_val)) {
+      throw SickIOException("SickLMS1xx::_convertNextTokenToUInt: Missing or malformed field!");
     }
 
-    if (sscanf(token,"%x",&curr_val) == EOF) {
-      throw SickIOException("SickLMS1xx::_getNextTokenAsUInt: sscanf() failed!");
-    }
-
-    num_val = (unsigned int)sick_lms_1xx_to_host_byte_order(curr_val);
-    
-    return str_buffer + strlen(token) + 1;
-    
   }
   
 } //namespace SickToolbox
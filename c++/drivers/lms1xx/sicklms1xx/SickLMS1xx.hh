@@ -21,6 +21,7 @@
 #define DEFAULT_SICK_LMS_1XX_IP_ADDRESS                   "192.168.0.1"                 ///< Default IP Address
 #define DEFAULT_SICK_LMS_1XX_TCP_PORT                            (2111)                 ///< Sick LMS 1xx TCP/IP Port
 #define DEFAULT_SICK_LMS_1XX_CONNECT_TIMEOUT                  (1000000)                 ///< Max time for establishing connection (usecs)
+#define DEFAULT_SICK_LMS_1XX_BYTE_INTERVAL                          (0)                 ///< Time between transmitted bytes (usecs, zero sends whole frames)
 #define DEFAULT_SICK_LMS_1XX_MESSAGE_TIMEOUT                  (5000000)                 ///< Max time for reply (usecs)
 #define DEFAULT_SICK_LMS_1XX_STATUS_TIMEOUT                  (60000000)                 ///< Max time it should take to change status  
 
@@ -29,11 +30,13 @@
 
 /* Definition dependencies */
 #include <string>
+#include <time.h>
 #include <arpa/inet.h>
 
 #include "SickLIDAR.hh"
 #include "SickLMS1xxBufferMonitor.hh"
 #include "SickLMS1xxMessage.hh"
+#include "SickSubscriberList.hh"
 #include "SickException.hh"
 
 /**
@@ -52,6 +55,7 @@ namespace SickToolbox {
   public:
     
     static const int SICK_LMS_1XX_MAX_NUM_MEASUREMENTS = 1082;                         ///< LMS 1xx max number of measurements
+    static const unsigned int SICK_LMS_1XX_TELEGRAM_COUNTER_MODULUS = 65536;           ///< LMS 1xx telegram counter wraps at 16 bits
 
     /*!
      * \enum sick_lms_1xx_status_t 
@@ -114,9 +118,138 @@ namespace SickToolbox {
 
     };
 
+    /*!
+     * \struct sick_lms_1xx_scan_data_cfg_tag
+     * \brief A structure for aggregating what the Sick LMS 1xx
+     *        includes in each LMDscandata telegram.
+     */
+    /*!
+     * \typedef sick_lms_1xx_scan_data_cfg_t
+     * \brief Adopt c-style convention
+     */
+    typedef struct sick_lms_1xx_scan_data_cfg_tag {
+      sick_lms_1xx_scan_format_t scan_format;                                           ///< Range/reflectivity channels (and reflectivity resolution)
+      bool send_encoder;                                                                ///< Include encoder 1 position and speed
+      bool send_position;                                                               ///< Include the device position block
+      bool send_device_name;                                                            ///< Include the device name
+      bool send_comment;                                                                ///< Include the comment
+      bool send_time;                                                                   ///< Include the device's time stamp
+      unsigned int output_interval;                                                     ///< Send every Nth scan (1 sends every scan)
+    } sick_lms_1xx_scan_data_cfg_t;
+
+    /*!
+     * \enum sick_lms_1xx_channel_id_t
+     * \brief Indexes the data channels an LMDscandata telegram may carry
+     */
+    enum sick_lms_1xx_channel_id_t {
+
+      SICK_LMS_1XX_CHANNEL_DIST_1 = 0x00,                                               ///< First pulse range
+      SICK_LMS_1XX_CHANNEL_DIST_2 = 0x01,                                               ///< Second pulse range
+      SICK_LMS_1XX_CHANNEL_RSSI_1 = 0x02,                                               ///< First pulse reflectivity
+      SICK_LMS_1XX_CHANNEL_RSSI_2 = 0x03,                                               ///< Second pulse reflectivity
+      SICK_LMS_1XX_NUM_CHANNELS = 0x04                                                  ///< Number of channels
+
+    };
+
+    /*!
+     * \struct sick_lms_1xx_channel_info_tag
+     * \brief A structure for aggregating the description of a data channel
+     */
+    /*!
+     * \typedef sick_lms_1xx_channel_info_t
+     * \brief Adopt c-style convention
+     */
+    typedef struct sick_lms_1xx_channel_info_tag {
+      bool present;                                                                     ///< Whether the telegram carried the channel
+      float scale_factor;                                                               ///< Scale factor of the values
+      float scale_offset;                                                               ///< Offset of the values
+      int32_t start_angle;                                                              ///< Angle of the first value (1/10000) deg
+      unsigned int angular_step;                                                        ///< Angle between values (1/10000) deg
+      unsigned int num_vals;                                                            ///< Number of values
+    } sick_lms_1xx_channel_info_t;
+
+    /*!
+     * \struct sick_lms_1xx_scan_telegram_tag
+     * \brief A structure for aggregating everything but the values
+     *        of a decoded LMDscandata telegram (counters, timestamps,
+     *        encoder data and a description of each data channel)
+     */
+    /*!
+     * \typedef sick_lms_1xx_scan_telegram_t
+     * \brief Adopt c-style convention
+     */
+    typedef struct sick_lms_1xx_scan_telegram_tag {
+      unsigned int version;                                                             ///< Telegram version
+      unsigned int device_number;                                                       ///< Device number
+      unsigned int serial_number;                                                       ///< Device serial number
+      unsigned int device_status[2];                                                    ///< Device status
+      unsigned int telegram_counter;                                                    ///< Telegrams sent since power-up
+      unsigned int scan_counter;                                                        ///< Scans taken since power-up
+      unsigned int time_since_startup;                                                  ///< When the scan started (usecs since power-up)
+      unsigned int time_of_transmission;                                                ///< When the telegram was sent (usecs since power-up)
+      unsigned int input_status[2];                                                     ///< Digital input status
+      unsigned int output_status[2];                                                    ///< Digital output status
+      unsigned int scan_freq;                                                           ///< Scan frequency (1/100 Hz)
+      unsigned int measurement_freq;                                                    ///< Time between measurements (100 usecs)
+      unsigned int num_encoders;                                                        ///< Number of encoders
+      unsigned int encoder_position;                                                    ///< First encoder's position (ticks)
+      unsigned int encoder_speed;                                                       ///< First encoder's speed (ticks/mm)
+      sick_lms_1xx_channel_info_t channels[SICK_LMS_1XX_NUM_CHANNELS];                 ///< The data channels (indexed by sick_lms_1xx_channel_id_t)
+      unsigned int num_scans_lost;                                                      ///< Telegrams missed just before this one (per the telegram counter)
+    } sick_lms_1xx_scan_telegram_t;
+
+    /*!
+     * \struct sick_lms_1xx_scan_data_tag
+     * \brief A structure for aggregating a single decoded
+     *        Sick LMS 1xx scan.
+     */
+    /*!
+     * \typedef sick_lms_1xx_scan_data_t
+     * \brief Adopt c-style convention
+     */
+    typedef struct sick_lms_1xx_scan_data_tag {
+      unsigned int range_1_vals[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                   ///< First pulse range measurements
+      unsigned int range_2_vals[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                   ///< Second pulse range measurements (zero if not streamed)
+      unsigned int reflect_1_vals[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                 ///< First pulse reflectivity (zero if not streamed)
+      unsigned int reflect_2_vals[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                 ///< Second pulse reflectivity (zero if not streamed)
+      unsigned int num_measurements;                                                   ///< Number of measurements in the scan
+      unsigned int dev_status;                                                         ///< Device status
+      struct timespec arrival_time;                                                    ///< When the first byte of the scan arrived (CLOCK_REALTIME)
+      sick_lms_1xx_scan_telegram_t scan_telegram;                                      ///< Counters, timestamps and encoder data carried w/ the scan
+      bool metric_valid;                                                               ///< Whether the metric fields below were filled (see SetSickMetricOutput)
+      bool points_valid;                                                               ///< Whether the beam table matched the scan (beam_index, x_1_vals and y_1_vals are set)
+      unsigned int beam_index;                                                         ///< Index of the first measurement in the beam table
+      float range_1_meters[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                        ///< First pulse range (m, zero if not streamed)
+      float range_2_meters[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                        ///< Second pulse range (m, zero if not streamed)
+      float x_1_vals[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                              ///< First pulse point along the 0 deg axis (m)
+      float y_1_vals[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                              ///< First pulse point along the 90 deg axis (m)
+    } sick_lms_1xx_scan_data_t;
+
+    /*!
+     * \struct sick_lms_1xx_beam_table_tag
+     * \brief A structure for aggregating the angle (and its
+     *        cosine and sine) of every beam in the scan area.
+     */
+    /*!
+     * \typedef sick_lms_1xx_beam_table_t
+     * \brief Adopt c-style convention
+     */
+    typedef struct sick_lms_1xx_beam_table_tag {
+      int32_t start_angle;                                                             ///< Angle of the first beam (1/10000) deg
+      unsigned int angular_step;                                                       ///< Angle between beams (1/10000) deg
+      unsigned int num_beams;                                                          ///< Number of beams in the scan area
+      float angles[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                                ///< Beam angles (rad)
+      float cos_vals[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                              ///< Cosines of the beam angles
+      float sin_vals[SICK_LMS_1XX_MAX_NUM_MEASUREMENTS];                              ///< Sines of the beam angles
+    } sick_lms_1xx_beam_table_t;
+
+    /** Called w/ each scan decoded by the driver */
+    typedef SickSubscriberList< sick_lms_1xx_scan_data_t >::callback_t sick_lms_1xx_scan_callback_t;
+
     /** Primary constructor */
     SickLMS1xx( const std::string sick_ip_address = DEFAULT_SICK_LMS_1XX_IP_ADDRESS,
-		const uint16_t sick_tcp_port = DEFAULT_SICK_LMS_1XX_TCP_PORT );
+		const uint16_t sick_tcp_port = DEFAULT_SICK_LMS_1XX_TCP_PORT,
+		const sick_lms_1xx_protocol_t sick_protocol = SICK_LMS_1XX_PROTOCOL_COLA_A );
     
     /** Initializes the Sick LD unit (use scan areas defined in flash) */
     void Initialize( const bool disp_banner = true ) throw( SickIOException, SickThreadException, SickTimeoutException, SickErrorException );
@@ -139,6 +272,15 @@ namespace SickToolbox {
 
     /** Sets the sick scan data format */
     void SetSickScanDataFormat( const sick_lms_1xx_scan_format_t scan_format ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException );
+
+    /** Sets everything the Sick includes in a scan telegram (channels, optional blocks and output interval) */
+    void SetSickScanDataConfig( const sick_lms_1xx_scan_data_cfg_t &scan_data_cfg ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException, SickConfigException );
+
+    /** Gets what the Sick was last told to include in a scan telegram */
+    sick_lms_1xx_scan_data_cfg_t GetSickScanDataConfig( ) const { return _sick_scan_data_cfg; }
+
+    /** Restricts the measurements sent in each scan to the given angular range (deg) */
+    void SetSickOutputRange( const double start_angle, const double stop_angle ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException, SickConfigException );
     
     /** Get the Sick Range Measurements */
     void GetSickMeasurements( unsigned int * const range_1_vals,
@@ -146,7 +288,25 @@ namespace SickToolbox {
 			      unsigned int * const reflect_1_vals,
 			      unsigned int * const reflect_2_vals,
 			      unsigned int & num_measurements,
-			      unsigned int * const dev_status = NULL ) throw ( SickIOException, SickConfigException, SickTimeoutException );
+			      unsigned int * const dev_status = NULL,
+			      struct timespec * const arrival_time = NULL,
+			      sick_lms_1xx_scan_telegram_t * const scan_telegram = NULL ) throw ( SickIOException, SickConfigException, SickTimeoutException );
+
+    /** Get the next scan in its entirety (whatever channels are being streamed, plus counters, timestamps and encoder data) */
+    void GetSickScan( sick_lms_1xx_scan_data_t &sick_scan ) throw ( SickIOException, SickConfigException, SickTimeoutException );
+
+    /** Whether GetSickScan and the scan callbacks also fill in ranges (m) and points (m) */
+    void SetSickMetricOutput( const bool metric_output ) { _sick_metric_output = metric_output; }
+
+    /** Gets the angle, cosine and sine of every beam in the current scan area */
+    void GetSickBeamTable( sick_lms_1xx_beam_table_t &beam_table ) const throw ( SickIOException );
+
+    /** Registers a callback to receive each scan as soon as it is decoded (starts the data stream) */
+    unsigned int RegisterSickScanCallback( const sick_lms_1xx_scan_callback_t scan_callback, void * const callback_args = NULL )
+      throw( SickIOException, SickConfigException, SickTimeoutException, SickThreadException );
+
+    /** Unregisters a scan callback */
+    void UnregisterSickScanCallback( const unsigned int callback_id ) throw( SickThreadException );
 
     /** Uninitializes the Sick LD unit */
     void Uninitialize( const bool disp_banner = true ) throw( SickIOException, SickTimeoutException, SickErrorException, SickThreadException );
@@ -166,7 +326,7 @@ namespace SickToolbox {
     /** Destructor */
     ~SickLMS1xx();
 
-  private:
+  protected:
 
     /*!
      * \struct sick_lms_1xx_scan_config_tag
@@ -183,21 +343,24 @@ namespace SickToolbox {
       int32_t sick_start_angle;                                                         ///< Sick scan area start angle
       int32_t sick_stop_angle;                                                          ///< Sick scan area stop angle
     } sick_lms_1xx_scan_config_t;
-    
+
     /** The Sick LMS 1xx IP address */
     std::string _sick_ip_address;
 
     /** The Sick LMS 1xx TCP port number */
     uint16_t _sick_tcp_port;
 
+    /** The telegram encoding spoken w/ the Sick LMS 1xx */
+    sick_lms_1xx_protocol_t _sick_protocol;
+
     /** Sick LMS 1xx socket address struct */
     struct sockaddr_in _sick_inet_address_info;
 
     /** Sick LMS 1xx configuration struct */
     sick_lms_1xx_scan_config_t _sick_scan_config;
 
-    /** Sick LMS 1xx current scan data format */
-    sick_lms_1xx_scan_format_t _sick_scan_format;    
+    /** Sick LMS 1xx current scan data format and options */
+    sick_lms_1xx_scan_data_cfg_t _sick_scan_data_cfg;
     
     /** Sick LMS 1xx configuration struct */
     sick_lms_1xx_status_t _sick_device_status;
@@ -207,6 +370,18 @@ namespace SickToolbox {
     
     /** Sick LMS 1xx streaming status */
     bool _sick_streaming;
+
+    /** Callbacks subscribed to the scan stream */
+    SickSubscriberList< sick_lms_1xx_scan_data_t > _sick_scan_subscribers;
+
+    /** Scan decoded for the subscribers (only touched by the monitor) */
+    sick_lms_1xx_scan_data_t _sick_scan_data;
+
+    /** Whether decoded scans are also converted to meters */
+    volatile bool _sick_metric_output;
+
+    /** Beam angles for the current scan area (only rebuilt when the scan config changes) */
+    sick_lms_1xx_beam_table_t _sick_beam_table;
     
     /** Setup the connection parameters and establish TCP connection! */
     void _setupConnection( ) throw( SickIOException, SickTimeoutException );
@@ -217,12 +392,27 @@ namespace SickToolbox {
     /** Teardown the connection to the Sick LD */
     void _teardownConnection( ) throw( SickIOException );
 
+    /** Reads the scan config and status, and logs in (all in a single round trip) */
+    void _syncWithSick( ) throw( SickTimeoutException, SickErrorException, SickIOException );
+
     /** Acquire the latest Sick LMS's status */
     void _updateSickStatus( ) throw( SickTimeoutException, SickIOException );
 
+    /** Builds the request for the Sick LMS's status */
+    void _buildSickStatusRequest( SickLMS1xxMessage &send_message ) const;
+
+    /** Adopts the status reported by the Sick LMS */
+    void _parseSickStatusReply( const SickLMS1xxMessage &recv_message );
+
     /** Acquire the Sick LMS's scan config */
     void _getSickScanConfig( ) throw( SickTimeoutException, SickIOException );
 
+    /** Builds the request for the Sick LMS's scan config */
+    void _buildSickScanConfigRequest( SickLMS1xxMessage &send_message ) const;
+
+    /** Adopts the scan config reported by the Sick LMS */
+    void _parseSickScanConfigReply( const SickLMS1xxMessage &recv_message ) throw( SickIOException );
+
     /** Sets the scan configuration (volatile, does not write to EEPROM) */
     void _setSickScanConfig( const sick_lms_1xx_scan_freq_t scan_freq,
 			     const sick_lms_1xx_scan_res_t scan_res,
@@ -231,6 +421,12 @@ namespace SickToolbox {
     /** Set access mode for configuring device */
     void _setAuthorizedClientAccessMode( ) throw( SickTimeoutException, SickErrorException, SickIOException );
 
+    /** Builds the request for logging in as an authorized client */
+    void _buildAccessModeRequest( SickLMS1xxMessage &send_message ) const;
+
+    /** Checks the reply to the request for logging in as an authorized client */
+    void _checkAccessModeReply( const SickLMS1xxMessage &recv_message ) const throw( SickErrorException );
+
     /** Save configuration parameters to EEPROM */
     void _writeToEEPROM( ) throw( SickTimeoutException, SickIOException );
 
@@ -245,29 +441,85 @@ namespace SickToolbox {
 				  const unsigned int timeout_value = DEFAULT_SICK_LMS_1XX_MESSAGE_TIMEOUT,
 				  const unsigned int num_tries = 1 ) throw( SickIOException, SickTimeoutException );
 
+    /** Points a pending reply (to a pipelined request) at its expected "<type> <command>" string and destination */
+    void _setPendingReply( sick_pending_reply_t &pending_reply, const std::string &reply_str, SickLMS1xxMessage &recv_message ) const {
+      pending_reply.byte_sequence = (const uint8_t *)reply_str.c_str();
+      pending_reply.byte_sequence_length = reply_str.length();
+      pending_reply.recv_message = &recv_message;
+    }
+
     /** Receive a message */
     void _recvMessage( SickLMS1xxMessage &sick_message ) const throw ( SickTimeoutException );
+
+    /** Decodes a streamed scan message */
+    void _parseSickScanMessage( const SickLMS1xxMessage &recv_message,
+				unsigned int * const range_1_vals,
+				unsigned int * const range_2_vals,
+				unsigned int * const reflect_1_vals,
+				unsigned int * const reflect_2_vals,
+				unsigned int & num_measurements,
+				unsigned int * const dev_status,
+				sick_lms_1xx_scan_telegram_t * const scan_telegram,
+				const bool warn_if_missing = true ) const throw ( SickIOException );
+
+    /** Decodes a streamed scan message into a scan data struct (channels that aren't streamed are zeroed) */
+    void _parseSickScanMessage( const SickLMS1xxMessage &recv_message,
+				sick_lms_1xx_scan_data_t &sick_scan ) const throw ( SickIOException );
+
+    /** Fills in the metric fields of a decoded scan */
+    void _convertSickScanToMetric( sick_lms_1xx_scan_data_t &sick_scan ) const;
+
+    /** Rebuilds the beam table if the scan area has changed */
+    void _updateSickBeamTable( );
+
+    /** Waits for the next streamed scan message (starting the stream if need be) */
+    void _recvScanMessage( SickLMS1xxMessage &recv_message ) throw ( SickIOException, SickConfigException, SickTimeoutException );
+
+    /** Decodes a CoLa-A LMDscandata telegram in a single pass */
+    void _decodeColaAScanTelegram( const SickLMS1xxMessage &recv_message,
+				   unsigned int * const channel_vals[SICK_LMS_1XX_NUM_CHANNELS],
+				   sick_lms_1xx_scan_telegram_t &scan_telegram ) const throw ( SickIOException );
+
+    /** Decodes a CoLa-B LMDscandata telegram in a single pass */
+    void _decodeColaBScanTelegram( const SickLMS1xxMessage &recv_message,
+				   unsigned int * const channel_vals[SICK_LMS_1XX_NUM_CHANNELS],
+				   sick_lms_1xx_scan_telegram_t &scan_telegram ) const throw ( SickIOException );
+
+    /** Hands streamed scans to the subscribers (called by the buffer monitor) */
+    static bool _scanMessageHandler( SickLMS1xxMessage &sick_message, void * handler_args );
     
     /** Start device measuring */
     void _startMeasuring( ) throw ( SickTimeoutException, SickIOException );
 
+    /** Builds the request to start measuring */
+    void _buildStartMeasuringRequest( SickLMS1xxMessage &send_message ) const;
+
+    /** Checks the reply to the request to start measuring */
+    void _checkStartMeasuringReply( const SickLMS1xxMessage &recv_message ) const throw( SickConfigException );
+
     /** Stop device measuring */
     void _stopMeasuring( ) throw ( SickTimeoutException, SickIOException );
 
     /** Request a data data stream type */
     void _requestDataStream( ) throw ( SickTimeoutException, SickConfigException, SickIOException );
     
-    /** Start streaming measurements */
-    void _startStreamingMeasurements(  )throw( SickTimeoutException, SickIOException );
+    /** Start measuring and streaming (returns once the first scan arrives) */
+    void _startStreamingMeasurements(  )throw( SickTimeoutException, SickConfigException, SickIOException );
 
     /** Stop streaming measurements */
     void _stopStreamingMeasurements( const bool disp_banner = true ) throw( SickTimeoutException, SickIOException );
 
-    /** Set device to measuring mode */
-    void _checkForMeasuringStatus( unsigned int timeout_value = DEFAULT_SICK_LMS_1XX_STATUS_TIMEOUT ) throw( SickTimeoutException, SickIOException );
+    /** Builds the request subscribing to (or unsubscribing from) the scan data */
+    void _buildDataStreamRequest( SickLMS1xxMessage &send_message, const bool stream ) const;
 
-    /** Sets the sick scan data format */
-    void _setSickScanDataFormat( const sick_lms_1xx_scan_format_t scan_format ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException );
+    /** Sets the sick scan data format and options */
+    void _setSickScanDataConfig( const sick_lms_1xx_scan_data_cfg_t &scan_data_cfg ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException );
+
+    /** Builds the request setting the scan data format and options */
+    void _buildScanDataConfigRequest( SickLMS1xxMessage &send_message, const sick_lms_1xx_scan_data_cfg_t &scan_data_cfg ) const;
+
+    /** Sets the angular range of the measurements sent in each scan */
+    void _setSickOutputRange( const int start_angle, const int stop_angle ) throw( SickTimeoutException, SickIOException, SickThreadException, SickErrorException );
     
     /** Restore device to measuring mode */
     void _restoreMeasuringMode( ) throw( SickTimeoutException, SickIOException );
@@ -287,21 +539,26 @@ namespace SickToolbox {
     /** Utility function for returning scan format as string */
     std::string _sickScanDataFormatToString( const sick_lms_1xx_scan_format_t scan_format ) const;
 
+    /** Utility function for encoding a single-digit argument/result in the selected protocol */
+    uint8_t _encodeDigit( const uint8_t digit ) const { return (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) ? digit : '0' + digit; }
+
     /** Utility function for converting sick freq to doubles */
     double _convertSickAngleUnitsToDegs( const int sick_angle ) const { return ((double)sick_angle)/10000; }
 
+    /** Utility function for converting degrees to sick angle units (1/10000 deg) */
+    int _convertDegsToSickAngleUnits( const double angle ) const { return (int)((angle < 0) ? angle*10000 - 0.5 : angle*10000 + 0.5); }
+
     /** Utility function for converting sick Hz values ints */
     unsigned int  _convertSickFreqUnitsToHz( const unsigned int sick_freq ) const { return (unsigned int)(((double)sick_freq)/100); }    
     
     /** Utility function to convert config error int to str */
     std::string _intToSickConfigErrorStr( const int error ) const;
 
-    /** Utility function to locate substring in string */
-    bool _findSubString( const char * const str, const char * const substr, const unsigned int str_length, const unsigned int substr_length,
-			 unsigned int &substr_pos, unsigned int start_pos = 0 ) const;
+    /** Utility function to map a channel name (e.g. "DIST1") to its id */
+    int _channelNameToId( const char * const channel_name, const unsigned int name_length ) const;
 
-    /** Utility function for extracting next integer from tokenized string */
-    char * _convertNextTokenToUInt( char * const str_buffer, unsigned int & num_val, const char * const delimeter = " " ) const;
+    /** Utility function for extracting the next hex field of a CoLa-A telegram */
+    void _convertNextTokenToUInt( const char * &str_pos, const char * const str_end, unsigned int & num_val ) const throw ( SickIOException );
     
   };
 
@@ -329,6 +586,24 @@ namespace SickToolbox {
    */
   typedef SickLMS1xx::sick_lms_1xx_scan_res_t sick_lms_1xx_scan_res_t;  
 
+  /*!
+   * \typedef sick_lms_1xx_scan_data_t
+   * \brief Makes working w/ SickLMS1xx::sick_lms_1xx_scan_data_t a bit easier
+   */
+  typedef SickLMS1xx::sick_lms_1xx_scan_data_t sick_lms_1xx_scan_data_t;
+
+  /*!
+   * \typedef sick_lms_1xx_scan_telegram_t
+   * \brief Makes working w/ SickLMS1xx::sick_lms_1xx_scan_telegram_t a bit easier
+   */
+  typedef SickLMS1xx::sick_lms_1xx_scan_telegram_t sick_lms_1xx_scan_telegram_t;
+
+  /*!
+   * \typedef sick_lms_1xx_scan_data_cfg_t
+   * \brief Makes working w/ SickLMS1xx::sick_lms_1xx_scan_data_cfg_t a bit easier
+   */
+  typedef SickLMS1xx::sick_lms_1xx_scan_data_cfg_t sick_lms_1xx_scan_data_cfg_t;
+
   
 } //namespace SickToolbox
   
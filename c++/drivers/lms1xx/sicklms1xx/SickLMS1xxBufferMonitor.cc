@@ -19,7 +19,7 @@
 
 /* Implementation dependencies */
 #include <iostream>
-#include <sys/ioctl.h>
+#include <string.h>
 
 #include "SickLMS1xxBufferMonitor.hh"
 #include "SickLMS1xxMessage.hh"
@@ -32,49 +32,30 @@ namespace SickToolbox {
   /**
    * \brief A standard constructor
    */
-  SickLMS1xxBufferMonitor::SickLMS1xxBufferMonitor( ) : SickBufferMonitor< SickLMS1xxBufferMonitor, SickLMS1xxMessage >(this) { }
+  SickLMS1xxBufferMonitor::SickLMS1xxBufferMonitor( ) : SickBufferMonitor< SickLMS1xxBufferMonitor, SickLMS1xxMessage >(this),
+							 _sick_protocol(SICK_LMS_1XX_PROTOCOL_COLA_A),
+							 _frame_in_progress(false), _frame_length(0) { }
 
   /**
    * \brief Acquires the next message from the SickLMS1xx byte stream
    * \param &sick_message The returned message object
+   *
+   * NOTE: Bytes queued on the stream are never thrown away, so telegrams
+   *       that pile up while the consumer stalls (or a command is being
+   *       serviced) are all framed. Consumers preferring freshness over
+   *       completeness can skip ahead w/ SickLIDAR::SetSickSkipToLatest.
    */
   void SickLMS1xxBufferMonitor::GetNextMessageFromDataStream( SickLMS1xxMessage &sick_message ) throw( SickIOException ) {
 
-    /* Flush the input buffer */
-    uint8_t byte_buffer = 0;
-    uint8_t payload_buffer[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
     try {
 
-      /* Flush the TCP receive buffer */
-      _flushTCPRecvBuffer();
-
-      /* Search for STX in the byte stream */
-      do {
-	
- 	/* Grab the next byte from the stream */
- 	_readBytes(&byte_buffer,1,DEFAULT_SICK_LMS_1XX_BYTE_TIMEOUT);
-	
-      }
-      while (byte_buffer != 0x02);
-      
-      /* Ok, now acquire the payload! (until ETX) */
-      int payload_length = 0;
-      do {
-	
-	payload_length++;
- 	_readBytes(&payload_buffer[payload_length-1],1,DEFAULT_SICK_LMS_1XX_BYTE_TIMEOUT);
-	
+      /* Binary telegrams are framed by length rather than by ETX */
+      if (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) {
+	_getNextColaBMessageFromDataStream(sick_message);
+	return;
       }
-      while (payload_buffer[payload_length-1] != 0x03);
-      payload_length--;
-      
-      /* Build the return message object based upon the received payload
-       * NOTE: In constructing this message we ignore the header bytes
-       *       buffered since the BuildMessage routine will insert the
-       *       correct header automatically and verify the message size
-       */
-      sick_message.BuildMessage(payload_buffer,payload_length);
+
+      _getNextColaAMessageFromDataStream(sick_message);
 
       /* Success */
       
@@ -95,30 +76,208 @@ namespace SickToolbox {
   }
 
   /**
-   * \brief Flushes TCP receive buffer contents
+   * \brief Acquires the next CoLa-A (STX...ETX) message from the SickLMS1xx byte stream
+   * \param &sick_message The returned message object
+   *
+   * NOTE: The telegram is assembled in the monitor's frame buffer, so a
+   *       timeout partway through leaves it to be finished by the next
+   *       call. An STX turning up mid-telegram means the rest of it was
+   *       lost, so assembly restarts from there. (A reactor rewinds the
+   *       receive buffer itself, so in that case we always start afresh.)
    */
-  void SickLMS1xxBufferMonitor::_flushTCPRecvBuffer( ) const throw (SickIOException) {
+  void SickLMS1xxBufferMonitor::_getNextColaAMessageFromDataStream( SickLMS1xxMessage &sick_message ) throw( SickTimeoutException, SickIOException ) {
+
+    unsigned int num_bytes_read = 0;
     
-    char null_byte;
-    int num_bytes_waiting = 0;    
+    if (_isReactorDriven()) {
+      _resetFrame();
+    }
+
+    /* Search for STX in the byte stream (junk is discarded a chunk at a time) */
+    while (!_frame_in_progress) {
+
+      _readBytesUntil(_frame_buffer,SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH,0x02,num_bytes_read,DEFAULT_SICK_LMS_1XX_FRAME_TIMEOUT);
+      _frame_in_progress = (_frame_buffer[num_bytes_read-1] == 0x02);
 
-    /* Acquire number of awaiting bytes */
-    if (ioctl(_sick_fd,FIONREAD,&num_bytes_waiting)) {
-      throw SickIOException("SickLMS1xxBufferMonitor::_flushTCPRecvBuffer: ioctl() failed!");
     }
-    
-    /* Flush awaiting bytes */
-    for (int i = 0; i < num_bytes_waiting; i++) {
-      
-      /* Capture a single byte from the stream! */
-      if (read(_sick_fd,&null_byte,1) != 1) {
-	throw SickIOException("SickLMS1xxBufferMonitor::_flushTCPRecvBuffer: ioctl() failed!");
-      }	  
+
+    /* Ok, now acquire the payload! (until ETX) */
+    for (;;) {
+
+      try {
+	_readBytesUntil(&_frame_buffer[_frame_length],SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH - _frame_length,
+			0x03,num_bytes_read,DEFAULT_SICK_LMS_1XX_FRAME_TIMEOUT);
+      }
+
+      /* Hang on to whatever made it */
+      catch(SickTimeoutException &sick_timeout) {
+	_appendToFrame(num_bytes_read);
+	throw;
+      }
+
+      _appendToFrame(num_bytes_read);
+
+      /* Got the whole thing? */
+      if (_frame_length > 0 && _frame_buffer[_frame_length-1] == 0x03) {
+	break;
+      }
+
+      /* Make sure the frame fits the message */
+      if (_frame_length == SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH) {
+	std::cerr << "SickLMS1xxBufferMonitor::GetNextMessageFromDataStream: Frame too long! (Discarding)" << std::endl;
+	_resetFrame();
+	return;
+      }
       
     }
+
+    /* Build the return message object based upon the received payload
+     * NOTE: In constructing this message we ignore the header bytes
+     *       buffered since the BuildMessage routine will insert the
+     *       correct header automatically and verify the message size
+     */
+    sick_message.BuildMessage(_frame_buffer,_frame_length-1);
+    _resetFrame();
+
+  }
+
+  /**
+   * \brief Appends bytes just read into the frame buffer to the telegram being assembled
+   * \param num_bytes The number of bytes read (starting at _frame_buffer[_frame_length])
+   *
+   * NOTE: STX never appears inside a CoLa-A telegram, so one turning up
+   *       means the stream resynchronized on a new telegram. Whatever
+   *       preceded it is discarded.
+   */
+  void SickLMS1xxBufferMonitor::_appendToFrame( const unsigned int num_bytes ) {
+
+    uint8_t * const new_bytes = &_frame_buffer[_frame_length];
+
+    /* Look for the last STX among the new bytes */
+    for (unsigned int i = num_bytes; i > 0; i--) {
+
+      if (new_bytes[i-1] == 0x02) {
+	std::cerr << "SickLMS1xxBufferMonitor::GetNextMessageFromDataStream: Truncated telegram! (Resynchronizing)" << std::endl;
+	_frame_length = num_bytes - i;
+	memmove(_frame_buffer,&new_bytes[i],_frame_length);
+	return;
+      }
+
+    }
+
+    _frame_length += num_bytes;
     
   }
-  
+
+  /**
+   * \brief Reads from the stream until the frame buffer holds the given number of bytes
+   * \param frame_length The number of bytes the frame should hold
+   *
+   * NOTE: Bytes that arrive before a timeout are kept in the frame.
+   */
+  void SickLMS1xxBufferMonitor::_readIntoFrame( const unsigned int frame_length ) throw( SickTimeoutException, SickIOException ) {
+
+    unsigned int num_bytes_read = 0;
+
+    /* Already there? (e.g. a timeout came later in the telegram) */
+    if (_frame_length >= frame_length) {
+      return;
+    }
+
+    try {
+      _readBytes(&_frame_buffer[_frame_length],frame_length - _frame_length,num_bytes_read,DEFAULT_SICK_LMS_1XX_FRAME_TIMEOUT);
+    }
+
+    /* Hang on to whatever made it */
+    catch(SickTimeoutException &sick_timeout) {
+      _frame_length += num_bytes_read;
+      throw;
+    }
+
+    _frame_length += num_bytes_read;
+
+  }
+
+  /**
+   * \brief Acquires the next CoLa-B message from the SickLMS1xx byte stream
+   * \param &sick_message The returned message object
+   *
+   * NOTE: The telegram (header and all) is assembled in the monitor's
+   *       frame buffer, so a timeout partway through leaves it to be
+   *       finished by the next call, as w/ CoLa-A. (A reactor rewinds the
+   *       receive buffer itself, so in that case we always start afresh.)
+   */
+  void SickLMS1xxBufferMonitor::_getNextColaBMessageFromDataStream( SickLMS1xxMessage &sick_message ) throw( SickIOException ) {
+
+    const unsigned int header_length = SickLMS1xxMessage::MESSAGE_HEADER_LENGTH;
+    uint32_t payload_length = 0;
+    uint8_t checksum = 0;
+
+    if (_isReactorDriven()) {
+      _resetFrame();
+    }
+
+    try {
+
+      /* Search for the 4 x STX header in the byte stream */
+      while (_frame_length < 4) {
+
+	/* Acquire the next byte from the stream */
+	_readBytes(&_frame_buffer[_frame_length],1,DEFAULT_SICK_LMS_1XX_FRAME_TIMEOUT);
+
+	/* Check if the current byte matches the expected header byte */
+	_frame_length = (_frame_buffer[_frame_length] == 0x02) ? _frame_length + 1 : 0;
+
+      }
+
+      /* Acquire the payload length! */
+      _readIntoFrame(header_length);
+      payload_length = sick_lms_1xx_cola_b_to_host_uint32(&_frame_buffer[4]);
+
+      /* Guard against a corrupt length field */
+      if (payload_length == 0 || payload_length > SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH) {
+	std::cerr << "SickLMS1xxBufferMonitor::GetNextMessageFromDataStream: Bad payload length! (Discarding)" << std::endl;
+	_resetFrame();
+	return;
+      }
+
+      /* Read the payload and the checksum */
+      _readIntoFrame(header_length + payload_length + 1);
+      checksum = _frame_buffer[header_length + payload_length];
+
+      /* Build the return message object (this computes the checksum) */
+      sick_message.BuildMessage(&_frame_buffer[header_length],payload_length,SICK_LMS_1XX_PROTOCOL_COLA_B);
+      _resetFrame();
+
+      /* Verify the checksum is correct */
+      if (sick_message.GetChecksum() != checksum) {
+	throw SickBadChecksumException("SickLMS1xxBufferMonitor::GetNextMessageFromDataStream: BAD CHECKSUM!!!");
+      }
+
+      /* Success */
+
+    }
+
+    catch(SickTimeoutException &sick_timeout) { /* This is ok! */ }
+
+    /* Catch a bad checksum! */
+    catch(SickBadChecksumException &sick_checksum_exception) {
+      sick_message.Clear(); // Clear the message container
+      _recordChecksumFailure();
+    }
+
+    /* Catch any serious IO buffer exceptions */
+    catch(SickIOException &sick_io_exception) {
+      throw;
+    }
+
+    /* A sanity check */
+    catch (...) {
+      throw;
+    }
+
+  }
+
   /**
    * \brief A standard destructor
    */
@@ -19,6 +19,7 @@
 #define SICK_LMS_1XX_BUFFER_MONITOR_HH
 
 #define DEFAULT_SICK_LMS_1XX_BYTE_TIMEOUT         (100000)  ///< Max allowable time between consecutive bytes
+#define DEFAULT_SICK_LMS_1XX_FRAME_TIMEOUT        (100000)  ///< Max allowable time for receiving a whole message (usecs)
 
 /* Definition dependencies */
 #include "SickLMS1xxMessage.hh"
@@ -38,6 +39,9 @@ namespace SickToolbox {
     /** A standard constructor */
     SickLMS1xxBufferMonitor( );
 
+    /** Selects the telegram encoding to frame the stream with (set before the monitor is started) */
+    void SetSickProtocol( const sick_lms_1xx_protocol_t sick_protocol ) { _sick_protocol = sick_protocol; }
+
     /** A method for extracting a single message from the stream */
     void GetNextMessageFromDataStream( SickLMS1xxMessage &sick_message ) throw( SickIOException );
 
@@ -46,8 +50,32 @@ namespace SickToolbox {
 
   private:
 
-    /* A utility function for flushing the receive buffer */
-    void _flushTCPRecvBuffer( ) const throw ( SickIOException );
+    /** The telegram encoding of the stream */
+    sick_lms_1xx_protocol_t _sick_protocol;
+
+    /** Indicates whether a CoLa-A telegram has been started (i.e. its STX has been seen) */
+    bool _frame_in_progress;
+
+    /** Holds the telegram being assembled (survives a timeout); the payload for CoLa-A, the whole telegram for CoLa-B */
+    uint8_t _frame_buffer[SickLMS1xxMessage::MESSAGE_MAX_LENGTH];
+
+    /** Number of bytes held in the frame buffer */
+    unsigned int _frame_length;
+
+    /** Extracts a single CoLa-A message from the stream */
+    void _getNextColaAMessageFromDataStream( SickLMS1xxMessage &sick_message ) throw( SickTimeoutException, SickIOException );
+
+    /** Extracts a single CoLa-B message from the stream */
+    void _getNextColaBMessageFromDataStream( SickLMS1xxMessage &sick_message ) throw( SickIOException );
+
+    /** Appends freshly read bytes to the frame, restarting it at any STX among them */
+    void _appendToFrame( const unsigned int num_bytes );
+
+    /** Reads from the stream until the frame holds the given number of bytes (keeping what arrives on a timeout) */
+    void _readIntoFrame( const unsigned int frame_length ) throw( SickTimeoutException, SickIOException );
+
+    /** Abandons the telegram being assembled */
+    void _resetFrame( ) { _frame_in_progress = false; _frame_length = 0; }
     
   };
     
@@ -32,6 +32,7 @@ namespace SickToolbox {
    */
   SickLMS1xxMessage::SickLMS1xxMessage( ) :
     SickMessage< SICK_LMS_1XX_MSG_HEADER_LEN, SICK_LMS_1XX_MSG_PAYLOAD_MAX_LEN, SICK_LMS_1XX_MSG_TRAILER_LEN >(),
+    _sick_protocol(SICK_LMS_1XX_PROTOCOL_COLA_A),
     _command_type(""),
     _command("")
   {
@@ -45,15 +46,18 @@ namespace SickToolbox {
    * \brief Another constructor.
    * \param *payload_buffer The payload for the packet as an array of bytes (including the header)
    * \param payload_length The length of the payload array in bytes
+   * \param sick_protocol The telegram encoding to frame the payload with
    */
-  SickLMS1xxMessage::SickLMS1xxMessage( const uint8_t * const payload_buffer, const unsigned int payload_length ) :
+  SickLMS1xxMessage::SickLMS1xxMessage( const uint8_t * const payload_buffer, const unsigned int payload_length,
+					const sick_lms_1xx_protocol_t sick_protocol ) :
     SickMessage< SICK_LMS_1XX_MSG_HEADER_LEN, SICK_LMS_1XX_MSG_PAYLOAD_MAX_LEN, SICK_LMS_1XX_MSG_TRAILER_LEN >(),
+    _sick_protocol(sick_protocol),
     _command_type("Unknown"),
     _command("Unknown")
   {
 
     /* Build the message object (implicit initialization) */
-    BuildMessage(payload_buffer,payload_length); 
+    BuildMessage(payload_buffer,payload_length,sick_protocol); 
 
   }
   
@@ -63,6 +67,7 @@ namespace SickToolbox {
    */
   SickLMS1xxMessage::SickLMS1xxMessage( const uint8_t * const message_buffer ) :
     SickMessage< SICK_LMS_1XX_MSG_HEADER_LEN, SICK_LMS_1XX_MSG_PAYLOAD_MAX_LEN, SICK_LMS_1XX_MSG_TRAILER_LEN >(),
+    _sick_protocol(SICK_LMS_1XX_PROTOCOL_COLA_A),
     _command_type("Unknown"),
     _command("Unknown")
   {
@@ -76,8 +81,14 @@ namespace SickToolbox {
    * \brief Constructs a well-formed Sick LMS 1xx message
    * \param *payload_buffer An address of the first byte to be copied into the message's payload
    * \param payload_length The number of bytes to be copied into the message buffer
+   * \param sick_protocol The telegram encoding to frame the payload with
+   *
+   * NOTE: The payload always sits at MESSAGE_HEADER_LENGTH. A CoLa-B frame
+   *       fills the whole header, whereas a CoLa-A frame begins w/ the STX
+   *       in its last byte (see GetMessage).
    */
-  void SickLMS1xxMessage::BuildMessage( const uint8_t * const payload_buffer, const unsigned int payload_length ) {
+  void SickLMS1xxMessage::BuildMessage( const uint8_t * const payload_buffer, const unsigned int payload_length,
+					const sick_lms_1xx_protocol_t sick_protocol ) {
 
     /* Call the parent method
      * NOTE: The parent method resets the object and assigns _message_length, _payload_length,
@@ -85,86 +96,111 @@ namespace SickToolbox {
      */
     SickMessage< SICK_LMS_1XX_MSG_HEADER_LEN, SICK_LMS_1XX_MSG_PAYLOAD_MAX_LEN, SICK_LMS_1XX_MSG_TRAILER_LEN >
       ::BuildMessage(payload_buffer,payload_length);
-    
-    /*
-     * Set the message header!
-     */
-    _message_buffer[0] = 0x02;                 // STX
 
-    /*
-     * Set the message trailer! 
-     */
-    _message_buffer[_message_length-1] = 0x03; // ETX
+    _sick_protocol = sick_protocol;
     
-    /* Grab the (3-byte) command type */
-    char command_type[4] = {0};
-    for (int i = 0; i < 3; i++) {
-      command_type[i] = _message_buffer[i+1];
+    if (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) {
+
+      /*
+       * Set the message header! (4 x STX followed by the big-endian payload length)
+       */
+      memset(_message_buffer,0x02,4);
+      uint32_t msg_length = htonl(_payload_length);
+      memcpy(&_message_buffer[4],&msg_length,4);
+
+      /*
+       * Set the message trailer! (XOR over the payload)
+       */
+      uint8_t checksum = 0;
+      for (unsigned int i = 0; i < _payload_length; i++) {
+	checksum ^= _message_buffer[MESSAGE_HEADER_LENGTH+i];
+      }
+      _message_buffer[_message_length-1] = checksum;
+
     }
-    command_type[4] = '\0';
-    _command_type = command_type;
-    
-    /* Grab the command (max length is 14 bytes) */
-    char command[15] = {0};
-    int i = 0;
-    for (; (i < 14) && (_message_buffer[5+i] != 0x20); i++) {
-      command[i] = _message_buffer[5+i];
+    else {
+
+      /*
+       * Set the message header!
+       */
+      memset(_message_buffer,0,SICK_LMS_1XX_MSG_COLA_A_FRAME_OFFSET);
+      _message_buffer[SICK_LMS_1XX_MSG_COLA_A_FRAME_OFFSET] = 0x02; // STX
+
+      /*
+       * Set the message trailer! 
+       */
+      _message_buffer[_message_length-1] = 0x03;                     // ETX
+
     }
-    command[i] = '\0';
-    _command = command;
+    
+    /* Grab the (3-byte) command type (it is ASCII in either encoding) */
+    const char * const payload = (const char *)&_message_buffer[MESSAGE_HEADER_LENGTH];
+    _command_type.assign(payload,(_payload_length < 3) ? _payload_length : 3);
+    
+    /* Grab the command (max length is 14 bytes and it can't run past the payload) */
+    unsigned int i = 0;
+    for (; (i < 14) && (4+i < _payload_length) && (payload[4+i] != 0x20); i++);
+    _command.assign((_payload_length > 4) ? &payload[4] : payload,i);
     
   }
   
   /**
    * \brief Parses a sequence of bytes into a SickLMS1xxMessage object
    * \param *message_buffer A well-formed message to be parsed into the class' fields
+   *
+   * NOTE: The encoding is inferred from the frame; a CoLa-B frame opens w/
+   *       four STX bytes, a CoLa-A frame w/ just one.
    */
   void SickLMS1xxMessage::ParseMessage( const uint8_t * const message_buffer ) throw (SickIOException) {
     
-    /* Call the parent method
-     * NOTE: This method resets the object and assigns _populated as true
-     */
-    SickMessage< SICK_LMS_1XX_MSG_HEADER_LEN, SICK_LMS_1XX_MSG_PAYLOAD_MAX_LEN, SICK_LMS_1XX_MSG_TRAILER_LEN >
-      ::ParseMessage(message_buffer);
-    
-    /* Compute the message length */
-    int i = 1;
-    const char * token = NULL;
-    while (message_buffer[i-1] != 0x03) {
+    /* A CoLa-B frame carries its own length */
+    if (message_buffer[0] == 0x02 && message_buffer[1] == 0x02 && message_buffer[2] == 0x02 && message_buffer[3] == 0x02) {
 
-      if (i == 1) {
-      
-	/* Grab the command type */
-	if ((token = strtok((char *)&_message_buffer[1]," ")) == NULL) {
-	  throw SickIOException("SickLMS1xxMessage::ParseMessage: strtok() failed!");
-	}
-	
-	_command_type = token;
-	
-	/* Grab the Command Code */
-	if ((token = strtok(NULL," ")) == NULL) {
-	  throw SickIOException("SickLMS1xxMessage::ParseMessage: strtok() failed!");
-	}
-	
-	_command = token;
-	
+      uint32_t payload_length = 0;
+      memcpy(&payload_length,&message_buffer[4],4);
+      payload_length = ntohl(payload_length);
+
+      /* A sanity check */
+      if (payload_length > SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH) {
+	throw SickIOException("SickLMS1xxMessage::ParseMessage: Message Exceeds Max Message Length!");	
       }
-      
-      i++; // Update message length
+
+      BuildMessage(&message_buffer[MESSAGE_HEADER_LENGTH],payload_length,SICK_LMS_1XX_PROTOCOL_COLA_B);
+      return;
+
+    }
+
+    /* Otherwise it runs from the STX to the ETX */
+    unsigned int payload_length = 0;
+    while (message_buffer[1+payload_length] != 0x03) {
+
+      payload_length++;
 
       /* A sanity check */
-      if (i > SickLMS1xxMessage::MESSAGE_MAX_LENGTH) {
+      if (payload_length > SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH) {
 	throw SickIOException("SickLMS1xxMessage::ParseMessage: Message Exceeds Max Message Length!");	
       }
       
     }
 
-    /* Compute the total message length */
-    _payload_length = _message_length - MESSAGE_HEADER_LENGTH - MESSAGE_TRAILER_LENGTH;
-    
-    /* Copy the given packet into the buffer */
-    memcpy(_message_buffer,message_buffer,_message_length);
+    BuildMessage(&message_buffer[1],payload_length,SICK_LMS_1XX_PROTOCOL_COLA_A);
+
+  }
+
+  /**
+   * \brief Get the message as it goes out on the wire
+   * \param *message_buffer Destination buffer for message contents
+   */
+  void SickLMS1xxMessage::GetMessage( uint8_t * const message_buffer ) const {
+    memcpy(message_buffer,&_message_buffer[_getFrameOffset()],GetMessageLength());
+  }
 
+  /**
+   * \brief Get the checksum of a CoLa-B message
+   * \return The checksum (zero for a CoLa-A message, which has none)
+   */
+  uint8_t SickLMS1xxMessage::GetChecksum( ) const {
+    return (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B && _message_length > 0) ? _message_buffer[_message_length-1] : 0;
   }
 
   /**
@@ -176,11 +212,31 @@ namespace SickToolbox {
     SickMessage< SICK_LMS_1XX_MSG_HEADER_LEN, SICK_LMS_1XX_MSG_PAYLOAD_MAX_LEN, SICK_LMS_1XX_MSG_TRAILER_LEN >::Clear();
 
     /* Reset the class' additional fields */
+    _sick_protocol = SICK_LMS_1XX_PROTOCOL_COLA_A;
     _command_type = "Unknown";
     _command = "Unknown";
     
   }
   
+  /**
+   * \brief Exchanges the contents of two messages (buffers are swapped, not copied)
+   * \param &sick_message The message to swap with
+   */
+  void SickLMS1xxMessage::Swap( SickLMS1xxMessage &sick_message ) {
+
+    /* Swap the buffers */
+    SickMessage< SICK_LMS_1XX_MSG_HEADER_LEN, SICK_LMS_1XX_MSG_PAYLOAD_MAX_LEN, SICK_LMS_1XX_MSG_TRAILER_LEN >::Swap(sick_message);
+
+    /* Swap the class' additional fields */
+    sick_lms_1xx_protocol_t sick_protocol = _sick_protocol;
+    _sick_protocol = sick_message._sick_protocol;
+    sick_message._sick_protocol = sick_protocol;
+    
+    _command_type.swap(sick_message._command_type);
+    _command.swap(sick_message._command);
+    
+  }
+  
   /**
    * \brief Print the message contents.
    */
@@ -17,9 +17,10 @@
 #define SICK_LMS_1XX_MESSAGE_HH
 
 /* Macros */
-#define SICK_LMS_1XX_MSG_HEADER_LEN             (1)  ///< Sick LMS 1xx message header length in bytes
+#define SICK_LMS_1XX_MSG_HEADER_LEN             (8)  ///< Sick LMS 1xx message header length in bytes (CoLa-B; CoLa-A only uses the last byte)
 #define SICK_LMS_1XX_MSG_PAYLOAD_MAX_LEN    (30000)  ///< Sick LMS 1xx maximum payload length
 #define SICK_LMS_1XX_MSG_TRAILER_LEN            (1)  ///< Sick LMS 1xx length of the message trailer
+#define SICK_LMS_1XX_MSG_COLA_A_FRAME_OFFSET    (7)  ///< Where a CoLa-A frame (STX) begins in the message buffer
 
 /* Definition dependencies */
 #include <string.h>
@@ -30,6 +31,17 @@
 /* Associate the namespace */
 namespace SickToolbox {
 
+  /*!
+   * \enum sick_lms_1xx_protocol_t
+   * \brief Defines the telegram encodings spoken by the Sick LMS 1xx.
+   */
+  enum sick_lms_1xx_protocol_t {
+
+    SICK_LMS_1XX_PROTOCOL_COLA_A = 0x00,                  ///< CoLa-A: STX, ASCII payload, ETX
+    SICK_LMS_1XX_PROTOCOL_COLA_B = 0x01                   ///< CoLa-B: 4 x STX, 4-byte length, binary payload, XOR checksum
+
+  };
+
   /**
    * \class SickLMS1xxMessage
    * \brief A class to represent all messages sent to and from the Sick LMS 1xx unit.
@@ -42,16 +54,30 @@ namespace SickToolbox {
     SickLMS1xxMessage( );
     
     /** Constructs a packet by using BuildMessage */
-    SickLMS1xxMessage( const uint8_t * const payload_buffer, const unsigned int payload_length );
+    SickLMS1xxMessage( const uint8_t * const payload_buffer, const unsigned int payload_length,
+		       const sick_lms_1xx_protocol_t sick_protocol = SICK_LMS_1XX_PROTOCOL_COLA_A );
     
     /** Constructs a packet using ParseMessage() */
     SickLMS1xxMessage( const uint8_t * const message_buffer );
     
     /** Construct a well-formed raw packet */
-    void BuildMessage( const uint8_t * const payload_buffer, const unsigned int payload_length );
+    void BuildMessage( const uint8_t * const payload_buffer, const unsigned int payload_length,
+		       const sick_lms_1xx_protocol_t sick_protocol = SICK_LMS_1XX_PROTOCOL_COLA_A );
     
     /** Populates fields from a (well-formed) raw packet */
     void ParseMessage( const uint8_t * const message_buffer ) throw ( SickIOException );
+
+    /** Get the message as it goes out on the wire */
+    void GetMessage( uint8_t * const message_buffer ) const;
+
+    /** Get the length of the message as it goes out on the wire */
+    unsigned int GetMessageLength( ) const { return (_message_length > 0) ? _message_length - _getFrameOffset() : 0; }
+
+    /** Get the telegram encoding of the message */
+    sick_lms_1xx_protocol_t GetProtocol( ) const { return _sick_protocol; }
+
+    /** Get the checksum (CoLa-B only, zero otherwise) */
+    uint8_t GetChecksum( ) const;
     
     /** Get the length of the service code associated with the message */
     std::string GetCommandType( ) const { return _command_type; }
@@ -61,6 +87,9 @@ namespace SickToolbox {
 
     /** Reset the data associated with this message (for initialization purposes) */
     void Clear( );
+
+    /** Exchanges contents w/ another message w/o copying either buffer */
+    void Swap( SickLMS1xxMessage &sick_message );
     
     /** A debugging function that prints the contents of the frame. */
     void Print( ) const;
@@ -70,11 +99,19 @@ namespace SickToolbox {
 
   private:
 
+    /** Telegram encoding of the message */
+    sick_lms_1xx_protocol_t _sick_protocol;
+
     /** Command type associated w/ message */
     std::string _command_type;
     
     /** Command associated w/ message */
     std::string _command;
+
+    /** Where the frame begins in the message buffer */
+    unsigned int _getFrameOffset( ) const {
+      return (_sick_protocol == SICK_LMS_1XX_PROTOCOL_COLA_B) ? 0 : SICK_LMS_1XX_MSG_COLA_A_FRAME_OFFSET;
+    }
     
   };
   
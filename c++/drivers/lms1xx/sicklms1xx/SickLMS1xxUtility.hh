@@ -19,6 +19,8 @@
 
 /* Implementation Dependencies */
 #include <sstream>
+#include <string.h>
+#include <arpa/inet.h>
 
 /**
  * \def REVERSE_BYTE_ORDER_16
@@ -117,6 +119,132 @@ namespace SickToolbox {
   
 #endif /* _LITTLE_ENDIAN_HOST */
   
+  /*
+   * NOTE: CoLa-B telegrams are big-endian and their fields aren't
+   *       aligned, so they are copied out/in rather than cast.
+   */
+
+  /**
+   * \brief Extracts a 2-byte value from a CoLa-B telegram
+   * \param *buffer Address of the field's first byte
+   * \return Value in host byte order
+   */
+  inline uint16_t sick_lms_1xx_cola_b_to_host_uint16( const uint8_t * const buffer ) {
+    uint16_t value = 0;
+    memcpy(&value,buffer,2);
+    return ntohs(value);
+  }
+
+  /**
+   * \brief Extracts a 4-byte value from a CoLa-B telegram
+   * \param *buffer Address of the field's first byte
+   * \return Value in host byte order
+   */
+  inline uint32_t sick_lms_1xx_cola_b_to_host_uint32( const uint8_t * const buffer ) {
+    uint32_t value = 0;
+    memcpy(&value,buffer,4);
+    return ntohl(value);
+  }
+
+  /**
+   * \brief Inserts a 2-byte value into a CoLa-B telegram
+   * \param value Value in host byte order
+   * \param *buffer Address of the field's first byte
+   */
+  inline void host_to_sick_lms_1xx_cola_b_uint16( const uint16_t value, uint8_t * const buffer ) {
+    uint16_t net_value = htons(value);
+    memcpy(buffer,&net_value,2);
+  }
+
+  /**
+   * \brief Inserts a 4-byte value into a CoLa-B telegram
+   * \param value Value in host byte order
+   * \param *buffer Address of the field's first byte
+   */
+  inline void host_to_sick_lms_1xx_cola_b_uint32( const uint32_t value, uint8_t * const buffer ) {
+    uint32_t net_value = htonl(value);
+    memcpy(buffer,&net_value,4);
+  }
+
+  /**
+   * \brief Reinterprets the bits of an IEEE-754 single as a float
+   * \param bits The bits (host byte order)
+   * \return The float
+   */
+  inline float sick_lms_1xx_bits_to_float( const uint32_t bits ) {
+    float value = 0;
+    memcpy(&value,&bits,4);
+    return value;
+  }
+
+  /**
+   * \brief Locates the next space-delimited field of a CoLa-A telegram w/o converting it
+   * \param *&str_pos Where to start looking (left just past the field)
+   * \param *str_end One past the last character of the telegram
+   * \return The length of the field (zero if the telegram ran out), which ends at str_pos
+   */
+  inline unsigned int sick_lms_1xx_next_field( const char * &str_pos, const char * const str_end ) {
+
+    /* Skip the delimiter(s) */
+    while (str_pos < str_end && *str_pos == ' ') {
+      str_pos++;
+    }
+
+    const char * const field_beg = str_pos;
+    while (str_pos < str_end && *str_pos != ' ') {
+      str_pos++;
+    }
+
+    return (unsigned int)(str_pos - field_beg);
+
+  }
+
+  /**
+   * \brief Parses the next space-delimited hex field of a CoLa-A telegram
+   * \param *&str_pos Where to start looking (left just past the field)
+   * \param *str_end One past the last character of the telegram
+   * \param &num_val Set to the value of the field
+   * \return True if a well-formed field (1-8 hex digits) was found, false otherwise
+   *
+   * NOTE: Unlike strtok/sscanf this neither modifies the telegram nor keeps
+   *       any state between calls, so it is safe to decode several telegrams
+   *       concurrently. The telegram needn't be NUL-terminated.
+   */
+  inline bool sick_lms_1xx_next_hex_field( const char * &str_pos, const char * const str_end, unsigned int &num_val ) {
+
+    /* Skip the delimiter(s) */
+    while (str_pos < str_end && *str_pos == ' ') {
+      str_pos++;
+    }
+
+    const char * const field_beg = str_pos;
+    uint32_t value = 0;
+    for (; str_pos < str_end && *str_pos != ' '; str_pos++) {
+
+      /* Decimal digits first, then either case of a-f */
+      unsigned int digit = (unsigned int)(uint8_t)*str_pos - '0';
+      if (digit > 9) {
+	digit = (unsigned int)((uint8_t)*str_pos | 0x20) - 'a';
+	if (digit > 5) {
+	  return false;
+	}
+	digit += 10;
+      }
+
+      value = (value << 4) | digit;
+
+    }
+
+    /* Empty or too wide to be a 32-bit field? */
+    if (str_pos == field_beg || str_pos - field_beg > 8) {
+      return false;
+    }
+
+    num_val = value;
+    return true;
+
+  }
+
   /*
    * NOTE: Other utility functions can be defined here
    */
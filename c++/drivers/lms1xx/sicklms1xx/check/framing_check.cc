@@ -0,0 +1,133 @@
+/*!
+ * \file framing_check.cc
+ * \brief Checks that the Sick LMS 1xx buffer monitor finishes a telegram
+ *        whose bytes straddle a frame timeout (CoLa-A and CoLa-B).
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <unistd.h>
+#include <string.h>
+#include <iostream>
+#include <sicklms1xx/SickLMS1xxBufferMonitor.hh>
+
+using namespace std;
+using namespace SickToolbox;
+
+#define STALL_USECS     (3*DEFAULT_SICK_LMS_1XX_FRAME_TIMEOUT)  ///< Long enough for the monitor to time out mid-telegram
+#define WAIT_USECS      (1000000)                               ///< How long to wait for the telegram once it is all sent
+
+static unsigned int num_failures = 0;
+
+/**
+ * \brief Reports a failed expectation
+ */
+static void expect( const bool condition, const char * const what ) {
+
+  if (!condition) {
+    cerr << "FAILED: " << what << endl;
+    num_failures++;
+  }
+
+}
+
+/**
+ * \brief Writes a telegram to the stream in pieces, stalling between them
+ * \param sick_fd The stream
+ * \param *telegram The telegram
+ * \param telegram_length The telegram length
+ * \param *split_points Where to break the telegram (ascending)
+ * \param num_split_points The number of breaks
+ */
+static void write_in_pieces( const int sick_fd, const uint8_t * const telegram, const unsigned int telegram_length,
+			     const unsigned int * const split_points, const unsigned int num_split_points ) {
+
+  unsigned int num_bytes_written = 0;
+  for (unsigned int i = 0; i <= num_split_points; i++) {
+
+    const unsigned int piece_end = (i < num_split_points) ? split_points[i] : telegram_length;
+    if (write(sick_fd,&telegram[num_bytes_written],piece_end - num_bytes_written) != (ssize_t)(piece_end - num_bytes_written)) {
+      cerr << "write() failed!" << endl;
+    }
+    num_bytes_written = piece_end;
+
+    if (i < num_split_points) {
+      usleep(STALL_USECS);
+    }
+
+  }
+
+}
+
+/**
+ * \brief Sends telegrams through a monitor in pieces and checks each comes out whole
+ * \param sick_protocol The telegram encoding
+ * \param *protocol_name The encoding (for reporting)
+ */
+static void check_protocol( const sick_lms_1xx_protocol_t sick_protocol, const char * const protocol_name ) {
+
+  int pipe_fds[2];
+  if (pipe(pipe_fds) != 0) {
+    expect(false,"pipe()");
+    return;
+  }
+
+  SickLMS1xxBufferMonitor sick_buffer_monitor;
+  sick_buffer_monitor.SetSickProtocol(sick_protocol);
+  sick_buffer_monitor.StartMonitor(pipe_fds[0]);
+
+  /* A long payload (as a scan would be) */
+  uint8_t payload_buffer[2000];
+  memcpy(payload_buffer,"sSN LMDscandata ",16);
+  for (unsigned int i = 16; i < sizeof(payload_buffer); i++) {
+    payload_buffer[i] = 'A' + (i % 26);
+  }
+
+  SickLMS1xxMessage sent_message(payload_buffer,sizeof(payload_buffer),sick_protocol);
+  uint8_t telegram[SickLMS1xxMessage::MESSAGE_MAX_LENGTH];
+  sent_message.GetMessage(telegram);
+  const unsigned int telegram_length = sent_message.GetMessageLength();
+
+  /* Break in the header, in the payload, and just before the trailer */
+  const unsigned int split_points[][3] = { { 2, 6, 1000 },
+					   { 1, 500, telegram_length - 1 },
+					   { 9, 10, 11 } };
+  const unsigned int num_splits = sizeof(split_points)/sizeof(split_points[0]);
+
+  for (unsigned int i = 0; i < num_splits; i++) {
+
+    write_in_pieces(pipe_fds[1],telegram,telegram_length,split_points[i],3);
+
+    SickLMS1xxMessage recv_message;
+    const bool received = sick_buffer_monitor.GetNextMessageFromMonitor(recv_message,WAIT_USECS);
+
+    string what = string(protocol_name) + ": telegram split across timeouts comes out whole";
+    expect(received && recv_message.GetPayloadLength() == sizeof(payload_buffer) &&
+	   memcmp(recv_message.GetPayloadPtr(),payload_buffer,sizeof(payload_buffer)) == 0,what.c_str());
+
+  }
+
+  /* Nothing else should have been framed (e.g. from a misread remainder) */
+  SickLMS1xxMessage extra_message;
+  string what = string(protocol_name) + ": no spurious telegrams";
+  expect(!sick_buffer_monitor.GetNextMessageFromMonitor(extra_message),what.c_str());
+
+  sick_buffer_monitor.StopMonitor();
+  close(pipe_fds[0]);
+  close(pipe_fds[1]);
+
+}
+
+int main()
+{
+
+  check_protocol(SICK_LMS_1XX_PROTOCOL_COLA_A,"CoLa-A");
+  check_protocol(SICK_LMS_1XX_PROTOCOL_COLA_B,"CoLa-B");
+
+  cout << "Framing: " << num_failures << " failure(s)" << endl;
+
+  return num_failures == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,178 @@
+/*!
+ * \file scan_data_cfg_check.cc
+ * \brief Checks that the Sick LMS 1xx LMDscandatacfg request carries the
+ *        same fields whether it is framed in CoLa-A or CoLa-B.
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <sicklms1xx/SickLMS1xx.hh>
+
+using namespace std;
+using namespace SickToolbox;
+
+#define COMMAND_LENGTH     (19)  ///< "sWN LMDscandatacfg " (the same in both framings)
+#define NUM_BYTE_FIELDS    (11)  ///< Channel through time (one byte each in CoLa-B)
+
+/**
+ * \brief Builds requests w/o ever opening the device
+ */
+class SickLMS1xxCheck : public SickLMS1xx {
+
+public:
+
+  SickLMS1xxCheck( const sick_lms_1xx_protocol_t sick_protocol ) : SickLMS1xx(DEFAULT_SICK_LMS_1XX_IP_ADDRESS,DEFAULT_SICK_LMS_1XX_TCP_PORT,sick_protocol) { }
+
+  /** Builds the LMDscandatacfg request for the given config */
+  void BuildScanDataConfigRequest( SickLMS1xxMessage &send_message, const sick_lms_1xx_scan_data_cfg_t &scan_data_cfg ) const {
+    _buildScanDataConfigRequest(send_message,scan_data_cfg);
+  }
+
+};
+
+/**
+ * \brief Reads the fields of a CoLa-A request
+ * \param &send_message The request
+ * \param *field_values Set to the byte fields (channel through time)
+ * \param &output_interval Set to the output interval
+ * \return True if the request is well-formed
+ */
+static bool read_cola_a_fields( const SickLMS1xxMessage &send_message, unsigned int * const field_values, unsigned int &output_interval ) {
+
+  char payload_str[SickLMS1xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH+1] = {0};
+  send_message.GetPayloadAsCStr(payload_str);
+
+  if (strncmp(payload_str,"sWN LMDscandatacfg ",COMMAND_LENGTH) != 0) {
+    return false;
+  }
+
+  const char * str_pos = payload_str + COMMAND_LENGTH;
+  for (unsigned int i = 0; i < NUM_BYTE_FIELDS; i++) {
+    char * str_end = NULL;
+    field_values[i] = strtoul(str_pos,&str_end,16);
+    if (str_end == str_pos || *str_end != ' ') {
+      return false;
+    }
+    str_pos = str_end + 1;
+  }
+
+  /* The interval is a signed decimal */
+  if (*str_pos != '+') {
+    return false;
+  }
+  char * str_end = NULL;
+  output_interval = strtoul(str_pos + 1,&str_end,10);
+
+  return str_end != str_pos + 1 && *str_end == '\0';
+
+}
+
+/**
+ * \brief Reads the fields of a CoLa-B request
+ * \param &send_message The request
+ * \param *field_values Set to the byte fields (channel through time)
+ * \param &output_interval Set to the output interval
+ * \return True if the request is well-formed
+ */
+static bool read_cola_b_fields( const SickLMS1xxMessage &send_message, unsigned int * const field_values, unsigned int &output_interval ) {
+
+  if (send_message.GetPayloadLength() != COMMAND_LENGTH + NUM_BYTE_FIELDS + 2) {
+    return false;
+  }
+
+  const uint8_t * const payload_buffer = send_message.GetPayloadPtr();
+  if (memcmp(payload_buffer,"sWN LMDscandatacfg ",COMMAND_LENGTH) != 0) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < NUM_BYTE_FIELDS; i++) {
+    field_values[i] = payload_buffer[COMMAND_LENGTH + i];
+  }
+  /* The interval is big-endian */
+  output_interval = (payload_buffer[COMMAND_LENGTH + NUM_BYTE_FIELDS] << 8) | payload_buffer[COMMAND_LENGTH + NUM_BYTE_FIELDS + 1];
+
+  return true;
+
+}
+
+int main()
+{
+
+  const SickLMS1xxCheck sick_lms_cola_a(SICK_LMS_1XX_PROTOCOL_COLA_A);
+  const SickLMS1xxCheck sick_lms_cola_b(SICK_LMS_1XX_PROTOCOL_COLA_B);
+
+  const sick_lms_1xx_scan_format_t scan_formats[] = { SickLMS1xx::SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_NONE,
+						      SickLMS1xx::SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_8BIT,
+						      SickLMS1xx::SICK_LMS_1XX_SCAN_FORMAT_DIST_SINGLE_PULSE_REFLECT_16BIT,
+						      SickLMS1xx::SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_NONE,
+						      SickLMS1xx::SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_8BIT,
+						      SickLMS1xx::SICK_LMS_1XX_SCAN_FORMAT_DIST_DOUBLE_PULSE_REFLECT_16BIT };
+  const unsigned int num_scan_formats = sizeof(scan_formats)/sizeof(scan_formats[0]);
+  const unsigned int output_intervals[] = { 1, 2, 10, 50000 };
+  const unsigned int num_output_intervals = sizeof(output_intervals)/sizeof(output_intervals[0]);
+
+  unsigned int num_failures = 0;
+  unsigned int num_configs = 0;
+
+  /* Every format, w/ each of the optional blocks on and off */
+  for (unsigned int f = 0; f < num_scan_formats; f++) {
+    for (unsigned int blocks = 0; blocks < 32; blocks++) {
+
+      sick_lms_1xx_scan_data_cfg_t scan_data_cfg;
+      scan_data_cfg.scan_format = scan_formats[f];
+      scan_data_cfg.send_encoder = blocks & 0x01;
+      scan_data_cfg.send_position = blocks & 0x02;
+      scan_data_cfg.send_device_name = blocks & 0x04;
+      scan_data_cfg.send_comment = blocks & 0x08;
+      scan_data_cfg.send_time = blocks & 0x10;
+      scan_data_cfg.output_interval = output_intervals[blocks % num_output_intervals];
+
+      SickLMS1xxMessage cola_a_message, cola_b_message;
+      sick_lms_cola_a.BuildScanDataConfigRequest(cola_a_message,scan_data_cfg);
+      sick_lms_cola_b.BuildScanDataConfigRequest(cola_b_message,scan_data_cfg);
+
+      unsigned int cola_a_fields[NUM_BYTE_FIELDS] = {0}, cola_b_fields[NUM_BYTE_FIELDS] = {0};
+      unsigned int cola_a_interval = 0, cola_b_interval = 0;
+
+      if (!read_cola_a_fields(cola_a_message,cola_a_fields,cola_a_interval) ||
+	  !read_cola_b_fields(cola_b_message,cola_b_fields,cola_b_interval)) {
+	cerr << "FAILED: malformed request (format " << f << ", blocks " << blocks << ")" << endl;
+	num_failures++;
+	continue;
+      }
+
+      for (unsigned int i = 0; i < NUM_BYTE_FIELDS; i++) {
+	if (cola_a_fields[i] != cola_b_fields[i]) {
+	  cerr << "FAILED: field " << i << " is " << cola_a_fields[i] << " in CoLa-A but " << cola_b_fields[i]
+	       << " in CoLa-B (format " << f << ", blocks " << blocks << ")" << endl;
+	  num_failures++;
+	}
+      }
+
+      if (cola_a_interval != scan_data_cfg.output_interval || cola_b_interval != scan_data_cfg.output_interval) {
+	cerr << "FAILED: output interval " << scan_data_cfg.output_interval << " sent as " << cola_a_interval
+	     << " (CoLa-A) and " << cola_b_interval << " (CoLa-B)" << endl;
+	num_failures++;
+      }
+
+      /* The encoder field is the sixth */
+      if (cola_b_fields[5] != (scan_data_cfg.send_encoder ? 1U : 0U)) {
+	cerr << "FAILED: encoder flag not sent as 01 00 (blocks " << blocks << ")" << endl;
+	num_failures++;
+      }
+
+      num_configs++;
+
+    }
+  }
+
+  cout << "Scan data config: " << num_configs << " configs, " << num_failures << " failure(s)" << endl;
+
+  return num_failures == 0 ? 0 : 1;
+
+}
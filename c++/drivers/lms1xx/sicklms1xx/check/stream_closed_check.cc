@@ -0,0 +1,112 @@
+/*!
+ * \file stream_closed_check.cc
+ * \brief Checks that the buffer monitor stops reading a data stream once
+ *        the other end closes it (monitor thread and reactor).
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <unistd.h>
+#include <string.h>
+#include <sstream>
+#include <iostream>
+#include <sicklms1xx/SickLMS1xxBufferMonitor.hh>
+#include "SickReactor.hh"
+
+using namespace std;
+using namespace SickToolbox;
+
+#define SETTLE_USECS    (300000)  ///< Long enough for a spinning monitor to report the closed stream many times
+
+static unsigned int num_failures = 0;
+
+/**
+ * \brief Reports a failed expectation
+ */
+static void expect( const bool condition, const string &what ) {
+
+  if (!condition) {
+    cerr << "FAILED: " << what << endl;
+    num_failures++;
+  }
+
+}
+
+/**
+ * \brief Counts the occurrences of a string
+ */
+static unsigned int count_occurrences( const string &str, const string &sub_str ) {
+
+  unsigned int num_occurrences = 0;
+  for (size_t pos = str.find(sub_str); pos != string::npos; pos = str.find(sub_str,pos + 1)) {
+    num_occurrences++;
+  }
+
+  return num_occurrences;
+
+}
+
+/**
+ * \brief Closes the far end of a monitored stream and checks the monitor gives up on it once
+ * \param *sick_reactor The reactor servicing the stream (NULL for a monitor thread)
+ * \param *mode_name The mode (for reporting)
+ */
+static void check_mode( SickReactor * const sick_reactor, const string &mode_name ) {
+
+  int pipe_fds[2];
+  if (pipe(pipe_fds) != 0) {
+    expect(false,"pipe()");
+    return;
+  }
+
+  SickLMS1xxBufferMonitor sick_buffer_monitor;
+  sick_buffer_monitor.SetSickProtocol(SICK_LMS_1XX_PROTOCOL_COLA_A);
+  sick_buffer_monitor.SetReactor(sick_reactor);
+
+  /* Collect what the monitor (and reactor) report */
+  ostringstream reported;
+  streambuf * const cerr_buffer = cerr.rdbuf(reported.rdbuf());
+
+  sick_buffer_monitor.StartMonitor(pipe_fds[0]);
+
+  /* A telegram sent just before the close still comes through */
+  const uint8_t telegram[] = { 0x02, 's', 'R', 'A', ' ', 'x', 0x03 };
+  if (write(pipe_fds[1],telegram,sizeof(telegram)) != (ssize_t)sizeof(telegram)) {
+    expect(false,"write()");
+  }
+  close(pipe_fds[1]);
+  usleep(SETTLE_USECS);
+
+  const bool stream_closed = sick_buffer_monitor.IsStreamClosed();
+
+  /* Once this returns nothing else writes to the collected output */
+  sick_buffer_monitor.StopMonitor();
+  cerr.rdbuf(cerr_buffer);
+  close(pipe_fds[0]);
+
+  SickLMS1xxMessage recv_message;
+  expect(sick_buffer_monitor.GetNextMessageFromMonitor(recv_message) && recv_message.GetPayloadLength() == 5,
+	 mode_name + ": telegram sent before the close is framed");
+  expect(stream_closed,mode_name + ": stream flagged closed");
+  expect(count_occurrences(reported.str(),"Stream closed!") == 1,
+	 mode_name + ": closed stream reported once (reported: \"" + reported.str() + "\")");
+  expect(count_occurrences(reported.str(),"read() failed!") == 0,mode_name + ": close not reported as a read error");
+
+}
+
+int main()
+{
+
+  check_mode(NULL,"Monitor thread");
+
+  SickReactor sick_reactor;
+  check_mode(&sick_reactor,"Reactor");
+  expect(sick_reactor.GetNumRegistered() == 0,"Reactor: stream unregistered once the monitor stopped");
+
+  cout << "Closed stream: " << num_failures << " failure(s)" << endl;
+
+  return num_failures == 0 ? 0 : 1;
+
+}
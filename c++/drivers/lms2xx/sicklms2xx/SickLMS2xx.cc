@@ -35,6 +35,15 @@
 #define B500000 0010005
 #endif
 
+/* Vector units used to extract measured values (baseline wherever they are compiled in) */
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SICK_LMS_2XX_EXTRACT_SSE2
+#elif defined(__ARM_NEON) && defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#include <arm_neon.h>
+#define SICK_LMS_2XX_EXTRACT_NEON
+#endif
+
 /* Associate the namespace */
 namespace SickToolbox {
 
@@ -47,6 +56,8 @@ namespace SickToolbox {
 								_curr_session_baud(SICK_BAUD_UNKNOWN),
 								_desired_session_baud(SICK_BAUD_UNKNOWN),
 								_sick_type(SICK_LMS_TYPE_UNKNOWN),
+								_sick_partial_scan_assembly(false),
+								_sick_partial_scan_interpolation(false),
 								_sick_mean_value_sample_size(0),
 								_sick_values_subrange_start_index(0),
 								_sick_values_subrange_stop_index(0)
@@ -62,6 +73,12 @@ namespace SickToolbox {
     memset(&_sick_baud_status,0,sizeof(sick_lms_2xx_baud_status_t));
     memset(&_sick_device_config,0,sizeof(sick_lms_2xx_device_config_t));
     memset(&_old_term,0,sizeof(struct termios));
+    memset(&_sick_scan_data,0,sizeof(sick_lms_2xx_scan_data_t));
+    memset(&_sick_scan_interlacer,0,sizeof(sick_lms_2xx_interlacer_t));
+    memset(&_sick_interlacer,0,sizeof(sick_lms_2xx_interlacer_t));
+
+    /* Offer streamed scans to the subscribers before they are queued */
+    _sick_buffer_monitor->SetMessageHandler(SickLMS2xx::_scanMessageHandler,this);
     
   }
 
@@ -966,6 +983,7 @@ namespace SickToolbox {
    * \param *sick_field_c_values Stores the Field C values associated with the given scan (Default: NULL => Not wanted)
    * \param *sick_telegram_index The telegram index assigned to the message (modulo: 256) (Default: NULL => Not wanted)
    * \param *sick_real_time_scan_index The real time scan index for the latest message (module 256) (Default: NULL => Not wanted)
+   * \param *arrival_time When the first byte of the scan arrived at the host, CLOCK_REALTIME (Default: NULL => Not wanted)
    *
    * NOTE: Calling this function will return either range or reflectivity measurements
    *       depending upon the current measuring mode of the device.
@@ -979,7 +997,8 @@ namespace SickToolbox {
 			     unsigned int * const sick_field_b_values,
 			     unsigned int * const sick_field_c_values,
 			     unsigned int * const sick_telegram_index,
-			     unsigned int * const sick_real_time_scan_index ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
+			     unsigned int * const sick_real_time_scan_index,
+			     struct timespec * const arrival_time ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
 
     /* Ensure the device is initialized */
     if (!_sick_initialized) {
@@ -989,9 +1008,6 @@ namespace SickToolbox {
     /* Declare message objects */
     SickLMS2xxMessage response;
 
-    /* Declare some useful variables and a buffer */
-    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
     try {
     
       /* Restore original operating mode */
@@ -1005,51 +1021,29 @@ namespace SickToolbox {
 	throw SickIOException("SickLMS2xx::GetSickScan: Unexpected message!");
       }
 
-      /* Acquire the payload buffer and length*/
-      response.GetPayload(payload_buffer);
-
-      /* Define a local scan profile object */
-      sick_lms_2xx_scan_profile_b0_t sick_scan_profile;
-
-      /* Initialize the profile */
-      memset(&sick_scan_profile,0,sizeof(sick_lms_2xx_scan_profile_b0_t));
-
-      /* Parse the message payload */
-      _parseSickScanProfileB0(&payload_buffer[1],sick_scan_profile);
-
-      /* Return the request values! */
-      num_measurement_values = sick_scan_profile.sick_num_measurements;
-
-      for (unsigned int i = 0; i < num_measurement_values; i++) {
-
-	/* Copy the measurement value */
-	measurement_values[i] = sick_scan_profile.sick_measurements[i];
-
-	/* If requested, copy field A values */
-	if(sick_field_a_values) {
-	  sick_field_a_values[i] = sick_scan_profile.sick_field_a_values[i];
-	}
-
-	/* If requested, copy field B values */
-	if(sick_field_b_values) {
-	  sick_field_b_values[i] = sick_scan_profile.sick_field_b_values[i];
-	}
-
-	/* If requested, copy field C values */
-	if(sick_field_c_values) {
-	  sick_field_c_values[i] = sick_scan_profile.sick_field_c_values[i];
-	}
-
+      /* Decode straight into the caller's buffers */
+      sick_lms_2xx_scan_dest_t sick_scan_dest;
+      _setSickScanDest(sick_scan_dest,measurement_values,NULL,sick_field_a_values,sick_field_b_values,sick_field_c_values);
+      if (!_decodeSickScan(response.GetPayloadPtr(),response.GetPayloadLength(),sick_scan_dest)) {
+	throw SickIOException("SickLMS2xx::GetSickScan: Malformed scan!");
       }
 
+      /* Return the requested values! */
+      num_measurement_values = sick_scan_dest.num_measurement_values;
+
       /* If requested, copy the real time scan index */
       if(sick_real_time_scan_index) {
-	*sick_real_time_scan_index = sick_scan_profile.sick_real_time_scan_index;
+	*sick_real_time_scan_index = sick_scan_dest.sick_real_time_scan_index;
       }
       
       /* If requested, copy the telegram index */
       if(sick_telegram_index) {
-	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
+	*sick_telegram_index = sick_scan_dest.sick_telegram_index;
+      }
+
+      /* If requested, copy the arrival time */
+      if(arrival_time) {
+	*arrival_time = response.GetArrivalTime();
       }
 
     }
@@ -1099,6 +1093,7 @@ namespace SickToolbox {
    * \param *sick_field_c_values Stores the Field C values associated with the given scan (Default: NULL => Not wanted)
    * \param *sick_telegram_index The telegram index assigned to the message (modulo: 256) (Default: NULL => Not wanted)
    * \param *sick_real_time_scan_index The real time scan index for the latest message (module 256) (Default: NULL => Not wanted)
+   * \param *arrival_time When the first byte of the scan arrived at the host, CLOCK_REALTIME (Default: NULL => Not wanted)
    *
    * NOTE: Real-time scan indices must be enabled by setting the corresponding availability
    *       of the Sick LMS 2xx for this value to be populated.
@@ -1111,7 +1106,8 @@ namespace SickToolbox {
 			     unsigned int * const sick_field_b_values,
 			     unsigned int * const sick_field_c_values,
 			     unsigned int * const sick_telegram_index,
-			     unsigned int * const sick_real_time_scan_index ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
+			     unsigned int * const sick_real_time_scan_index,
+			     struct timespec * const arrival_time ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
 
     /* Ensure the device is initialized */
     if (!_sick_initialized) {
@@ -1121,9 +1117,6 @@ namespace SickToolbox {
     /* Declare message objects */
     SickLMS2xxMessage response;
 
-    /* Declare some useful variables and a buffer */
-    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
     try {
       
       /* Restore original operating mode */
@@ -1137,59 +1130,32 @@ namespace SickToolbox {
 	throw SickIOException("SickLMS2xx::GetSickScan: Unexpected message!");
       }
       
-      /* Acquire the payload buffer and length*/
-      response.GetPayload(payload_buffer);
-      
-      /* Define a local scan profile object */
-      sick_lms_2xx_scan_profile_c4_t sick_scan_profile;
-
-      /* Initialize the profile */
-      memset(&sick_scan_profile,0,sizeof(sick_lms_2xx_scan_profile_c4_t));
-
-      /* Parse the message payload */
-      _parseSickScanProfileC4(&payload_buffer[1],sick_scan_profile);
+      /* Decode straight into the caller's buffers */
+      sick_lms_2xx_scan_dest_t sick_scan_dest;
+      _setSickScanDest(sick_scan_dest,range_values,reflect_values,sick_field_a_values,sick_field_b_values,sick_field_c_values);
+      if (!_decodeSickScan(response.GetPayloadPtr(),response.GetPayloadLength(),sick_scan_dest)) {
+	throw SickIOException("SickLMS2xx::GetSickScan: Malformed scan!");
+      }
 
       /* Return the requested values! */
-      num_range_measurements = sick_scan_profile.sick_num_range_measurements;
-      num_reflect_measurements = sick_scan_profile.sick_num_reflect_measurements;
-      
-      for (unsigned int i = 0; i < sick_scan_profile.sick_num_range_measurements; i++) {
-
-	/* Copy the measurement value */
-	range_values[i] = sick_scan_profile.sick_range_measurements[i];
-	
-	/* If requested, copy field A values */
-	if(sick_field_a_values) {
-	  sick_field_a_values[i] = sick_scan_profile.sick_field_a_values[i];
-	}
-
-	/* If requested, copy field B values */
-	if(sick_field_b_values) {
-	  sick_field_b_values[i] = sick_scan_profile.sick_field_b_values[i];
-	}
-
-	/* If requested, copy field C values */
-	if(sick_field_c_values) {
-	  sick_field_c_values[i] = sick_scan_profile.sick_field_c_values[i];
-	}
-
-      }
+      num_range_measurements = sick_scan_dest.num_measurement_values;
+      num_reflect_measurements = sick_scan_dest.num_reflect_values;
 
-      /* Copy the reflectivity measurements */
-      for( unsigned int i = 0; i < num_reflect_measurements; i++) {
-	reflect_values[i] = sick_scan_profile.sick_reflect_measurements[i];
+      /* If requested, copy the real time scan index */
+      if(sick_real_time_scan_index) {
+	*sick_real_time_scan_index = sick_scan_dest.sick_real_time_scan_index;
       }
       
       /* If requested, copy the telegram index */
       if(sick_telegram_index) {
-	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
+	*sick_telegram_index = sick_scan_dest.sick_telegram_index;
       }
-      
-      /* If requested, copy the real time scan index */
-      if(sick_real_time_scan_index) {
-	*sick_real_time_scan_index = sick_scan_profile.sick_real_time_scan_index;
+
+      /* If requested, copy the arrival time */
+      if(arrival_time) {
+	*arrival_time = response.GetArrivalTime();
       }
-      
+
     }
 
     /* Handle any config exceptions */
@@ -1235,6 +1201,7 @@ namespace SickToolbox {
    * \param *sick_field_c_values Stores the Field C values associated with the given scan (Default: NULL => Not wanted)
    * \param *sick_telegram_index The telegram index assigned to the message (modulo: 256) (Default: NULL => Not wanted)
    * \param *sick_real_time_scan_index The real time scan index for the latest message (module 256) (Default: NULL => Not wanted)*
+   * \param *arrival_time When the first byte of the scan arrived at the host, CLOCK_REALTIME (Default: NULL => Not wanted)
    *
    * NOTE: Calling this function will return either range or reflectivity measurements
    *       depending upon the current measuring mode of the device.
@@ -1254,7 +1221,8 @@ namespace SickToolbox {
 				     unsigned int * const sick_field_b_values,
 				     unsigned int * const sick_field_c_values,
 				     unsigned int * const sick_telegram_index,
-				     unsigned int * const sick_real_time_scan_index ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
+				     unsigned int * const sick_real_time_scan_index,
+				     struct timespec * const arrival_time ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
 
     /* Ensure the device is initialized */
     if (!_sick_initialized) {
@@ -1264,9 +1232,6 @@ namespace SickToolbox {
     /* Declare message object */
     SickLMS2xxMessage response;
 
-    /* Declare some useful variables and a buffer */
-    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
     try {
     
       /* Restore original operating mode */
@@ -1280,51 +1245,29 @@ namespace SickToolbox {
 	throw SickIOException("SickLMS2xx::GetSickScanSubrange: Unexpected message!");
       }
 
-      /* Acquire the payload buffer and length*/
-      response.GetPayload(payload_buffer);
-
-      /* Define a local scan profile object */
-      sick_lms_2xx_scan_profile_b7_t sick_scan_profile;
-
-      /* Initialize the profile */
-      memset(&sick_scan_profile,0,sizeof(sick_lms_2xx_scan_profile_b7_t));
-
-      /* Parse the message payload */
-      _parseSickScanProfileB7(&payload_buffer[1],sick_scan_profile);
-
-      /* Return the request values! */
-      num_measurement_values = sick_scan_profile.sick_num_measurements;
-
-      for (unsigned int i = 0; i < num_measurement_values; i++) {
-
-	/* Copy the measurement value */
-	measurement_values[i] = sick_scan_profile.sick_measurements[i];
-
-	/* If requested, copy field A values */
-	if(sick_field_a_values) {
-	  sick_field_a_values[i] = sick_scan_profile.sick_field_a_values[i];
-	}
-
-	/* If requested, copy field B values */
-	if(sick_field_b_values) {
-	  sick_field_b_values[i] = sick_scan_profile.sick_field_b_values[i];
-	}
-
-	/* If requested, copy field C values */
-	if(sick_field_c_values) {
-	  sick_field_c_values[i] = sick_scan_profile.sick_field_c_values[i];
-	}
-
+      /* Decode straight into the caller's buffers */
+      sick_lms_2xx_scan_dest_t sick_scan_dest;
+      _setSickScanDest(sick_scan_dest,measurement_values,NULL,sick_field_a_values,sick_field_b_values,sick_field_c_values);
+      if (!_decodeSickScan(response.GetPayloadPtr(),response.GetPayloadLength(),sick_scan_dest)) {
+	throw SickIOException("SickLMS2xx::GetSickScanSubrange: Malformed scan!");
       }
 
+      /* Return the requested values! */
+      num_measurement_values = sick_scan_dest.num_measurement_values;
+
       /* If requested, copy the real time scan index */
       if(sick_real_time_scan_index) {
-	*sick_real_time_scan_index = sick_scan_profile.sick_real_time_scan_index;
+	*sick_real_time_scan_index = sick_scan_dest.sick_real_time_scan_index;
       }
       
       /* If requested, copy the telegram index */
       if(sick_telegram_index) {
-	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
+	*sick_telegram_index = sick_scan_dest.sick_telegram_index;
+      }
+
+      /* If requested, copy the arrival time */
+      if(arrival_time) {
+	*arrival_time = response.GetArrivalTime();
       }
 
     }
@@ -1371,6 +1314,7 @@ namespace SickToolbox {
    * \param *sick_field_c_values Stores the Field C values associated with the given scan (Default: NULL => Not wanted)
    * \param *sick_telegram_index The telegram index assigned to the message (modulo: 256) (Default: NULL => Not wanted)
    * \param *sick_real_time_scan_index The real time scan index for the latest message (module 256) (Default: NULL => Not wanted)
+   * \param *arrival_time When the first byte of the scan arrived at the host, CLOCK_REALTIME (Default: NULL => Not wanted)
    *
    * NOTE: This function will set the device to interlaced mode.
    *
@@ -1391,7 +1335,8 @@ namespace SickToolbox {
 				    unsigned int * const sick_field_b_values,
 				    unsigned int * const sick_field_c_values,
 				    unsigned int * const sick_telegram_index,
-				    unsigned int * const sick_real_time_scan_index ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
+				    unsigned int * const sick_real_time_scan_index,
+				    struct timespec * const arrival_time ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
 
     /* Ensure the device is initialized */
     if (!_sick_initialized) {
@@ -1401,9 +1346,6 @@ namespace SickToolbox {
     /* Declare message objects */
     SickLMS2xxMessage response;
 
-    /* Declare some useful variables and a buffer */
-    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
     try {
 
       /* Restore original operating mode */
@@ -1417,54 +1359,172 @@ namespace SickToolbox {
 	throw SickIOException("SickLMS2xx::GetSickPartialScan: Unexpected message!");
       }
 
-      /* Acquire the payload buffer and length*/
-      response.GetPayload(payload_buffer);
+      /* Decode straight into the caller's buffers */
+      sick_lms_2xx_scan_dest_t sick_scan_dest;
+      _setSickScanDest(sick_scan_dest,measurement_values,NULL,sick_field_a_values,sick_field_b_values,sick_field_c_values);
+      if (!_decodeSickScan(response.GetPayloadPtr(),response.GetPayloadLength(),sick_scan_dest)) {
+	throw SickIOException("SickLMS2xx::GetSickPartialScan: Malformed scan!");
+      }
 
-      /* Define a local scan profile object */
-      sick_lms_2xx_scan_profile_b0_t sick_scan_profile;
+      /* Return the requested values! */
+      num_measurement_values = sick_scan_dest.num_measurement_values;
+      partial_scan_index = sick_scan_dest.sick_partial_scan_index;
 
-      /* Initialize the profile */
-      memset(&sick_scan_profile,0,sizeof(sick_lms_2xx_scan_profile_b0_t));
+      /* If requested, copy the real time scan index */
+      if(sick_real_time_scan_index) {
+	*sick_real_time_scan_index = sick_scan_dest.sick_real_time_scan_index;
+      }
+      
+      /* If requested, copy the telegram index */
+      if(sick_telegram_index) {
+	*sick_telegram_index = sick_scan_dest.sick_telegram_index;
+      }
 
-      /* Parse the message payload */
-      _parseSickScanProfileB0(&payload_buffer[1],sick_scan_profile);
+      /* If requested, copy the arrival time */
+      if(arrival_time) {
+	*arrival_time = response.GetArrivalTime();
+      }
 
-      /* Return the request values! */
-      num_measurement_values = sick_scan_profile.sick_num_measurements;
+    }
 
-      /* Assign the partial scan index */
-      partial_scan_index = sick_scan_profile.sick_partial_scan_index;
-      
-      for (unsigned int i = 0; i < num_measurement_values; i++) {
+    /* Handle any config exceptions */
+    catch(SickConfigException &sick_config_exception) {
+      std::cerr << sick_config_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle a timeout exception */
+    catch(SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle any I/O exceptions */
+    catch(SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle any thread exceptions */
+    catch(SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle anything else */
+    catch(...) {
+      std::cerr << "SickLMS2xx::GetSickPartialScan: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+  }
+
+  /**
+   * \brief Returns a whole scan interlaced from the partial scans streamed by the Sick LMS 2xx
+   * \param *measurement_values Destination buffer for holding the interlaced measured values
+   * \param &num_measurement_values Number of values stored in measurement_values
+   * \param &missing_partial_scans Bit k is set if partial scan k (k*0.25 deg) didn't arrive (zero for a whole scan)
+   * \param *sick_field_a_values Stores the Field A values associated with the given scan (Default: NULL => Not wanted)
+   * \param *sick_field_b_values Stores the Field B values associated with the given scan (Default: NULL => Not wanted)
+   * \param *sick_field_c_values Stores the Field C values associated with the given scan (Default: NULL => Not wanted)
+   * \param *sick_telegram_index The telegram index of the last partial scan (modulo: 256) (Default: NULL => Not wanted)
+   * \param *sick_real_time_scan_index The real time scan index of the last partial scan (module 256) (Default: NULL => Not wanted)
+   * \param *arrival_time When the first byte of the first partial scan arrived at the host, CLOCK_REALTIME (Default: NULL => Not wanted)
+   *
+   * NOTE: This function will set the device to interlaced mode. The partial
+   *       scans are filed by their index and scan index (real-time if enabled,
+   *       telegram otherwise), and the scan is returned as soon as all of its
+   *       partial scans are in. If one is lost, the scan is returned when the
+   *       next scan begins, w/ the missing values zeroed (or interpolated, see
+   *       SetSickPartialScanInterpolation) and flagged in missing_partial_scans.
+   *
+   * NOTE: The current angular resolution sets the number of partial scans. At
+   *       0.25 deg there are four (0.00, 0.25, 0.50 and 0.75 deg), at 0.5 deg
+   *       two, and at 1 deg each partial scan is already whole.
+   *
+   * NOTE: Partial scans left unread between calls are picked up by the next
+   *       call, so calling this in a loop returns every interlaced scan the
+   *       device streams.
+   */
+  void SickLMS2xx::GetSickInterlacedScan( unsigned int * const measurement_values,
+					unsigned int & num_measurement_values,
+					unsigned int & missing_partial_scans,
+					unsigned int * const sick_field_a_values,
+					unsigned int * const sick_field_b_values,
+					unsigned int * const sick_field_c_values,
+					unsigned int * const sick_telegram_index,
+					unsigned int * const sick_real_time_scan_index,
+					struct timespec * const arrival_time ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
+
+    /* Ensure the device is initialized */
+    if (!_sick_initialized) {
+      throw SickConfigException("SickLMS2xx::GetSickInterlacedScan: Sick LMS is not initialized!");
+    }
+    
+    /* Declare message objects */
+    SickLMS2xxMessage response;
+    
+    try {
+
+      /* Restore original operating mode */
+      _setSickOpModeMonitorStreamValuesFromPartialScan();
 
-	/* Copy the measurement value */
-	measurement_values[i] = sick_scan_profile.sick_measurements[i];
+      /* Partial scans are decoded into the interlacer's own buffers */
+      sick_lms_2xx_scan_dest_t sick_partial_scan, sick_scan_dest;
+      _setSickScanDest(sick_partial_scan,_sick_interlacer.partial_values,NULL,_sick_interlacer.partial_field_a_values,
+		       _sick_interlacer.partial_field_b_values,_sick_interlacer.partial_field_c_values);
+      _setSickScanDest(sick_scan_dest,measurement_values,NULL,sick_field_a_values,sick_field_b_values,sick_field_c_values);
+      struct timespec scan_arrival_time;
 
-	/* If requested, copy field A values */
-	if(sick_field_a_values) {
-	  sick_field_a_values[i] = sick_scan_profile.sick_field_a_values[i];
+      /* Feed the interlacer until it hands over a scan (it must within two scans' worth) */
+      for (unsigned int num_partial_scans_read = 0, num_frames_skipped = 0; ; ) {
+
+	if (num_partial_scans_read == 2*SICK_MAX_NUM_PARTIAL_SCANS) {
+	  throw SickIOException("SickLMS2xx::GetSickInterlacedScan: Partial scans don't fit the scan area!");
 	}
 
-	/* If requested, copy field B values */
-	if(sick_field_b_values) {
-	  sick_field_b_values[i] = sick_scan_profile.sick_field_b_values[i];
+	if (num_frames_skipped == 2*SICK_MAX_NUM_PARTIAL_SCANS) {
+	  throw SickIOException("SickLMS2xx::GetSickInterlacedScan: Not streaming partial scans!");
+	}
+	
+	/* Receive a data frame from the stream. */
+	_recvMessage(response,DEFAULT_SICK_LMS_2XX_SICK_MESSAGE_TIMEOUT);
+      
+	/* Only partial scans (0xB0) are interlaced, anything left over from another mode is skipped */
+	if(response.GetCommandCode() != 0xB0) {
+	  num_frames_skipped++;
+	  continue;
 	}
 
-	/* If requested, copy field C values */
-	if(sick_field_c_values) {
-	  sick_field_c_values[i] = sick_scan_profile.sick_field_c_values[i];
+	if (!_decodeSickScan(response.GetPayloadPtr(),response.GetPayloadLength(),sick_partial_scan)) {
+	  throw SickIOException("SickLMS2xx::GetSickInterlacedScan: Malformed scan!");
 	}
 
+	num_partial_scans_read++;
+
+	if (_interlaceSickPartialScan(_sick_interlacer,sick_partial_scan,response.GetArrivalTime(),sick_scan_dest,scan_arrival_time)) {
+	  break;
+	}
+	
       }
 
+      /* Return the requested values! */
+      num_measurement_values = sick_scan_dest.num_measurement_values;
+      missing_partial_scans = sick_scan_dest.sick_missing_partial_scans;
+
       /* If requested, copy the real time scan index */
       if(sick_real_time_scan_index) {
-	*sick_real_time_scan_index = sick_scan_profile.sick_real_time_scan_index;
+	*sick_real_time_scan_index = sick_scan_dest.sick_real_time_scan_index;
       }
       
       /* If requested, copy the telegram index */
       if(sick_telegram_index) {
-	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
+	*sick_telegram_index = sick_scan_dest.sick_telegram_index;
+      }
+
+      /* If requested, copy the arrival time */
+      if(arrival_time) {
+	*arrival_time = scan_arrival_time;
       }
 
     }
@@ -1495,7 +1555,7 @@ namespace SickToolbox {
     
     /* Handle anything else */
     catch(...) {
-      std::cerr << "SickLMS2xx::GetSickPartialScan: Unknown exception!!!" << std::endl;
+      std::cerr << "SickLMS2xx::GetSickInterlacedScan: Unknown exception!!!" << std::endl;
       throw;
     }
 
@@ -1508,6 +1568,7 @@ namespace SickToolbox {
    * \param &num_measurement_values Number of values stored in measurement_values
    * \param *sick_telegram_index The telegram index assigned to the message (modulo: 256) (Default: NULL => Not wanted)
    * \param *sick_real_time_scan_index The real time scan index for the latest message (module 256) (Default: NULL => Not wanted)
+   * \param *arrival_time When the first byte of the scan arrived at the host, CLOCK_REALTIME (Default: NULL => Not wanted)
    *
    * NOTE: Calling this function will return either range or reflectivity measurements
    *       depending upon the current measuring mode of the device.
@@ -1519,7 +1580,8 @@ namespace SickToolbox {
 				   unsigned int * const measurement_values,
 				   unsigned int & num_measurement_values,
 				   unsigned int * const sick_telegram_index,
-				   unsigned int * const sick_real_time_scan_index ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
+				   unsigned int * const sick_real_time_scan_index,
+				   struct timespec * const arrival_time ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
 
     /* Ensure the device is initialized */
     if (!_sick_initialized) {
@@ -1529,9 +1591,6 @@ namespace SickToolbox {
     /* Declare message objects */
     SickLMS2xxMessage response;
 
-    /* Declare some useful variables and a buffer */
-    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
     try {
 
       /* Restore original operating mode */
@@ -1545,34 +1604,29 @@ namespace SickToolbox {
 	throw SickIOException("SickLMS2xx::GetSickMeanValues: Unexpected message!");
       }
 
-      /* Acquire the payload buffer and length*/
-      response.GetPayload(payload_buffer);
-
-      /* Define a local scan profile object */
-      sick_lms_2xx_scan_profile_b6_t sick_scan_profile;
-
-      /* Initialize the profile */
-      memset(&sick_scan_profile,0,sizeof(sick_lms_2xx_scan_profile_b6_t));
-
-      /* Parse the message payload */
-      _parseSickScanProfileB6(&payload_buffer[1],sick_scan_profile);
-
-      /* Return the request values! */
-      num_measurement_values = sick_scan_profile.sick_num_measurements;
-
-      for (unsigned int i = 0; i < num_measurement_values; i++) {
-	/* Copy the measurement value */
-	measurement_values[i] = sick_scan_profile.sick_measurements[i];
+      /* Decode straight into the caller's buffers */
+      sick_lms_2xx_scan_dest_t sick_scan_dest;
+      _setSickScanDest(sick_scan_dest,measurement_values);
+      if (!_decodeSickScan(response.GetPayloadPtr(),response.GetPayloadLength(),sick_scan_dest)) {
+	throw SickIOException("SickLMS2xx::GetSickMeanValues: Malformed scan!");
       }
 
+      /* Return the requested values! */
+      num_measurement_values = sick_scan_dest.num_measurement_values;
+
       /* If requested, copy the real time scan index */
       if(sick_real_time_scan_index) {
-	*sick_real_time_scan_index = sick_scan_profile.sick_real_time_scan_index;
+	*sick_real_time_scan_index = sick_scan_dest.sick_real_time_scan_index;
       }
       
       /* If requested, copy the telegram index */
       if(sick_telegram_index) {
-	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
+	*sick_telegram_index = sick_scan_dest.sick_telegram_index;
+      }
+
+      /* If requested, copy the arrival time */
+      if(arrival_time) {
+	*arrival_time = response.GetArrivalTime();
       }
 
     }
@@ -1618,6 +1672,7 @@ namespace SickToolbox {
    * \param &num_measurement_values Number of values stored in measurement_values
    * \param *sick_telegram_index The telegram index assigned to the message (modulo: 256) (Default: NULL => Not wanted)
    * \param *sick_real_time_scan_index The real time scan index for the latest message (module 256) (Default: NULL => Not wanted)
+   * \param *arrival_time When the first byte of the scan arrived at the host, CLOCK_REALTIME (Default: NULL => Not wanted)
    *
    * NOTE: Calling this function will return either range or reflectivity measurements
    *       depending upon the current measuring mode of the device.
@@ -1635,7 +1690,8 @@ namespace SickToolbox {
 					   unsigned int * const measurement_values,
 					   unsigned int & num_measurement_values,
 					   unsigned int * const sick_telegram_index,
-					   unsigned int * const sick_real_time_scan_index ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
+					   unsigned int * const sick_real_time_scan_index,
+					   struct timespec * const arrival_time ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException) {
 
     /* Ensure the device is initialized */
     if (!_sick_initialized) {
@@ -1645,9 +1701,6 @@ namespace SickToolbox {
     /* Declare message objects */
     SickLMS2xxMessage response;
 
-    /* Declare some useful variables and a buffer */
-    uint8_t payload_buffer[SickLMS2xxMessage::MESSAGE_PAYLOAD_MAX_LENGTH] = {0};
-    
     try {
     
       /* Restore original operating mode */
@@ -1661,36 +1714,29 @@ namespace SickToolbox {
 	throw SickIOException("SickLMS2xx::GetSickMeanValuesSubrange: Unexpected message!");
       }
 
-      /* Acquire the payload buffer and length*/
-      response.GetPayload(payload_buffer);
-
-      /* Define a local scan profile object */
-      sick_lms_2xx_scan_profile_bf_t sick_scan_profile;
-
-      /* Initialize the profile */
-      memset(&sick_scan_profile,0,sizeof(sick_lms_2xx_scan_profile_bf_t));
-
-      /* Parse the message payload */
-      _parseSickScanProfileBF(&payload_buffer[1],sick_scan_profile);
-
-      /* Return the request values! */
-      num_measurement_values = sick_scan_profile.sick_num_measurements;
-
-      for (unsigned int i = 0; i < num_measurement_values; i++) {
-
-	/* Copy the measurement value */
-	measurement_values[i] = sick_scan_profile.sick_measurements[i];
-
+      /* Decode straight into the caller's buffers */
+      sick_lms_2xx_scan_dest_t sick_scan_dest;
+      _setSickScanDest(sick_scan_dest,measurement_values);
+      if (!_decodeSickScan(response.GetPayloadPtr(),response.GetPayloadLength(),sick_scan_dest)) {
+	throw SickIOException("SickLMS2xx::GetSickMeanValuesSubrange: Malformed scan!");
       }
 
+      /* Return the requested values! */
+      num_measurement_values = sick_scan_dest.num_measurement_values;
+
       /* If requested, copy the real time scan index */
       if(sick_real_time_scan_index) {
-	*sick_real_time_scan_index = sick_scan_profile.sick_real_time_scan_index;
+	*sick_real_time_scan_index = sick_scan_dest.sick_real_time_scan_index;
       }
       
       /* If requested, copy the telegram index */
       if(sick_telegram_index) {
-	*sick_telegram_index = sick_scan_profile.sick_telegram_index;
+	*sick_telegram_index = sick_scan_dest.sick_telegram_index;
+      }
+
+      /* If requested, copy the arrival time */
+      if(arrival_time) {
+	*arrival_time = response.GetArrivalTime();
       }
 
     }
@@ -1727,6 +1773,110 @@ namespace SickToolbox {
 
   }
 
+  /**
+   * \brief Registers a callback to receive each streamed scan as soon as it is decoded
+   * \param scan_callback The function to call w/ each scan
+   * \param *callback_args Passed through to the callback
+   * \return An id for unregistering the callback
+   *
+   * NOTE: Scans are delivered from whichever streaming mode the device is
+   *       in (e.g. as selected by the last GetSickScan* call). If it isn't
+   *       streaming scans, it is switched to stream all measured values.
+   *       While streaming partial scans, SetSickPartialScanAssembly(true)
+   *       has the callbacks get whole interlaced scans instead.
+   *
+   * NOTE: Callbacks run on the buffer monitor's thread (or the reactor's),
+   *       so they must not block. They may unregister callbacks (their own
+   *       included), but must not otherwise call back into the driver. While any callback is registered, scans are handed to
+   *       the callbacks rather than queued, so the GetSickScan* and
+   *       GetSickMeanValues* methods should not be used at the same time.
+   */
+  unsigned int SickLMS2xx::RegisterSickScanCallback( const sick_lms_2xx_scan_callback_t scan_callback, void * const callback_args )
+    throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException ) {
+
+    /* Ensure the device is initialized */
+    if (!_sick_initialized) {
+      throw SickConfigException("SickLMS2xx::RegisterSickScanCallback: Sick LMS is not initialized!");
+    }
+
+    unsigned int callback_id = 0;
+
+    try {
+
+      callback_id = _sick_scan_subscribers.Subscribe(scan_callback,callback_args);
+
+      /* Make sure scans are actually arriving (w/o them, the caller never gets the id, so drop the callback) */
+      try {
+	
+	switch(_sick_operating_status.sick_operating_mode) {
+	case SICK_OP_MODE_MONITOR_STREAM_VALUES:
+	case SICK_OP_MODE_MONITOR_STREAM_MEAN_VALUES:
+	case SICK_OP_MODE_MONITOR_STREAM_VALUES_SUBRANGE:
+	case SICK_OP_MODE_MONITOR_STREAM_MEAN_VALUES_SUBRANGE:
+	case SICK_OP_MODE_MONITOR_STREAM_VALUES_FROM_PARTIAL_SCAN:
+	case SICK_OP_MODE_MONITOR_STREAM_RANGE_AND_REFLECT:
+	  break;
+	default:
+	  _setSickOpModeMonitorStreamValues();
+	}
+
+      }
+      catch(...) {
+	_sick_scan_subscribers.Unsubscribe(callback_id);
+	throw;
+      }
+
+    }
+
+    /* Handle any config exceptions */
+    catch(SickConfigException &sick_config_exception) {
+      std::cerr << sick_config_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle a timeout exception */
+    catch(SickTimeoutException &sick_timeout_exception) {
+      std::cerr << sick_timeout_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle any I/O exceptions */
+    catch(SickIOException &sick_io_exception) {
+      std::cerr << sick_io_exception.what() << std::endl;
+      throw;
+    }
+
+    /* Handle any thread exceptions */
+    catch(SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+      throw;
+    }
+    
+    /* Handle anything else */
+    catch(...) {
+      std::cerr << "SickLMS2xx::RegisterSickScanCallback: Unknown exception!!!" << std::endl;
+      throw;
+    }
+
+    return callback_id;
+
+  }
+
+  /**
+   * \brief Unregisters a scan callback
+   * \param callback_id The id returned by RegisterSickScanCallback
+   *
+   * NOTE: The callback will not be called once this returns. The device
+   *       keeps streaming (the GetSickScan* methods may be used again).
+   */
+  void SickLMS2xx::UnregisterSickScanCallback( const unsigned int callback_id ) throw( SickThreadException ) {
+
+    if (!_sick_scan_subscribers.Unsubscribe(callback_id)) {
+      std::cerr << "SickLMS2xx::UnregisterSickScanCallback: Unknown callback id!" << std::endl;
+    }
+
+  }
+
   /**
    * \brief Acquire the Sick LMS 2xx status
    * \return The status of the device
@@ -2389,6 +2539,7 @@ namespace SickToolbox {
       _sick_buffer_monitor->AcquireDataStream();
 
       /* Nobody is reading a message, so safely flush! */
+      _sick_buffer_monitor->FlushRecvBuffer();
       if (tcflush(_sick_fd,TCIOFLUSH) != 0) {
       	throw SickThreadException("SickLMS2xx::_flushTerminalBuffer: tcflush() failed!");
       }
@@ -2478,10 +2629,7 @@ namespace SickToolbox {
 
     try {
 
-      /* Attempt to flush the terminal buffer */
-      _flushTerminalBuffer();
-      
-      /* Send a message and get reply using parent's method */
+      /* Send a message and get reply using parent's method (stale replies are discarded by the monitor, so streamed scans needn't be flushed) */
       SickLIDAR< SickLMS2xxBufferMonitor, SickLMS2xxMessage >::_sendMessageAndGetReply(send_message,recv_message,&reply_code,1,DEFAULT_SICK_LMS_2XX_BYTE_INTERVAL,timeout_value,num_tries);
 
     }
@@ -2661,6 +2809,9 @@ namespace SickToolbox {
 	/* Set the custom devisor */
 	serial.flags |= ASYNC_SPD_CUST;
 	serial.custom_divisor = 48; // for FTDI USB/serial converter divisor is 240/5
+
+	/* Have the converter hand over partial packets promptly (FTDI drops its latency timer to 1ms) */
+	serial.flags |= ASYNC_LOW_LATENCY;
 	
 	/* Set the new attibute values */
 	if(ioctl(_sick_fd,TIOCSSERIAL,&serial) < 0) {
@@ -2684,7 +2835,7 @@ namespace SickToolbox {
 	}
 	
 	serial.custom_divisor = 0;
-        serial.flags &= ~ASYNC_SPD_CUST;
+        serial.flags &= ~(ASYNC_SPD_CUST | ASYNC_LOW_LATENCY);
 	
 	if(ioctl(_sick_fd,TIOCSSERIAL,&serial) < 0) {
 	  std::cerr << "SickLMS2xx::_setTerminalBaud: ioctl() failed while trying to set serial port info!" << std::endl;
@@ -3800,6 +3951,10 @@ namespace SickToolbox {
       
       try {
 
+	/* Interlace the new stream afresh (before any of it can arrive) */
+	_resetSickInterlacer(_sick_scan_interlacer);
+	_resetSickInterlacer(_sick_interlacer);
+
 	/* Attempt to switch modes */
 	_switchSickOperatingMode(SICK_OP_MODE_MONITOR_STREAM_VALUES_FROM_PARTIAL_SCAN);
 
@@ -4265,6 +4420,9 @@ namespace SickToolbox {
       throw SickConfigException("SickLMS2xx::_switchSickOperatingMode: Unrecognized operating mode!");
     }
 
+    /* Follow the telegram index afresh (before the new mode's first telegram can arrive) */
+    _restartScanSequence();
+
     try {
 
       /* Attempt to send the message and get the reply */
@@ -4307,191 +4465,478 @@ namespace SickToolbox {
       throw SickConfigException("SickLMS2xx::_switchSickOperatingMode: configuration request failed!");
     }
 
+    /*
+     * Anything the previous mode streamed arrived ahead of the reply, so
+     * it is all queued by now and none of it belongs to the new mode.
+     */
+    _sick_buffer_monitor->FlushMessageQueue();
+
   }
 
   /**
-   * \brief Parses a byte sequence into a scan profile corresponding to message B0
-   * \param *src_buffer The byte sequence to be parsed
-   * \param &sick_scan_profile The returned scan profile for the current round of measurements
+   * \brief Decodes streamed scans and hands them to the subscribers
+   * \param &sick_message A message framed by the buffer monitor
+   * \param *handler_args The driver instance
+   * \return True if the message was consumed, False if it should be queued
    */
-  void SickLMS2xx::_parseSickScanProfileB0( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_b0_t &sick_scan_profile ) const {
+  bool SickLMS2xx::_scanMessageHandler( SickLMS2xxMessage &sick_message, void * handler_args ) {
 
-    /* Read block A, the number of measurments */
-    sick_scan_profile.sick_num_measurements = src_buffer[0] + 256*(src_buffer[1] & 0x03);
+    SickLMS2xx *sick_lms = (SickLMS2xx *)handler_args;
 
-    /* Check whether this is a partial scan */
-    sick_scan_profile.sick_partial_scan_index = ((src_buffer[1] & 0x18) >> 3);
-
-    /* Extract the measurements and Field values (if there are any) */
-    _extractSickMeasurementValues(&src_buffer[2],
-				  sick_scan_profile.sick_num_measurements,
-				  sick_scan_profile.sick_measurements,
-				  sick_scan_profile.sick_field_a_values,
-				  sick_scan_profile.sick_field_b_values,
-				  sick_scan_profile.sick_field_c_values);
-    
-    /* If the Sick is pulling real-time indices then pull them too */
-    unsigned int data_offset = 2 + 2*sick_scan_profile.sick_num_measurements;
-    if (_returningRealTimeIndices()) {
-      sick_scan_profile.sick_real_time_scan_index = src_buffer[data_offset];
-      data_offset++;
+    /* Leave everything to the pull API unless somebody is listening */
+    if (!sick_lms->_sick_scan_subscribers.HasSubscribers()) {
+      return false;
     }
 
-    /* Buffer the Sick telegram index */
-    sick_scan_profile.sick_telegram_index = src_buffer[data_offset];
-    
+    sick_lms_2xx_scan_data_t &sick_scan = sick_lms->_sick_scan_data;
+    sick_lms_2xx_scan_dest_t sick_scan_dest;
+    sick_lms->_setSickScanDest(sick_scan_dest,sick_scan.measurement_values,sick_scan.reflect_values,
+			       sick_scan.sick_field_a_values,sick_scan.sick_field_b_values,sick_scan.sick_field_c_values);
+
+    /* Partial scans are interlaced if asked (the rest are decoded straight into the subscribers' scan) */
+    if (sick_lms->_sick_partial_scan_assembly && sick_message.GetCommandCode() == 0xB0 &&
+	sick_lms->_sick_operating_status.sick_operating_mode == SICK_OP_MODE_MONITOR_STREAM_VALUES_FROM_PARTIAL_SCAN) {
+
+      /* Partial scans are decoded into the interlacer's own buffers */
+      sick_lms_2xx_interlacer_t &sick_interlacer = sick_lms->_sick_scan_interlacer;
+      sick_lms_2xx_scan_dest_t sick_partial_scan;
+      sick_lms->_setSickScanDest(sick_partial_scan,sick_interlacer.partial_values,NULL,sick_interlacer.partial_field_a_values,
+				 sick_interlacer.partial_field_b_values,sick_interlacer.partial_field_c_values);
+
+      if (!sick_lms->_decodeSickScan(sick_message.GetPayloadPtr(),sick_message.GetPayloadLength(),sick_partial_scan)) {
+	return false;
+      }
+
+      /* Nothing to hand over until the interlaced scan is done */
+      if (!sick_lms->_interlaceSickPartialScan(sick_interlacer,sick_partial_scan,sick_message.GetArrivalTime(),
+					       sick_scan_dest,sick_scan.arrival_time)) {
+	return true;
+      }
+
+    }
+    else {
+
+      /* Anything else is left for the pull API */
+      if (!sick_lms->_decodeSickScan(sick_message.GetPayloadPtr(),sick_message.GetPayloadLength(),sick_scan_dest)) {
+	return false;
+      }
+
+      sick_scan.arrival_time = sick_message.GetArrivalTime();
+
+    }
+
+    sick_scan.sick_reply_code = sick_message.GetCommandCode();
+    sick_scan.num_measurement_values = sick_scan_dest.num_measurement_values;
+    sick_scan.num_reflect_values = sick_scan_dest.num_reflect_values;
+    sick_scan.sick_telegram_index = sick_scan_dest.sick_telegram_index;
+    sick_scan.sick_real_time_scan_index = sick_scan_dest.sick_real_time_scan_index;
+    sick_scan.sick_partial_scan_index = sick_scan_dest.sick_partial_scan_index;
+    sick_scan.sick_missing_partial_scans = sick_scan_dest.sick_missing_partial_scans;
+    sick_scan.num_scans_lost = sick_lms->GetSickNumScansLostBeforeLast();
+
+    try {
+      sick_lms->_sick_scan_subscribers.Dispatch(sick_scan);
+    }
+
+    /* Handle any thread exceptions */
+    catch(SickThreadException &sick_thread_exception) {
+      std::cerr << sick_thread_exception.what() << std::endl;
+    }
+
+    /* Handle anything else */
+    catch(...) {
+      std::cerr << "SickLMS2xx::_scanMessageHandler: Unknown exception!!!" << std::endl;
+    }
+
+    return true;
+
   }
 
   /**
-   * \brief Parses a byte sequence into a scan profile corresponding to message B6
-   * \param *src_buffer The byte sequence to be parsed
-   * \param &sick_scan_profile The returned scan profile for the current round of mean measurements
+   * \brief Starts collecting interlaced scans afresh
+   * \param &sick_interlacer The interlacer to reset
+   *
+   * NOTE: The number of partial scans and values follow from the scan area
+   *       and resolution, so this should be called whenever the partial scan
+   *       stream is (re)started.
    */
-  void SickLMS2xx::_parseSickScanProfileB6( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_b6_t &sick_scan_profile ) const {
+  void SickLMS2xx::_resetSickInterlacer( sick_lms_2xx_interlacer_t &sick_interlacer ) const {
 
-    /* Read Block A, the sample size used in computing the mean return */
-    sick_scan_profile.sick_sample_size = src_buffer[0];
+    const unsigned int sick_scan_resolution = _sick_operating_status.sick_scan_resolution;
 
-    /* Read Block B, the number of measured values sent */
-    sick_scan_profile.sick_num_measurements = src_buffer[1] + 256*(src_buffer[2] & 0x03);
+    /* The partial scans step through one degree in 0.25 deg increments */
+    sick_interlacer.num_partial_scans = 1;
+    if (sick_scan_resolution > 0 && 100 % sick_scan_resolution == 0 && 100/sick_scan_resolution <= SICK_MAX_NUM_PARTIAL_SCANS) {
+      sick_interlacer.num_partial_scans = 100/sick_scan_resolution;
+    }
 
-    /* Read Block C, extract the range measurements and Field values (if there are any) */
-    _extractSickMeasurementValues(&src_buffer[3],
-				  sick_scan_profile.sick_num_measurements,
-				  sick_scan_profile.sick_measurements);
+    /* An interlaced scan has a value for each step of the resolution across the scan area */
+    sick_interlacer.num_measurement_values = 0;
+    if (sick_scan_resolution > 0) {
+      sick_interlacer.num_measurement_values = (100*_sick_operating_status.sick_scan_angle)/sick_scan_resolution + 1;
+    }
     
-    /* Read Block D, if the Sick is pulling real-time indices then pull them too */
-    unsigned int data_offset = 3 + 2*sick_scan_profile.sick_num_measurements;
-    if (_returningRealTimeIndices()) {
-      sick_scan_profile.sick_real_time_scan_index = src_buffer[data_offset];
-      data_offset++;
+    if (sick_interlacer.num_measurement_values > SICK_MAX_NUM_MEASUREMENTS) {
+      sick_interlacer.num_measurement_values = SICK_MAX_NUM_MEASUREMENTS;
     }
 
-    /* Read Block E, buffer the Sick telegram index */
-    sick_scan_profile.sick_telegram_index = src_buffer[data_offset];
+    sick_interlacer.partial_scans_present = 0;
+    sick_interlacer.scan_base_index = 0;
     
   }
-  
+
   /**
-   * \brief Parses a byte sequence into a scan profile corresponding to message B7
-   * \param *src_buffer The byte sequence to be parsed
-   * \param &sick_scan_profile The returned scan profile for the current round of mean measurements
+   * \brief Files a partial scan w/ the interlaced scan it belongs to
+   * \param &sick_interlacer The interlacer collecting the scan
+   * \param &sick_partial_scan The decoded partial scan (w/ field values)
+   * \param &partial_arrival_time When the partial scan arrived
+   * \param &sick_interlaced_scan Where to hand over an interlaced scan
+   * \param &interlaced_arrival_time When the first partial scan of a handed over scan arrived
+   * \return True if an interlaced scan was handed over, False otherwise
+   *
+   * NOTE: Partial scans of one interlaced scan are numbered consecutively, so
+   *       the scan index less the partial scan's slot keys the scan it belongs
+   *       to. A scan is handed over as soon as all of its slots are in, or when
+   *       a partial scan keyed to a later scan shows that it won't be.
    */
-  void SickLMS2xx::_parseSickScanProfileB7( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_b7_t &sick_scan_profile ) const {
+  bool SickLMS2xx::_interlaceSickPartialScan( sick_lms_2xx_interlacer_t &sick_interlacer, const sick_lms_2xx_scan_dest_t &sick_partial_scan,
+					      const struct timespec &partial_arrival_time, sick_lms_2xx_scan_dest_t &sick_interlaced_scan,
+					      struct timespec &interlaced_arrival_time ) const {
 
-    /* Read Block A, Sick LMS measured value subrange start index */
-    sick_scan_profile.sick_subrange_start_index = src_buffer[0] + 256*src_buffer[1];
+    const unsigned int num_partial_scans = sick_interlacer.num_partial_scans;
+    const unsigned int partial_scan_index = sick_partial_scan.sick_partial_scan_index;
 
-    /* Read Block B, Sick LMS measured value subrange stop index */
-    sick_scan_profile.sick_subrange_stop_index = src_buffer[2] + 256*src_buffer[3];
+    /* The partial scan index is in 0.25 deg steps, the slots in steps of the resolution */
+    if ((partial_scan_index*num_partial_scans) % SICK_MAX_NUM_PARTIAL_SCANS != 0) {
+      return false;
+    }
     
-    /* Read block C, the number of measurements */
-    sick_scan_profile.sick_num_measurements = src_buffer[4] + 256*(src_buffer[5] & 0x03);
+    const unsigned int slot = (partial_scan_index*num_partial_scans)/SICK_MAX_NUM_PARTIAL_SCANS;
 
-    /* Acquire the partial scan index (also in Block C) */
-    sick_scan_profile.sick_partial_scan_index = ((src_buffer[5] & 0x18) >> 3);
-    
-    /* Read Block D, extract the range measurements and Field values (if there are any) */
-    _extractSickMeasurementValues(&src_buffer[6],
-				  sick_scan_profile.sick_num_measurements,
-				  sick_scan_profile.sick_measurements,
-				  sick_scan_profile.sick_field_a_values,
-				  sick_scan_profile.sick_field_b_values,
-				  sick_scan_profile.sick_field_c_values);
+    /* Drop anything that doesn't fit the slot (e.g. a whole scan from before the stream switched) */
+    if (slot >= sick_interlacer.num_measurement_values ||
+	sick_partial_scan.num_measurement_values != (sick_interlacer.num_measurement_values - slot + num_partial_scans - 1)/num_partial_scans) {
+      return false;
+    }
+
+    /* Key the interlaced scan by the index slot 0 has (or would have) */
+    const unsigned int scan_index = _returningRealTimeIndices() ? sick_partial_scan.sick_real_time_scan_index : sick_partial_scan.sick_telegram_index;
+    const unsigned int scan_base_index = (scan_index + SICK_LMS_2XX_TELEGRAM_INDEX_MODULUS - slot) % SICK_LMS_2XX_TELEGRAM_INDEX_MODULUS;
     
-    /* Read Block E, if the Sick is pulling real-time indices then pull them too */
-    unsigned int data_offset = 6 + 2*sick_scan_profile.sick_num_measurements;
-    if (_returningRealTimeIndices()) {
-      sick_scan_profile.sick_real_time_scan_index = src_buffer[data_offset];
-      data_offset++;
+    bool scan_handed_over = false;
+
+    /* A partial scan of a later scan means the current one won't be completed */
+    if (sick_interlacer.partial_scans_present && scan_base_index != sick_interlacer.scan_base_index) {
+      _emitSickInterlacedScan(sick_interlacer,sick_interlaced_scan,interlaced_arrival_time);
+      scan_handed_over = true;
+    }
+
+    /* Ignore a repeated partial scan */
+    if (sick_interlacer.partial_scans_present & (1 << slot)) {
+      return scan_handed_over;
+    }
+
+    /* Start a new scan? */
+    if (!sick_interlacer.partial_scans_present) {
+      sick_interlacer.scan_base_index = scan_base_index;
+      sick_interlacer.arrival_time = partial_arrival_time;
+    }
+
+    /* Interleave the partial scan into its slot */
+    for (unsigned int i = 0, j = slot; i < sick_partial_scan.num_measurement_values; i++, j += num_partial_scans) {
+      sick_interlacer.measurement_values[j] = sick_partial_scan.measurement_values[i];
+      sick_interlacer.field_a_values[j] = sick_partial_scan.field_a_values[i];
+      sick_interlacer.field_b_values[j] = sick_partial_scan.field_b_values[i];
+      sick_interlacer.field_c_values[j] = sick_partial_scan.field_c_values[i];
     }
 
-    /* Read Block F, buffer the Sick telegram index */
-    sick_scan_profile.sick_telegram_index = src_buffer[data_offset];
+    sick_interlacer.partial_scans_present |= (1 << slot);
+    sick_interlacer.sick_telegram_index = sick_partial_scan.sick_telegram_index;
+    sick_interlacer.sick_real_time_scan_index = sick_partial_scan.sick_real_time_scan_index;
+
+    /*
+     * Hand the scan over as soon as it is whole. (A scan can't have been handed
+     * over above as well, since a single slot scan is handed over as it arrives.)
+     */
+    if (sick_interlacer.partial_scans_present == (1u << num_partial_scans) - 1) {
+      _emitSickInterlacedScan(sick_interlacer,sick_interlaced_scan,interlaced_arrival_time);
+      scan_handed_over = true;
+    }
+    
+    return scan_handed_over;
     
   }
 
   /**
-   * \brief Parses a byte sequence into a scan profile corresponding to message B6
-   * \param *src_buffer The byte sequence to be parsed
-   * \param &sick_scan_profile The returned scan profile for the current round of mean measurements
+   * \brief Hands over the interlaced scan collected so far
+   * \param &sick_interlacer The interlacer collecting the scan
+   * \param &sick_interlaced_scan Where to put the scan (field buffers may be NULL)
+   * \param &interlaced_arrival_time When the scan's first partial scan arrived
+   *
+   * NOTE: Missing values are zeroed, or set to the mean of their neighbours that
+   *       did arrive when interpolating. Interpolation blurs the edges of objects,
+   *       so it suits display better than it does geometry. Field values of a
+   *       missing partial scan are always zeroed.
    */
-  void SickLMS2xx::_parseSickScanProfileBF( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_bf_t &sick_scan_profile ) const {
+  void SickLMS2xx::_emitSickInterlacedScan( sick_lms_2xx_interlacer_t &sick_interlacer, sick_lms_2xx_scan_dest_t &sick_interlaced_scan,
+					    struct timespec &interlaced_arrival_time ) const {
 
-    /* Read Block A, the sample size used in computing the mean return */
-    sick_scan_profile.sick_sample_size = src_buffer[0];
+    const unsigned int num_partial_scans = sick_interlacer.num_partial_scans;
+    const unsigned int num_measurement_values = sick_interlacer.num_measurement_values;
+    const unsigned int partial_scans_present = sick_interlacer.partial_scans_present;
+    
+    unsigned int missing_partial_scans = 0;
 
-    /* Read Block B, Sick LMS measured value subrange start index */
-    sick_scan_profile.sick_subrange_start_index = src_buffer[1] + 256*src_buffer[2];
+    /* Fill in the slots that didn't arrive */
+    for (unsigned int slot = 0; slot < num_partial_scans; slot++) {
 
-    /* Read Block C, Sick LMS measured value subrange stop index */
-    sick_scan_profile.sick_subrange_stop_index = src_buffer[3] + 256*src_buffer[4];
-    
-    /* Read Block D, the number of measured values sent */
-    sick_scan_profile.sick_num_measurements = src_buffer[5] + 256*(src_buffer[6] & 0x3F);
+      if (partial_scans_present & (1 << slot)) {
+	continue;
+      }
+
+      /* Flag it by its partial scan index */
+      missing_partial_scans |= (1 << ((slot*SICK_MAX_NUM_PARTIAL_SCANS)/num_partial_scans));
+
+      for (unsigned int j = slot; j < num_measurement_values; j += num_partial_scans) {
+
+	unsigned int measurement_value = 0;
+
+	if (_sick_partial_scan_interpolation) {
+
+	  const bool prev_present = j > 0 && (partial_scans_present & (1 << ((j-1) % num_partial_scans)));
+	  const bool next_present = j+1 < num_measurement_values && (partial_scans_present & (1 << ((j+1) % num_partial_scans)));
+
+	  if (prev_present && next_present) {
+	    measurement_value = (sick_interlacer.measurement_values[j-1] + sick_interlacer.measurement_values[j+1])/2;
+	  }
+	  else if (prev_present) {
+	    measurement_value = sick_interlacer.measurement_values[j-1];
+	  }
+	  else if (next_present) {
+	    measurement_value = sick_interlacer.measurement_values[j+1];
+	  }
+	  
+	}
+
+	sick_interlacer.measurement_values[j] = measurement_value;
+	sick_interlacer.field_a_values[j] = 0;
+	sick_interlacer.field_b_values[j] = 0;
+	sick_interlacer.field_c_values[j] = 0;
+	
+      }
 
-    /* Read Block E, extract the mean measurements */
-    _extractSickMeasurementValues(&src_buffer[7],
-				  sick_scan_profile.sick_num_measurements,
-				  sick_scan_profile.sick_measurements);
-    
-    /* Read Block D, if the Sick is pulling real-time indices then pull them too */
-    unsigned int data_offset = 7 + 2*sick_scan_profile.sick_num_measurements;
-    if (_returningRealTimeIndices()) {
-      sick_scan_profile.sick_real_time_scan_index = src_buffer[data_offset];
-      data_offset++;
     }
 
-    /* Read Block E, buffer the Sick telegram index */
-    sick_scan_profile.sick_telegram_index = src_buffer[data_offset];
+    /* Hand over the requested values */
+    memcpy(sick_interlaced_scan.measurement_values,sick_interlacer.measurement_values,num_measurement_values*sizeof(unsigned int));
+
+    if (sick_interlaced_scan.field_a_values) {
+      memcpy(sick_interlaced_scan.field_a_values,sick_interlacer.field_a_values,num_measurement_values*sizeof(unsigned int));
+    }
+
+    if (sick_interlaced_scan.field_b_values) {
+      memcpy(sick_interlaced_scan.field_b_values,sick_interlacer.field_b_values,num_measurement_values*sizeof(unsigned int));
+    }
+
+    if (sick_interlaced_scan.field_c_values) {
+      memcpy(sick_interlaced_scan.field_c_values,sick_interlacer.field_c_values,num_measurement_values*sizeof(unsigned int));
+    }
+
+    sick_interlaced_scan.num_measurement_values = num_measurement_values;
+    sick_interlaced_scan.num_reflect_values = 0;
+    sick_interlaced_scan.sick_telegram_index = sick_interlacer.sick_telegram_index;
+    sick_interlaced_scan.sick_real_time_scan_index = sick_interlacer.sick_real_time_scan_index;
+    sick_interlaced_scan.sick_partial_scan_index = 0;
+    sick_interlaced_scan.sick_missing_partial_scans = missing_partial_scans;
+    interlaced_arrival_time = sick_interlacer.arrival_time;
+
+    /* Start over */
+    sick_interlacer.partial_scans_present = 0;
     
   }
-  
+
   /**
-   * \brief Parses a byte sequence into a scan profile corresponding to message C4
-   * \param *src_buffer The byte sequence to be parsed
-   * \param &sick_scan_profile The returned scan profile for the current round of measurements
+   * \brief Decodes a scan reply straight into the given buffers
+   * \param *payload_buffer The reply's payload (beginning w/ the reply code)
+   * \param payload_length The length of the reply's payload (in bytes)
+   * \param &sick_scan_dest Where to put the scan (its counts and indices are set too)
+   * \return True if the scan was decoded, False if it isn't a scan reply (or is malformed)
+   *
+   * NOTE: Each measured value is touched once, and only the fields that are
+   *       wanted are written. There is no intermediate profile to copy out of.
+   *       The counts come off the wire, so a reply is refused unless every
+   *       block they imply lies within its payload.
    */
-  void SickLMS2xx::_parseSickScanProfileC4( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_c4_t &sick_scan_profile ) const {
+  bool SickLMS2xx::_decodeSickScan( const uint8_t * const payload_buffer, const unsigned int payload_length,
+				    sick_lms_2xx_scan_dest_t &sick_scan_dest ) const {
 
-    /* Read block A - the number of range measurments.  We need the low two bits
-     * of the most significant byte. */
-    sick_scan_profile.sick_num_range_measurements = src_buffer[0] + 256*(src_buffer[1] & 0x03);
+    /* Time the decode */
+    struct timespec decode_beg_time;
+    clock_gettime(CLOCK_MONOTONIC,&decode_beg_time);
 
-    /* Read Block B - Extract the range measurements and Field values (if there are any) */
-    _extractSickMeasurementValues(&src_buffer[2],
-				  sick_scan_profile.sick_num_range_measurements,
-				  sick_scan_profile.sick_range_measurements,
-				  sick_scan_profile.sick_field_a_values,
-				  sick_scan_profile.sick_field_b_values,
-				  sick_scan_profile.sick_field_c_values);
+    if (payload_length == 0) {
+      return false;
+    }
     
-    /* Read Block D - Extract the number of range measurements */
-    unsigned int data_offset = 2 + 2*sick_scan_profile.sick_num_range_measurements;
-    sick_scan_profile.sick_num_reflect_measurements = src_buffer[data_offset] + 256*(src_buffer[data_offset+1] & 0x03);
-    data_offset += 2;
+    /* The reply's blocks follow the reply code */
+    const uint8_t * const src_buffer = &payload_buffer[1];
+    const unsigned int src_length = payload_length - 1;
+
+    /* The indices end the reply */
+    const unsigned int num_index_bytes = _returningRealTimeIndices() ? 2 : 1;
     
-    /* Read Block E - Extract the reflectivity value subrange start index */
-    sick_scan_profile.sick_reflect_subrange_start_index = src_buffer[data_offset] + 256*src_buffer[data_offset+1];
-    data_offset += 2;
+    unsigned int num_measurements = 0;
+    unsigned int data_offset = 0;
+    bool has_field_values = true;
 
-    /* Read Block F - Extract the reflectivity value subrange stop index */
-    sick_scan_profile.sick_reflect_subrange_stop_index = src_buffer[data_offset] + 256*src_buffer[data_offset+1];
-    data_offset += 2;
+    sick_scan_dest.num_reflect_values = 0;
+    sick_scan_dest.sick_real_time_scan_index = 0;
+    sick_scan_dest.sick_partial_scan_index = 0;
+    sick_scan_dest.sick_missing_partial_scans = 0;
 
-    /* Read blocks G...H. Mask out the reflectivity values and store in provided buffer. */
-    for(unsigned int i=0; i < sick_scan_profile.sick_num_reflect_measurements; i++,data_offset++) {
-      sick_scan_profile.sick_reflect_measurements[i] = src_buffer[data_offset];
+    /* Locate the measured values (the blocks ahead of them depend upon the reply) */
+    switch(payload_buffer[0]) {
+    case 0xB0: {
+
+      /* Block A, the number of measurements and the partial scan index */
+      if (src_length < 2) {
+	return false;
+      }
+      
+      num_measurements = src_buffer[0] + 256*(src_buffer[1] & 0x03);
+      sick_scan_dest.sick_partial_scan_index = ((src_buffer[1] & 0x18) >> 3);
+      data_offset = 2;
+      break;
+    }
+    case 0xB6: {
+
+      /* Block A is the sample size, Block B the number of mean values */
+      if (src_length < 3) {
+	return false;
+      }
+      
+      num_measurements = src_buffer[1] + 256*(src_buffer[2] & 0x03);
+      data_offset = 3;
+      has_field_values = false;
+      break;
+    }
+    case 0xB7: {
+
+      /* Blocks A and B are the subrange start/stop indices, Block C the number of measurements and the partial scan index */
+      if (src_length < 6) {
+	return false;
+      }
+      
+      num_measurements = src_buffer[4] + 256*(src_buffer[5] & 0x03);
+      sick_scan_dest.sick_partial_scan_index = ((src_buffer[5] & 0x18) >> 3);
+      data_offset = 6;
+      break;
+    }
+    case 0xBF: {
+
+      /* Block A is the sample size, Blocks B and C the subrange start/stop indices, Block D the number of mean values */
+      if (src_length < 7) {
+	return false;
+      }
+      
+      num_measurements = src_buffer[5] + 256*(src_buffer[6] & 0x3F);
+      data_offset = 7;
+      has_field_values = false;
+      break;
+    }
+    case 0xC4: {
+
+      /* Block A, the number of range measurements */
+      if (src_length < 2) {
+	return false;
+      }
+      
+      num_measurements = src_buffer[0] + 256*(src_buffer[1] & 0x03);
+      data_offset = 2;
+      break;
+    }
+    default:
+      return false;
+    }
+
+    /* Don't overrun the caller's buffers */
+    if (num_measurements > SICK_MAX_NUM_MEASUREMENTS) {
+      return false;
+    }
+
+    /* ...or the reply (C4 has at least Blocks D through F after the ranges) */
+    if (data_offset + 2*num_measurements + (payload_buffer[0] == 0xC4 ? 6 : 0) + num_index_bytes > src_length) {
+      return false;
     }
     
-    /* Read Block I - real-time scan indices */
+    sick_scan_dest.num_measurement_values = num_measurements;
+
+    /* Extract the measured values (and the field values, if the reply carries them) */
+    if (has_field_values) {
+      _extractSickMeasurementValues(&src_buffer[data_offset],num_measurements,
+				    sick_scan_dest.measurement_values,
+				    sick_scan_dest.field_a_values,
+				    sick_scan_dest.field_b_values,
+				    sick_scan_dest.field_c_values);
+    }
+    else {
+
+      _extractSickMeasurementValues(&src_buffer[data_offset],num_measurements,sick_scan_dest.measurement_values);
+
+      /* Mean values come w/o fields */
+      if (sick_scan_dest.field_a_values) {
+	memset(sick_scan_dest.field_a_values,0,num_measurements*sizeof(unsigned int));
+      }
+
+      if (sick_scan_dest.field_b_values) {
+	memset(sick_scan_dest.field_b_values,0,num_measurements*sizeof(unsigned int));
+      }
+
+      if (sick_scan_dest.field_c_values) {
+	memset(sick_scan_dest.field_c_values,0,num_measurements*sizeof(unsigned int));
+      }
+
+    }
+
+    data_offset += 2*num_measurements;
+    
+    /* C4 follows the ranges w/ a subrange of reflectivity values */
+    if (payload_buffer[0] == 0xC4) {
+
+      /* Block D, the number of reflectivity values */
+      sick_scan_dest.num_reflect_values = src_buffer[data_offset] + 256*(src_buffer[data_offset+1] & 0x03);
+      if (sick_scan_dest.num_reflect_values > SICK_MAX_NUM_MEASUREMENTS ||
+	  data_offset + 6 + sick_scan_dest.num_reflect_values + num_index_bytes > src_length) {
+	return false;
+      }
+
+      /* Blocks E and F are the reflectivity subrange start/stop indices */
+      data_offset += 6;
+
+      /* Blocks G...H, the reflectivity values */
+      if (sick_scan_dest.reflect_values) {
+	for (unsigned int i = 0; i < sick_scan_dest.num_reflect_values; i++) {
+	  sick_scan_dest.reflect_values[i] = src_buffer[data_offset+i];
+	}
+      }
+      
+      data_offset += sick_scan_dest.num_reflect_values;
+      
+    }
+    
+    /* If the Sick is pulling real-time indices then pull them too */
     if (_returningRealTimeIndices()) {
-      sick_scan_profile.sick_real_time_scan_index = src_buffer[data_offset];
+      sick_scan_dest.sick_real_time_scan_index = src_buffer[data_offset];
       data_offset++;
     }
 
-    /* Read Block J - the telegram scan index */
-    sick_scan_profile.sick_telegram_index = src_buffer[data_offset];
+    /* Buffer the Sick telegram index */
+    sick_scan_dest.sick_telegram_index = src_buffer[data_offset];
+    _recordScanCounter(sick_scan_dest.sick_telegram_index,SICK_LMS_2XX_TELEGRAM_INDEX_MODULUS);
+
+    _recordDecodeTime(decode_beg_time);
+
+    return true;
     
   }
   
@@ -4608,160 +5053,216 @@ namespace SickToolbox {
    * \param *field_a_values Stores the Field A values associated with the given measurements (Default: NULL => Not wanted)
    * \param *field_b_values Stores the Field B values associated with the given measurements (Default: NULL => Not wanted)
    * \param *field_c_values Stores the Field C values associated with the given measurements (Default: NULL => Not wanted)
+   *
+   * NOTE: Fields the measuring mode doesn't carry are returned as zero.
    */
-  void SickLMS2xx::_extractSickMeasurementValues( const uint8_t * const byte_sequence, const uint16_t num_measurements, uint16_t * const measured_values,
-					       uint8_t * const field_a_values, uint8_t * const field_b_values, uint8_t * const field_c_values ) const {
+  void SickLMS2xx::_extractSickMeasurementValues( const uint8_t * const byte_sequence, const uint16_t num_measurements, unsigned int * const measured_values,
+						  unsigned int * const field_a_values, unsigned int * const field_b_values,
+						  unsigned int * const field_c_values ) const {
 
-    /* Parse the byte sequence and fill the return buffer with range measurements... */   
+    /* The bits of each value's high byte holding the measurement and the field flags */
+    uint8_t value_mask = 0, field_a_mask = 0, field_b_mask = 0, field_c_mask = 0;
+    
     switch(_sick_device_config.sick_measuring_mode) {
     case SICK_MS_MODE_8_OR_80_FA_FB_DAZZLE:
-      {
+    case SICK_MS_MODE_8_OR_80_FA_FB_FC:
+      value_mask = 0x1F;
+      field_a_mask = 0x20;
+      field_b_mask = 0x40;
+      field_c_mask = 0x80;
+      break;
+    case SICK_MS_MODE_8_OR_80_REFLECTOR:
+      value_mask = 0x1F;
+      field_a_mask = 0xE0;
+      break;
+    case SICK_MS_MODE_16_REFLECTOR:
+      value_mask = 0x3F;
+      field_a_mask = 0xC0;
+      break;
+    case SICK_MS_MODE_16_FA_FB:
+      value_mask = 0x3F;
+      field_a_mask = 0x40;
+      field_b_mask = 0x80;
+      break;
+    case SICK_MS_MODE_32_REFLECTOR:
+    case SICK_MS_MODE_32_FA:
+      value_mask = 0x7F;
+      field_a_mask = 0x80;
+      break;
+    case SICK_MS_MODE_32_IMMEDIATE:
+    case SICK_MS_MODE_REFLECTIVITY:
+      value_mask = 0xFF;
+      break;
+    default: {
 
-	/* Extract the range and Field values */
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1] & 0x1F);
+      /* Nothing can be made of the values in an unknown mode */
+      memset(measured_values,0,num_measurements*sizeof(unsigned int));
 
-	  if(field_a_values) {  
-	    field_a_values[i] = byte_sequence[i*2+1] & 0x20;
-	  }
-	  
-	  if(field_b_values) {
-	    field_b_values[i] = byte_sequence[i*2+1] & 0x40;
-	  }
-	  
-	  if(field_c_values) {
-	    field_c_values[i] = byte_sequence[i*2+1] & 0x80;
-	  }
-	  
-	}
-	
-	break;
+      if (field_a_values) {
+	memset(field_a_values,0,num_measurements*sizeof(unsigned int));
       }
-    case SICK_MS_MODE_8_OR_80_REFLECTOR:
-      {
-	
-	/* Extract the range and Field A */
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1] & 0x1F);
-	  
-	  if(field_a_values) {
-	    field_a_values[i] = byte_sequence[i*2+1] & 0xE0;
-	  }
-	  
-	}
-	
-	break;
-      }     
-    case SICK_MS_MODE_8_OR_80_FA_FB_FC:
-      {
-	
-	/* Extract the range and Fields A,B and C */	
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1] & 0x1F);
-	  
-	  if(field_a_values) {
-	    field_a_values[i] = byte_sequence[i*2+1] & 0x20;
-	  }
-	  
-	  if(field_b_values) {
-	    field_b_values[i] = byte_sequence[i*2+1] & 0x40;
-	  }
-	  
-	  if(field_c_values) {
-	    field_c_values[i] = byte_sequence[i*2+1] & 0x80;
-	  }
-	  
-	}
-	
-	break;
+
+      if (field_b_values) {
+	memset(field_b_values,0,num_measurements*sizeof(unsigned int));
+      }
+
+      if (field_c_values) {
+	memset(field_c_values,0,num_measurements*sizeof(unsigned int));
       }
-    case SICK_MS_MODE_16_REFLECTOR:
-      {
 
-	/* Extract the range and reflector values */
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1] & 0x3F);
+      return;
+    }
+    }
 
-	  if (field_a_values) {
-	    field_a_values[i] = byte_sequence[i*2+1] & 0xC0;
-	  }
-	  
-	}
-	
-	break;
+    /* Specialize on the outputs that are wanted (most callers only want the measurements) */
+    if (!field_a_values && !field_b_values && !field_c_values) {
+
+      /* The vector unit takes whole blocks, the rest are done here */
+      for (unsigned int i = _extractSickMeasurementBlocks(byte_sequence,num_measurements,value_mask,measured_values); i < num_measurements; i++) {
+	measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1] & value_mask);
       }
-    case SICK_MS_MODE_16_FA_FB:
-      {
 
-	/* Extract the range and Fields A and B values */
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1] & 0x3F);
+      return;
+    }
 
-	  if(field_a_values) {
-	    field_a_values[i] = byte_sequence[i*2+1] & 0x40;
-	  }
+    /* Unwanted fields land in scratch space so the loops needn't test for them */
+    unsigned int field_scratch[SICK_MAX_NUM_MEASUREMENTS];
+    unsigned int * const field_a_dest = field_a_values ? field_a_values : field_scratch;
+    unsigned int * const field_b_dest = field_b_values ? field_b_values : field_scratch;
+    unsigned int * const field_c_dest = field_c_values ? field_c_values : field_scratch;
 
-	  if(field_b_values) {
-	    field_b_values[i] = byte_sequence[i*2+1] & 0x80;
-	  }
+    /* Extract the values and fields in a single pass over the bytes (whole blocks on the vector unit) */
+    for (unsigned int i = _extractSickMeasurementBlocks(byte_sequence,num_measurements,value_mask,measured_values,
+							field_a_mask,field_b_mask,field_c_mask,
+							field_a_dest,field_b_dest,field_c_dest); i < num_measurements; i++) {
 
-	}
-	
-	break;
-      }
-    case SICK_MS_MODE_32_REFLECTOR:
-      {
+      const uint8_t high_byte = byte_sequence[i*2+1];
 
-	/* Extract the range and reflector values */
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1] & 0x7F);
+      measured_values[i] = byte_sequence[i*2] + 256*(high_byte & value_mask);
+      field_a_dest[i] = high_byte & field_a_mask;
+      field_b_dest[i] = high_byte & field_b_mask;
+      field_c_dest[i] = high_byte & field_c_mask;
 
-	  if(field_a_values) {
-	    field_a_values[i] = byte_sequence[i*2+1] & 0x80;
-	  }
-	  
-	}
-	
-	break;
-      }
-    case SICK_MS_MODE_32_FA:
-      {
+    }
+    
+  }
 
-	/* Extract the range and Field A values */
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1] & 0x7F);
+  /**
+   * \brief Extracts whole blocks of measured values (and field values) on the host's vector unit
+   * \param *byte_sequence The byte sequence holding the current measured values
+   * \param num_measurements The number of measurements given in the byte sequence
+   * \param value_mask The bits of each value's high byte holding the measurement
+   * \param *measured_values A buffer to hold the extracted measured values
+   * \param field_a_mask The bits of each value's high byte holding Field A (Default: 0)
+   * \param field_b_mask The bits of each value's high byte holding Field B (Default: 0)
+   * \param field_c_mask The bits of each value's high byte holding Field C (Default: 0)
+   * \param *field_a_values Stores the masked Field A bits (Default: NULL => No fields wanted)
+   * \param *field_b_values Stores the masked Field B bits (must be given w/ field_a_values)
+   * \param *field_c_values Stores the masked Field C bits (must be given w/ field_a_values)
+   * \return The number of leading measurements extracted (the caller does the rest)
+   *
+   * NOTE: Each 16-bit little-endian word is a measurement in its low byte and
+   *       the masked high byte, so a block of eight is just a couple of ANDs
+   *       and shifts followed by widening to unsigned int. SSE2 (x86-64) and
+   *       NEON (little-endian ARM) are baseline wherever they are compiled in,
+   *       so no runtime check is needed. Without either, nothing is extracted.
+   */
+  unsigned int SickLMS2xx::_extractSickMeasurementBlocks( const uint8_t * const byte_sequence, const unsigned int num_measurements,
+							  const uint8_t value_mask, unsigned int * const measured_values,
+							  const uint8_t field_a_mask, const uint8_t field_b_mask, const uint8_t field_c_mask,
+							  unsigned int * const field_a_values, unsigned int * const field_b_values,
+							  unsigned int * const field_c_values ) {
+
+    unsigned int i = 0;
+
+#if defined(SICK_LMS_2XX_EXTRACT_SSE2)
+
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i value_word_mask = _mm_set1_epi16((short)(0x00FF | (value_mask << 8)));
+
+    if (!field_a_values) {
+
+      for (; i + 8 <= num_measurements; i += 8) {
+
+	const __m128i values = _mm_and_si128(_mm_loadu_si128((const __m128i *)&byte_sequence[i*2]),value_word_mask);
+
+	_mm_storeu_si128((__m128i *)&measured_values[i],_mm_unpacklo_epi16(values,zero));
+	_mm_storeu_si128((__m128i *)&measured_values[i+4],_mm_unpackhi_epi16(values,zero));
 
-	  if(field_a_values) {
-	    field_a_values[i] = byte_sequence[i*2+1] & 0x80;
-	  }
-	  
-	}
-	
-	break;
       }
-    case SICK_MS_MODE_32_IMMEDIATE:
-      {
-	
-	/* Extract the range measurements (no flags for this mode */
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1]);
-	}
-	
-	break;
+
+      return i;
+    }
+
+    const __m128i field_a_word_mask = _mm_set1_epi16(field_a_mask);
+    const __m128i field_b_word_mask = _mm_set1_epi16(field_b_mask);
+    const __m128i field_c_word_mask = _mm_set1_epi16(field_c_mask);
+
+    for (; i + 8 <= num_measurements; i += 8) {
+
+      const __m128i words = _mm_loadu_si128((const __m128i *)&byte_sequence[i*2]);
+      const __m128i values = _mm_and_si128(words,value_word_mask);
+      const __m128i high_bytes = _mm_srli_epi16(words,8);
+      const __m128i field_a = _mm_and_si128(high_bytes,field_a_word_mask);
+      const __m128i field_b = _mm_and_si128(high_bytes,field_b_word_mask);
+      const __m128i field_c = _mm_and_si128(high_bytes,field_c_word_mask);
+
+      _mm_storeu_si128((__m128i *)&measured_values[i],_mm_unpacklo_epi16(values,zero));
+      _mm_storeu_si128((__m128i *)&measured_values[i+4],_mm_unpackhi_epi16(values,zero));
+      _mm_storeu_si128((__m128i *)&field_a_values[i],_mm_unpacklo_epi16(field_a,zero));
+      _mm_storeu_si128((__m128i *)&field_a_values[i+4],_mm_unpackhi_epi16(field_a,zero));
+      _mm_storeu_si128((__m128i *)&field_b_values[i],_mm_unpacklo_epi16(field_b,zero));
+      _mm_storeu_si128((__m128i *)&field_b_values[i+4],_mm_unpackhi_epi16(field_b,zero));
+      _mm_storeu_si128((__m128i *)&field_c_values[i],_mm_unpacklo_epi16(field_c,zero));
+      _mm_storeu_si128((__m128i *)&field_c_values[i+4],_mm_unpackhi_epi16(field_c,zero));
+
+    }
+
+#elif defined(SICK_LMS_2XX_EXTRACT_NEON)
+
+    const uint16x8_t value_word_mask = vdupq_n_u16((uint16_t)(0x00FF | (value_mask << 8)));
+
+    if (!field_a_values) {
+
+      for (; i + 8 <= num_measurements; i += 8) {
+
+	const uint16x8_t values = vandq_u16(vreinterpretq_u16_u8(vld1q_u8(&byte_sequence[i*2])),value_word_mask);
+
+	vst1q_u32((uint32_t *)&measured_values[i],vmovl_u16(vget_low_u16(values)));
+	vst1q_u32((uint32_t *)&measured_values[i+4],vmovl_u16(vget_high_u16(values)));
+
       }
-    case SICK_MS_MODE_REFLECTIVITY:
-      {
 
-	/* Extract the reflectivity values */
-	for(unsigned int i = 0; i < num_measurements; i++) {
-	  measured_values[i] = byte_sequence[i*2] + 256*(byte_sequence[i*2+1]);
-	}
-	
-	break;
-      }      
-    default:      
-      break;
+      return i;
     }
+
+    const uint16x8_t field_a_word_mask = vdupq_n_u16(field_a_mask);
+    const uint16x8_t field_b_word_mask = vdupq_n_u16(field_b_mask);
+    const uint16x8_t field_c_word_mask = vdupq_n_u16(field_c_mask);
+
+    for (; i + 8 <= num_measurements; i += 8) {
+
+      const uint16x8_t words = vreinterpretq_u16_u8(vld1q_u8(&byte_sequence[i*2]));
+      const uint16x8_t values = vandq_u16(words,value_word_mask);
+      const uint16x8_t high_bytes = vshrq_n_u16(words,8);
+      const uint16x8_t field_a = vandq_u16(high_bytes,field_a_word_mask);
+      const uint16x8_t field_b = vandq_u16(high_bytes,field_b_word_mask);
+      const uint16x8_t field_c = vandq_u16(high_bytes,field_c_word_mask);
+
+      vst1q_u32((uint32_t *)&measured_values[i],vmovl_u16(vget_low_u16(values)));
+      vst1q_u32((uint32_t *)&measured_values[i+4],vmovl_u16(vget_high_u16(values)));
+      vst1q_u32((uint32_t *)&field_a_values[i],vmovl_u16(vget_low_u16(field_a)));
+      vst1q_u32((uint32_t *)&field_a_values[i+4],vmovl_u16(vget_high_u16(field_a)));
+      vst1q_u32((uint32_t *)&field_b_values[i],vmovl_u16(vget_low_u16(field_b)));
+      vst1q_u32((uint32_t *)&field_b_values[i+4],vmovl_u16(vget_high_u16(field_b)));
+      vst1q_u32((uint32_t *)&field_c_values[i],vmovl_u16(vget_low_u16(field_c)));
+      vst1q_u32((uint32_t *)&field_c_values[i+4],vmovl_u16(vget_high_u16(field_c)));
+
+    }
+
+#endif
+
+    return i;
     
   }
   
@@ -18,6 +18,7 @@
 /* Implementation dependencies */
 #include <string>
 #include <iostream>
+#include <time.h>
 #include <termios.h>
 
 #include "SickLIDAR.hh"
@@ -25,6 +26,7 @@
 
 #include "SickLMS2xxBufferMonitor.hh"
 #include "SickLMS2xxMessage.hh"
+#include "SickSubscriberList.hh"
 
 /* Macro definitions */
 #define DEFAULT_SICK_LMS_2XX_SICK_BAUD                                       (B9600)  ///< Initial baud rate of the LMS (whatever is set in flash)
@@ -55,6 +57,12 @@ namespace SickToolbox {
     /** Define the maximum number of measurements */
     static const uint16_t SICK_MAX_NUM_MEASUREMENTS = 721;                     ///< Maximum number of measurements returned by the Sick LMS
 
+    /** Define the telegram index modulus */
+    static const unsigned int SICK_LMS_2XX_TELEGRAM_INDEX_MODULUS = 256;       ///< Telegram index wraps at 8 bits
+
+    /** Define the maximum number of partial scans in an interlaced scan */
+    static const unsigned int SICK_MAX_NUM_PARTIAL_SCANS = 4;                   ///< Partial scans are offset by 0.25 deg in a 1 deg step
+
     /*!
      * \enum sick_lms_2xx_type_t 
      * \brief Defines the Sick LMS 2xx types.
@@ -506,6 +514,36 @@ namespace SickToolbox {
       uint8_t sick_telegram_index;                                             ///< Telegram index modulo 256
       uint8_t sick_real_time_scan_index;                                       ///< If real-time scan indices are requested, this value is set (modulo 256)
     } sick_lms_2xx_scan_profile_c4_t;
+
+    /*!
+     * \struct sick_lms_2xx_scan_data_tag
+     * \brief A structure for aggregating a single streamed
+     *        scan, whichever reply (B0, B6, B7, BF or C4)
+     *        it was decoded from.
+     */
+    /*!
+     * \typedef sick_lms_2xx_scan_data_t
+     * \brief Adopt c-style convention
+     */
+    typedef struct sick_lms_2xx_scan_data_tag {
+      uint8_t sick_reply_code;                                                 ///< The reply the scan was decoded from
+      unsigned int num_measurement_values;                                     ///< Number of measurements
+      unsigned int measurement_values[SICK_MAX_NUM_MEASUREMENTS];              ///< Range/reflectivity measurements (range for C4)
+      unsigned int num_reflect_values;                                         ///< Number of reflectivity measurements (C4 only)
+      unsigned int reflect_values[SICK_MAX_NUM_MEASUREMENTS];                  ///< Reflectivity measurements (C4 only)
+      unsigned int sick_field_a_values[SICK_MAX_NUM_MEASUREMENTS];             ///< Field A values (B0, B7 and C4 only)
+      unsigned int sick_field_b_values[SICK_MAX_NUM_MEASUREMENTS];             ///< Field B values (B0, B7 and C4 only)
+      unsigned int sick_field_c_values[SICK_MAX_NUM_MEASUREMENTS];             ///< Field C values (B0, B7 and C4 only)
+      unsigned int sick_telegram_index;                                        ///< Telegram index modulo 256
+      unsigned int sick_real_time_scan_index;                                  ///< Real-time scan index modulo 256 (if requested)
+      unsigned int sick_partial_scan_index;                                    ///< Partial scan index (B0 and B7 only)
+      unsigned int sick_missing_partial_scans;                                 ///< Interlaced scans only: bit k is set if partial scan k (k*0.25 deg) was missing
+      unsigned int num_scans_lost;                                             ///< Telegrams missed (by telegram index) just before this one
+      struct timespec arrival_time;                                            ///< When the first byte of the scan arrived (CLOCK_REALTIME)
+    } sick_lms_2xx_scan_data_t;
+
+    /** Called w/ each scan decoded by the driver */
+    typedef SickSubscriberList< sick_lms_2xx_scan_data_t >::callback_t sick_lms_2xx_scan_callback_t;
     
     /** Constructor */
     SickLMS2xx( const std::string sick_device_path );
@@ -581,7 +619,8 @@ namespace SickToolbox {
 		      unsigned int * const sick_field_b_values = NULL,
 		      unsigned int * const sick_field_c_values = NULL,
 		      unsigned int * const sick_telegram_index = NULL,
-		      unsigned int * const sick_real_time_scan_index = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
+		      unsigned int * const sick_real_time_scan_index = NULL,
+		      struct timespec * const arrival_time = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
 
     /** Gets range and reflectivity data from the Sick. NOTE: This only applies to Sick LMS 211/221/291-S14! */
     void GetSickScan( unsigned int * const range_values,
@@ -592,7 +631,8 @@ namespace SickToolbox {
 		      unsigned int * const sick_field_b_values = NULL,
 		      unsigned int * const sick_field_c_values = NULL,
 		      unsigned int * const sick_telegram_index = NULL,
-		      unsigned int * const sick_real_time_scan_index = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
+		      unsigned int * const sick_real_time_scan_index = NULL,
+		      struct timespec * const arrival_time = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
 
     /** Gets measurement data from the Sick. NOTE: Data can be either range or reflectivity given the Sick mode. */
     void GetSickScanSubrange( const uint16_t sick_subrange_start_index,
@@ -603,7 +643,8 @@ namespace SickToolbox {
 			      unsigned int * const sick_field_b_values = NULL,
 			      unsigned int * const sick_field_c_values = NULL,
 			      unsigned int * const sick_telegram_index = NULL,
-			      unsigned int * const sick_real_time_scan_index = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
+			      unsigned int * const sick_real_time_scan_index = NULL,
+			      struct timespec * const arrival_time = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
     
     /** Gets partial scan measurements from the Sick LMS 2xx. NOTE: Data can be either range or reflectivity depending upon the given Sick mode. */
     void GetSickPartialScan( unsigned int * const measurement_values,
@@ -613,14 +654,27 @@ namespace SickToolbox {
 			     unsigned int * const sick_field_b_values = NULL,
 			     unsigned int * const sick_field_c_values = NULL,
 			     unsigned int * const sick_telegram_index = NULL,
-			     unsigned int * const sick_real_time_scan_index = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
+			     unsigned int * const sick_real_time_scan_index = NULL,
+			     struct timespec * const arrival_time = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
+
+    /** Gets a whole scan interlaced from the partial scans streamed by the Sick LMS */
+    void GetSickInterlacedScan( unsigned int * const measurement_values,
+				unsigned int & num_measurement_values,
+				unsigned int & missing_partial_scans,
+				unsigned int * const sick_field_a_values = NULL,
+				unsigned int * const sick_field_b_values = NULL,
+				unsigned int * const sick_field_c_values = NULL,
+				unsigned int * const sick_telegram_index = NULL,
+				unsigned int * const sick_real_time_scan_index = NULL,
+				struct timespec * const arrival_time = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
 
     /** Gets mean measured values from the Sick LMS */
     void GetSickMeanValues( const uint8_t sick_sample_size,
 			    unsigned int * const measurement_values,
 			    unsigned int & num_measurement_values,
 			    unsigned int * const sick_telegram_index = NULL,
-			    unsigned int * const sick_real_time_index = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException );
+			    unsigned int * const sick_real_time_index = NULL,
+			    struct timespec * const arrival_time = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException );
 
     /** Gets mean measured values from the Sick LMS */
     void GetSickMeanValuesSubrange( const uint8_t sick_sample_size,
@@ -629,7 +683,21 @@ namespace SickToolbox {
 				    unsigned int * const measurement_values,
 				    unsigned int & num_measurement_values,
 				    unsigned int * const sick_telegram_index = NULL,
-				    unsigned int * const sick_real_time_index = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException );
+				    unsigned int * const sick_real_time_index = NULL,
+				    struct timespec * const arrival_time = NULL ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException );
+
+    /** Registers a callback to receive each streamed scan as soon as it is decoded (starts a stream if need be) */
+    unsigned int RegisterSickScanCallback( const sick_lms_2xx_scan_callback_t scan_callback, void * const callback_args = NULL )
+      throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException );
+
+    /** Unregisters a scan callback */
+    void UnregisterSickScanCallback( const unsigned int callback_id ) throw( SickThreadException );
+
+    /** Whether the scan callbacks get interlaced scans rather than each partial scan (see GetSickInterlacedScan) */
+    void SetSickPartialScanAssembly( const bool assemble_partial_scans ) { _sick_partial_scan_assembly = assemble_partial_scans; }
+
+    /** Whether values missing from an interlaced scan are interpolated from their neighbours (rather than zeroed) */
+    void SetSickPartialScanInterpolation( const bool interpolate_missing_values ) { _sick_partial_scan_interpolation = interpolate_missing_values; }
 
     /** Acquire the Sick LMS status */
     sick_lms_2xx_status_t GetSickStatus( ) throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException );
@@ -704,6 +772,60 @@ namespace SickToolbox {
 
   protected:
 
+    /*!
+     * \struct sick_lms_2xx_scan_dest_tag
+     * \brief Where a scan reply is decoded to. The buffers
+     *        are written in place (NULL => not wanted).
+     */
+    /*!
+     * \typedef sick_lms_2xx_scan_dest_t
+     * \brief Adopt c-style convention
+     */
+    typedef struct sick_lms_2xx_scan_dest_tag {
+      unsigned int *measurement_values;                                        ///< Range/reflectivity measurements (range for C4, must be given)
+      unsigned int *reflect_values;                                            ///< Reflectivity measurements (C4 only)
+      unsigned int *field_a_values;                                            ///< Field A values (zeroed for B6 and BF)
+      unsigned int *field_b_values;                                            ///< Field B values (zeroed for B6 and BF)
+      unsigned int *field_c_values;                                            ///< Field C values (zeroed for B6 and BF)
+      unsigned int num_measurement_values;                                     ///< Number of measurements decoded
+      unsigned int num_reflect_values;                                         ///< Number of reflectivity values decoded (zero unless C4)
+      unsigned int sick_telegram_index;                                        ///< Telegram index modulo 256
+      unsigned int sick_real_time_scan_index;                                  ///< Real-time scan index modulo 256 (zero unless enabled)
+      unsigned int sick_partial_scan_index;                                    ///< Partial scan index (B0 and B7 only, else zero)
+      unsigned int sick_missing_partial_scans;                                 ///< Bit k is set if partial scan k was missing (interlaced scans only)
+    } sick_lms_2xx_scan_dest_t;
+
+    /*!
+     * \struct sick_lms_2xx_interlacer_tag
+     * \brief Collects the partial scans making up an
+     *        interlaced scan. Slot k holds every value
+     *        whose index is k modulo the number of
+     *        partial scans. Each partial scan is decoded
+     *        into the interlacer too, so no per-scan
+     *        buffers are needed.
+     */
+    /*!
+     * \typedef sick_lms_2xx_interlacer_t
+     * \brief Adopt c-style convention
+     */
+    typedef struct sick_lms_2xx_interlacer_tag {
+      unsigned int num_partial_scans;                                          ///< Partial scans per interlaced scan (1 deg over the resolution)
+      unsigned int num_measurement_values;                                     ///< Number of values in an interlaced scan
+      unsigned int partial_scans_present;                                      ///< Bit k is set once slot k has arrived
+      unsigned int scan_base_index;                                            ///< Scan index (modulo 256) that slot 0 of the current scan has (or would have)
+      unsigned int measurement_values[SICK_MAX_NUM_MEASUREMENTS];              ///< Interlaced measured values
+      unsigned int field_a_values[SICK_MAX_NUM_MEASUREMENTS];                  ///< Interlaced Field A values
+      unsigned int field_b_values[SICK_MAX_NUM_MEASUREMENTS];                  ///< Interlaced Field B values
+      unsigned int field_c_values[SICK_MAX_NUM_MEASUREMENTS];                  ///< Interlaced Field C values
+      unsigned int partial_values[SICK_MAX_NUM_MEASUREMENTS];                  ///< The partial scan being decoded (only its values are written)
+      unsigned int partial_field_a_values[SICK_MAX_NUM_MEASUREMENTS];          ///< Field A values of the partial scan being decoded
+      unsigned int partial_field_b_values[SICK_MAX_NUM_MEASUREMENTS];          ///< Field B values of the partial scan being decoded
+      unsigned int partial_field_c_values[SICK_MAX_NUM_MEASUREMENTS];          ///< Field C values of the partial scan being decoded
+      unsigned int sick_telegram_index;                                        ///< Telegram index of the latest partial scan
+      unsigned int sick_real_time_scan_index;                                  ///< Real-time scan index of the latest partial scan
+      struct timespec arrival_time;                                            ///< When the first partial scan arrived
+    } sick_lms_2xx_interlacer_t;
+
     /** A path to the device at which the sick can be accessed. */
     std::string _sick_device_path;
 
@@ -719,6 +841,24 @@ namespace SickToolbox {
     /** The operating parameters of the device */
     sick_lms_2xx_operating_status_t _sick_operating_status;
 
+    /** Callbacks subscribed to the scan stream */
+    SickSubscriberList< sick_lms_2xx_scan_data_t > _sick_scan_subscribers;
+
+    /** Scan decoded for the subscribers (only touched by the monitor) */
+    sick_lms_2xx_scan_data_t _sick_scan_data;
+
+    /** Interlaces partial scans for the subscribers (only touched by the monitor) */
+    sick_lms_2xx_interlacer_t _sick_scan_interlacer;
+
+    /** Interlaces partial scans for GetSickInterlacedScan */
+    sick_lms_2xx_interlacer_t _sick_interlacer;
+
+    /** Indicates whether the subscribers get interlaced scans */
+    volatile bool _sick_partial_scan_assembly;
+
+    /** Indicates whether values missing from interlaced scans are interpolated */
+    volatile bool _sick_partial_scan_interpolation;
+
     /** The current software version being run on the device */
     sick_lms_2xx_software_status_t _sick_software_status;
 
@@ -840,27 +980,51 @@ namespace SickToolbox {
     void _switchSickOperatingMode( const uint8_t sick_mode, const uint8_t * const mode_params = NULL )
       throw( SickConfigException, SickTimeoutException, SickIOException, SickThreadException);
     
-    /** Parses the scan profile returned w/ message B0 */
-    void _parseSickScanProfileB0( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_b0_t &sick_scan_profile ) const;
-
-    /** Parses the scan profile returned w/ message B6 */
-    void _parseSickScanProfileB6( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_b6_t &sick_scan_profile ) const;
-
-    /** Parses the scan profile returned w/ message B6 */
-    void _parseSickScanProfileB7( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_b7_t &sick_scan_profile ) const;
-
-    /** Parses the scan profile returned w/ message BF */
-    void _parseSickScanProfileBF( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_bf_t &sick_scan_profile ) const;
-    
-    /** Parses the scan profile returned w/ message C4 */
-    void _parseSickScanProfileC4( const uint8_t * const src_buffer, sick_lms_2xx_scan_profile_c4_t &sick_scan_profile ) const;
+    /** Points a scan destination at the given buffers (everything else is zeroed) */
+    void _setSickScanDest( sick_lms_2xx_scan_dest_t &sick_scan_dest, unsigned int * const measurement_values,
+			   unsigned int * const reflect_values = NULL, unsigned int * const field_a_values = NULL,
+			   unsigned int * const field_b_values = NULL, unsigned int * const field_c_values = NULL ) const {
+      memset(&sick_scan_dest,0,sizeof(sick_lms_2xx_scan_dest_t));
+      sick_scan_dest.measurement_values = measurement_values;
+      sick_scan_dest.reflect_values = reflect_values;
+      sick_scan_dest.field_a_values = field_a_values;
+      sick_scan_dest.field_b_values = field_b_values;
+      sick_scan_dest.field_c_values = field_c_values;
+    }
+
+    /** Decodes a scan reply (B0, B6, B7, BF or C4) straight into the given buffers */
+    bool _decodeSickScan( const uint8_t * const payload_buffer, const unsigned int payload_length,
+			  sick_lms_2xx_scan_dest_t &sick_scan_dest ) const;
+
+    /** Starts collecting interlaced scans afresh (w/ the current scan area and resolution) */
+    void _resetSickInterlacer( sick_lms_2xx_interlacer_t &sick_interlacer ) const;
+
+    /** Files a partial scan w/ its interlaced scan (returns True if an interlaced scan was handed over) */
+    bool _interlaceSickPartialScan( sick_lms_2xx_interlacer_t &sick_interlacer, const sick_lms_2xx_scan_dest_t &sick_partial_scan,
+				    const struct timespec &partial_arrival_time, sick_lms_2xx_scan_dest_t &sick_interlaced_scan,
+				    struct timespec &interlaced_arrival_time ) const;
+
+    /** Hands over the interlaced scan collected so far (filling in any missing partial scans) */
+    void _emitSickInterlacedScan( sick_lms_2xx_interlacer_t &sick_interlacer, sick_lms_2xx_scan_dest_t &sick_interlaced_scan,
+				  struct timespec &interlaced_arrival_time ) const;
+
+    /** Hands streamed scans to the subscribers (called by the buffer monitor) */
+    static bool _scanMessageHandler( SickLMS2xxMessage &sick_message, void * handler_args );
 
     /** A function for parsing a byte sequence into a device config structure */
     void _parseSickConfigProfile( const uint8_t * const src_buffer, sick_lms_2xx_device_config_t &sick_device_config ) const;
 
-    /** Acquires the bit mask to extract the field bit values returned with each range measurement */
-    void _extractSickMeasurementValues( const uint8_t * const byte_sequence, const uint16_t num_measurements, uint16_t * const measured_values,
-					uint8_t * const field_a_values = NULL, uint8_t * const field_b_values = NULL, uint8_t * const field_c_values = NULL ) const;
+    /** Extracts the measured values (and whichever field values are wanted) according to the measuring mode */
+    void _extractSickMeasurementValues( const uint8_t * const byte_sequence, const uint16_t num_measurements, unsigned int * const measured_values,
+					unsigned int * const field_a_values = NULL, unsigned int * const field_b_values = NULL,
+					unsigned int * const field_c_values = NULL ) const;
+
+    /** Extracts whole blocks of measured values on the host's vector unit (returns how many were extracted) */
+    static unsigned int _extractSickMeasurementBlocks( const uint8_t * const byte_sequence, const unsigned int num_measurements,
+						       const uint8_t value_mask, unsigned int * const measured_values,
+						       const uint8_t field_a_mask = 0, const uint8_t field_b_mask = 0, const uint8_t field_c_mask = 0,
+						       unsigned int * const field_a_values = NULL, unsigned int * const field_b_values = NULL,
+						       unsigned int * const field_c_values = NULL );
     
     /** Tells whether the device is returning real-time indices */
     bool _returningRealTimeIndices( ) const { return _sick_device_config.sick_availability_level & SICK_FLAG_AVAILABILITY_REAL_TIME_INDICES; }
@@ -989,6 +1153,12 @@ namespace SickToolbox {
    * \brief Makes working w/ SickLMS2xx::sick_lms_2xx_baud_t a bit easier
    */
   typedef SickLMS2xx::sick_lms_2xx_baud_t sick_lms_2xx_baud_t;
+
+  /*!
+   * \typedef sick_lms_2xx_scan_data_t
+   * \brief Makes working w/ SickLMS2xx::sick_lms_2xx_scan_data_t a bit easier
+   */
+  typedef SickLMS2xx::sick_lms_2xx_scan_data_t sick_lms_2xx_scan_data_t;
   
 } //namespace SickToolbox
   
@@ -49,11 +49,6 @@ namespace SickToolbox {
     
     try {
 
-      /* Drain the I/O buffers! */
-      if (tcdrain(_sick_fd) != 0) {
-     	throw SickIOException("SickLMS2xxBufferMonitor::GetNextMessageFromDataStream: tcdrain failed!");
-      }
-
       /* Read until we get a valid message header */
       unsigned int bytes_searched = 0;
       while(search_buffer[0] != 0x02 || search_buffer[1] != DEFAULT_SICK_LMS_2XX_HOST_ADDRESS) {
@@ -62,7 +57,7 @@ namespace SickToolbox {
  	search_buffer[0] = search_buffer[1];
 	
  	/* Attempt to read in another byte */
- 	_readBytes(&search_buffer[1],1,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+ 	_readBytes(&search_buffer[1],1,DEFAULT_SICK_LMS_2XX_SICK_FRAME_TIMEOUT);
 
 	/* Header should be no more than max message length + header length bytes away */
 	if (bytes_searched > SickLMS2xxMessage::MESSAGE_MAX_LENGTH + SickLMS2xxMessage::MESSAGE_HEADER_LENGTH) {
@@ -75,7 +70,7 @@ namespace SickToolbox {
       }
       
       /* Read until we receive the payload length or we timeout */
-      _readBytes(payload_length_buffer,2,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+      _readBytes(payload_length_buffer,2,DEFAULT_SICK_LMS_2XX_SICK_FRAME_TIMEOUT);
 
       /* Extract the payload length */
       memcpy(&payload_length,payload_length_buffer,2);
@@ -85,10 +80,10 @@ namespace SickToolbox {
       if (payload_length <= SickLMS2xxMessage::MESSAGE_MAX_LENGTH) {
 
 	/* Read until we receive the payload or we timeout */
-	_readBytes(payload_buffer,payload_length,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+	_readBytes(payload_buffer,payload_length,DEFAULT_SICK_LMS_2XX_SICK_FRAME_TIMEOUT);
 	
 	/* Read until we receive the checksum or we timeout */
-	_readBytes(checksum_buffer,2,DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT);
+	_readBytes(checksum_buffer,2,DEFAULT_SICK_LMS_2XX_SICK_FRAME_TIMEOUT);
 	
 	/* Copy into uint16_t so it can be used */
 	memcpy(&checksum,checksum_buffer,2);
@@ -111,6 +106,7 @@ namespace SickToolbox {
     /* Handle a bad checksum! */
     catch(SickBadChecksumException &sick_checksum_exception) {
       sick_message.Clear(); // Clear the message container
+      _recordChecksumFailure();
     }
     
     /* Handle any serious IO exceptions */
@@ -18,7 +18,7 @@
 #ifndef SICK_LMS_2XX_BUFFER_MONITOR_HH
 #define SICK_LMS_2XX_BUFFER_MONITOR_HH
 
-#define DEFAULT_SICK_LMS_2XX_SICK_BYTE_TIMEOUT      (35000)  ///< Max allowable time between consecutive bytes
+#define DEFAULT_SICK_LMS_2XX_SICK_FRAME_TIMEOUT   (1000000)  ///< Max allowable time for receiving a whole message (usecs, long enough for 9600 baud)
 
 /* Definition dependencies */
 #include "SickLMS2xxMessage.hh"
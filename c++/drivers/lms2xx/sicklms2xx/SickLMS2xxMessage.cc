@@ -135,6 +135,22 @@ namespace SickToolbox {
     
   }
   
+  /*!
+   * \brief Exchanges the contents of two messages (buffers are swapped, not copied)
+   * \param &sick_message The message to swap with
+   */
+  void SickLMS2xxMessage::Swap( SickLMS2xxMessage &sick_message ) {
+
+    /* Swap the buffers */
+    SickMessage< SICK_LMS_2XX_MSG_HEADER_LEN, SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN, SICK_LMS_2XX_MSG_TRAILER_LEN >::Swap(sick_message);
+
+    /* Swap the class' additional fields */
+    uint16_t checksum = _checksum;
+    _checksum = sick_message._checksum;
+    sick_message._checksum = checksum;
+    
+  }
+
   /*!
    * \brief Print the message contents.
    */
@@ -155,25 +171,75 @@ namespace SickToolbox {
    * \param data An array of bytes whose checksum to compute
    * \param len The length of the data array
    * \return CRC16 computed over given data buffer
+   *
+   * NOTE: The Sick's CRC16 shifts the register once per byte (feeding
+   *       back CRC16_GEN_POL when the top bit falls out) and XORs in the
+   *       current and previous bytes as a little-endian word. Being
+   *       linear, eight such steps amount to shifting the register left
+   *       a byte, XORing in the eight (shifted) words and reducing the
+   *       24-bit result, whose top byte is folded back via a table. The
+   *       bytes that don't fill a block are handled one at a time.
    */
-  uint16_t SickLMS2xxMessage::_computeCRC( uint8_t * data, unsigned int data_length ) const {
-  
-    uint16_t uCrc16;
-    uint8_t abData[2];
-    uCrc16 = abData[0] = 0;
-    while (data_length-- ) {
-      abData[1] = abData[0];
-      abData[0] = *data++;
-      if(uCrc16 & 0x8000) {
-	uCrc16 = (uCrc16 & 0x7fff) << 1;
-	uCrc16 ^= CRC16_GEN_POL;
-      }
-      else {
-	uCrc16 <<= 1;
-      }
-      uCrc16 ^= MKSHORT(abData[0],abData[1]);
+  uint16_t SickLMS2xxMessage::_computeCRC( const uint8_t * data, unsigned int data_length ) const {
+
+    const uint16_t * const fold_table = _getCRCFoldTable();
+
+    uint16_t crc16 = 0;
+    uint8_t prev_byte = 0;
+
+    /* Eight bytes at a time */
+    for (; data_length >= 8; data_length -= 8, data += 8) {
+
+      uint32_t remainder = (uint32_t)crc16 << 8;
+      remainder ^= (uint32_t)MKSHORT(data[0],prev_byte) << 7;
+      remainder ^= (uint32_t)MKSHORT(data[1],data[0]) << 6;
+      remainder ^= (uint32_t)MKSHORT(data[2],data[1]) << 5;
+      remainder ^= (uint32_t)MKSHORT(data[3],data[2]) << 4;
+      remainder ^= (uint32_t)MKSHORT(data[4],data[3]) << 3;
+      remainder ^= (uint32_t)MKSHORT(data[5],data[4]) << 2;
+      remainder ^= (uint32_t)MKSHORT(data[6],data[5]) << 1;
+      remainder ^= (uint32_t)MKSHORT(data[7],data[6]);
+
+      crc16 = (uint16_t)remainder ^ fold_table[remainder >> 16];
+      prev_byte = data[7];
+
     }
-    return uCrc16;
+
+    /* Whatever is left over */
+    for (; data_length > 0; data_length--, data++) {
+      crc16 = (uint16_t)((crc16 << 1) ^ ((crc16 & 0x8000) ? CRC16_GEN_POL : 0) ^ MKSHORT(*data,prev_byte));
+      prev_byte = *data;
+    }
+
+    return crc16;
+
+  }
+
+  /*!
+   * \brief Gets the table used to reduce the top byte of a 24-bit remainder
+   * \return x^16 * h mod the generator, indexed by h
+   */
+  const uint16_t * SickLMS2xxMessage::_getCRCFoldTable( ) {
+
+    /* Filled in the first time through */
+    static struct sick_lms_2xx_crc_fold_table_t {
+
+      uint16_t entries[256];
+
+      sick_lms_2xx_crc_fold_table_t( ) {
+	for (unsigned int h = 0; h < 256; h++) {
+	  uint16_t crc16 = (uint16_t)h;
+	  for (unsigned int i = 0; i < 16; i++) {
+	    crc16 = (uint16_t)((crc16 << 1) ^ ((crc16 & 0x8000) ? CRC16_GEN_POL : 0));
+	  }
+	  entries[h] = crc16;
+	}
+      }
+
+    } fold_table;
+
+    return fold_table.entries;
+
   }
 
   SickLMS2xxMessage::~SickLMS2xxMessage( ) { }
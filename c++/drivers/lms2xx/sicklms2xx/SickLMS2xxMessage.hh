@@ -75,6 +75,9 @@ namespace SickToolbox {
     
     /** Reset the data associated with this message (for initialization purposes) */
     void Clear( );
+
+    /** Exchanges contents w/ another message w/o copying either buffer */
+    void Swap( SickLMS2xxMessage &sick_message );
     
     /** A debugging function that prints the contents of the message. */
     void Print( ) const;
@@ -90,7 +93,10 @@ namespace SickToolbox {
   private:
 
     /** Computes the checksum of the frame. */
-    uint16_t _computeCRC( uint8_t * data, unsigned int data_length ) const;
+    uint16_t _computeCRC( const uint8_t * data, unsigned int data_length ) const;
+
+    /** Gets the table reducing the top byte of a 24-bit remainder (x^16 * h mod the generator, for each byte h) */
+    static const uint16_t * _getCRCFoldTable( );
 
   };
 
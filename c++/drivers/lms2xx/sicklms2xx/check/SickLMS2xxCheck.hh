@@ -0,0 +1,44 @@
+/*!
+ * \file SickLMS2xxCheck.hh
+ * \brief Defines the Sick LMS 2xx the checks drive w/o a device,
+ *        exposing the internals they exercise.
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#ifndef SICK_LMS_2XX_CHECK_HH
+#define SICK_LMS_2XX_CHECK_HH
+
+/* Definition dependencies */
+#include <sicklms2xx/SickLMS2xx.hh>
+
+/**
+ * \brief Exposes the scan decoding and extraction (the device is never opened)
+ */
+class SickLMS2xxCheck : public SickToolbox::SickLMS2xx {
+
+public:
+
+  typedef sick_lms_2xx_scan_dest_t scan_dest_t;
+
+  SickLMS2xxCheck( ) : SickToolbox::SickLMS2xx("/dev/null") { }
+
+  /** Sets the device config the decoder depends upon */
+  void SetDecodeConfig( const uint8_t measuring_mode, const bool real_time_indices ) {
+    _sick_device_config.sick_measuring_mode = measuring_mode;
+    _sick_device_config.sick_availability_level = real_time_indices ? SICK_FLAG_AVAILABILITY_REAL_TIME_INDICES : 0;
+  }
+
+  /** Sets the measuring mode the extraction depends upon */
+  void SetMeasuringMode( const uint8_t measuring_mode ) { _sick_device_config.sick_measuring_mode = measuring_mode; }
+
+  using SickToolbox::SickLMS2xx::_setSickScanDest;
+  using SickToolbox::SickLMS2xx::_decodeSickScan;
+  using SickToolbox::SickLMS2xx::_extractSickMeasurementValues;
+  using SickToolbox::SickLMS2xx::_extractSickMeasurementBlocks;
+
+};
+
+#endif /* SICK_LMS_2XX_CHECK_HH */
@@ -0,0 +1,121 @@
+/*!
+ * \file crc_check.cc
+ * \brief Checks the Sick LMS 2xx CRC16 against the bitwise reference and
+ *        reports the throughput of both.
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <time.h>
+#include <stdlib.h>
+#include <iostream>
+#include <sicklms2xx/SickLMS2xxMessage.hh>
+
+using namespace std;
+using namespace SickToolbox;
+
+#define NUM_RANDOM_FRAMES  (20000)  ///< Random frames compared against the reference
+#define NUM_TIMED_FRAMES   (50000)  ///< Max length frames run through each CRC for timing
+
+/**
+ * \brief The CRC16 as given in the LMS 2xx telegram listing (one bit at a time)
+ * \param *data The bytes to checksum
+ * \param data_length The number of bytes
+ * \return The checksum
+ */
+static uint16_t bitwise_crc( const uint8_t * data, unsigned int data_length ) {
+
+  uint16_t crc16 = 0;
+  uint8_t abData[2] = {0};
+
+  while (data_length--) {
+
+    abData[1] = abData[0];
+    abData[0] = *data++;
+
+    if (crc16 & 0x8000) {
+      crc16 = (crc16 & 0x7fff) << 1;
+      crc16 ^= CRC16_GEN_POL;
+    }
+    else {
+      crc16 <<= 1;
+    }
+
+    crc16 ^= MKSHORT(abData[0],abData[1]);
+
+  }
+
+  return crc16;
+
+}
+
+/**
+ * \brief Gets the seconds elapsed since the given time
+ */
+static double elapsed_secs( const struct timespec &beg_time ) {
+
+  struct timespec end_time;
+  clock_gettime(CLOCK_MONOTONIC,&end_time);
+  return (end_time.tv_sec - beg_time.tv_sec) + (end_time.tv_nsec - beg_time.tv_nsec)*1e-9;
+
+}
+
+int main()
+{
+
+  uint8_t payload_buffer[SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN] = {0};
+  uint8_t message_buffer[SICK_LMS_2XX_MSG_HEADER_LEN+SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN+SICK_LMS_2XX_MSG_TRAILER_LEN] = {0};
+  SickLMS2xxMessage sick_message;
+  unsigned int num_mismatches = 0;
+
+  srand(1);
+
+  /* Every payload length w/ random contents (the header is checksummed too) */
+  for (unsigned int i = 0; i < NUM_RANDOM_FRAMES; i++) {
+
+    const unsigned int payload_length = 1 + i % SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN;
+    for (unsigned int j = 0; j < payload_length; j++) {
+      payload_buffer[j] = (uint8_t)rand();
+    }
+
+    sick_message.BuildMessage((uint8_t)rand(),payload_buffer,payload_length);
+    sick_message.GetMessage(message_buffer);
+
+    if (sick_message.GetChecksum() != bitwise_crc(message_buffer,payload_length+SICK_LMS_2XX_MSG_HEADER_LEN)) {
+      cerr << "CRC mismatch for a " << payload_length << " byte payload!" << endl;
+      num_mismatches++;
+    }
+
+  }
+
+  cout << NUM_RANDOM_FRAMES << " random frames, " << num_mismatches << " mismatch(es)" << endl;
+
+  /* Time max length frames (building one is a copy and the CRC) */
+  const double frame_mbytes = (SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN + SICK_LMS_2XX_MSG_HEADER_LEN) / 1e6;
+  struct timespec beg_time;
+  unsigned int crc_sum = 0;
+
+  clock_gettime(CLOCK_MONOTONIC,&beg_time);
+  for (unsigned int i = 0; i < NUM_TIMED_FRAMES; i++) {
+    message_buffer[i % SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN] ^= (uint8_t)i;
+    crc_sum += bitwise_crc(message_buffer,SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN+SICK_LMS_2XX_MSG_HEADER_LEN);
+  }
+  const double bitwise_secs = elapsed_secs(beg_time);
+
+  clock_gettime(CLOCK_MONOTONIC,&beg_time);
+  for (unsigned int i = 0; i < NUM_TIMED_FRAMES; i++) {
+    payload_buffer[i % SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN] ^= (uint8_t)i;
+    sick_message.BuildMessage(0x80,payload_buffer,SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN);
+    crc_sum += sick_message.GetChecksum();
+  }
+  const double build_secs = elapsed_secs(beg_time);
+
+  cout << "Bitwise CRC:     " << NUM_TIMED_FRAMES*frame_mbytes/bitwise_secs << " MB/s" << endl;
+  cout << "BuildMessage():  " << NUM_TIMED_FRAMES*frame_mbytes/build_secs << " MB/s (copy included)" << endl;
+  cout << "Speedup:         " << bitwise_secs/build_secs << "x" << " (checksum sum " << crc_sum << ")" << endl;
+
+  return num_mismatches == 0 ? 0 : 1;
+
+}
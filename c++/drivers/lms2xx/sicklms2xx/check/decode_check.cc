@@ -0,0 +1,397 @@
+/*!
+ * \file decode_check.cc
+ * \brief Checks that Sick LMS 2xx scan replies decode the same as they did
+ *        when parsed into the scan profile structs.
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <sicklms2xx/SickLMS2xx.hh>
+#include <sicklms2xx/SickLMS2xxMessage.hh>
+#include "SickLMS2xxCheck.hh"
+
+using namespace std;
+using namespace SickToolbox;
+
+#define NUM_RANDOM_REPLIES  (6000)  ///< Random replies decoded both ways
+
+/**
+ * \brief A scan as the getters used to hand it over
+ */
+struct reference_scan_t {
+  unsigned int num_measurement_values;
+  unsigned int measurement_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  unsigned int field_a_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  unsigned int field_b_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  unsigned int field_c_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  unsigned int num_reflect_values;
+  unsigned int reflect_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  unsigned int sick_telegram_index;
+  unsigned int sick_real_time_scan_index;
+  unsigned int sick_partial_scan_index;
+};
+
+/**
+ * \brief Extracts measured values as the profile parsers did (one mode at a time)
+ */
+static void reference_extract( const uint8_t * const byte_sequence, const unsigned int num_measurements, const uint8_t measuring_mode,
+			       uint16_t * const measured_values, uint8_t * const field_a_values = NULL,
+			       uint8_t * const field_b_values = NULL, uint8_t * const field_c_values = NULL ) {
+
+  for (unsigned int i = 0; i < num_measurements; i++) {
+
+    const uint8_t high_byte = byte_sequence[i*2+1];
+
+    switch(measuring_mode) {
+    case SickLMS2xx::SICK_MS_MODE_8_OR_80_FA_FB_DAZZLE:
+    case SickLMS2xx::SICK_MS_MODE_8_OR_80_FA_FB_FC:
+      measured_values[i] = byte_sequence[i*2] + 256*(high_byte & 0x1F);
+      if (field_a_values) { field_a_values[i] = high_byte & 0x20; }
+      if (field_b_values) { field_b_values[i] = high_byte & 0x40; }
+      if (field_c_values) { field_c_values[i] = high_byte & 0x80; }
+      break;
+    case SickLMS2xx::SICK_MS_MODE_8_OR_80_REFLECTOR:
+      measured_values[i] = byte_sequence[i*2] + 256*(high_byte & 0x1F);
+      if (field_a_values) { field_a_values[i] = high_byte & 0xE0; }
+      break;
+    case SickLMS2xx::SICK_MS_MODE_16_REFLECTOR:
+      measured_values[i] = byte_sequence[i*2] + 256*(high_byte & 0x3F);
+      if (field_a_values) { field_a_values[i] = high_byte & 0xC0; }
+      break;
+    case SickLMS2xx::SICK_MS_MODE_16_FA_FB:
+      measured_values[i] = byte_sequence[i*2] + 256*(high_byte & 0x3F);
+      if (field_a_values) { field_a_values[i] = high_byte & 0x40; }
+      if (field_b_values) { field_b_values[i] = high_byte & 0x80; }
+      break;
+    case SickLMS2xx::SICK_MS_MODE_32_REFLECTOR:
+    case SickLMS2xx::SICK_MS_MODE_32_FA:
+      measured_values[i] = byte_sequence[i*2] + 256*(high_byte & 0x7F);
+      if (field_a_values) { field_a_values[i] = high_byte & 0x80; }
+      break;
+    case SickLMS2xx::SICK_MS_MODE_32_IMMEDIATE:
+    case SickLMS2xx::SICK_MS_MODE_REFLECTIVITY:
+      measured_values[i] = byte_sequence[i*2] + 256*high_byte;
+      break;
+    default:
+      break;
+    }
+
+  }
+
+}
+
+/**
+ * \brief Decodes a reply through the zeroed scan profile structs, as the getters used to
+ * \return False if the reply code isn't a scan
+ */
+static bool reference_decode( const uint8_t * const payload_buffer, const uint8_t measuring_mode, const bool real_time_indices,
+			      reference_scan_t &ref_scan ) {
+
+  static SickLMS2xx::sick_lms_2xx_scan_profile_b0_t b0;
+  static SickLMS2xx::sick_lms_2xx_scan_profile_b6_t b6;
+  static SickLMS2xx::sick_lms_2xx_scan_profile_b7_t b7;
+  static SickLMS2xx::sick_lms_2xx_scan_profile_bf_t bf;
+  static SickLMS2xx::sick_lms_2xx_scan_profile_c4_t c4;
+
+  const uint8_t * const src_buffer = &payload_buffer[1];
+  const uint16_t *measurements = NULL;
+  const uint8_t *field_a_values = NULL, *field_b_values = NULL, *field_c_values = NULL;
+  unsigned int data_offset = 0;
+
+  memset(&ref_scan,0,sizeof(reference_scan_t));
+
+  switch(payload_buffer[0]) {
+  case 0xB0:
+    memset(&b0,0,sizeof(b0));
+    b0.sick_num_measurements = src_buffer[0] + 256*(src_buffer[1] & 0x03);
+    b0.sick_partial_scan_index = ((src_buffer[1] & 0x18) >> 3);
+    reference_extract(&src_buffer[2],b0.sick_num_measurements,measuring_mode,b0.sick_measurements,
+		      b0.sick_field_a_values,b0.sick_field_b_values,b0.sick_field_c_values);
+    data_offset = 2 + 2*b0.sick_num_measurements;
+    if (real_time_indices) {
+      b0.sick_real_time_scan_index = src_buffer[data_offset++];
+    }
+    b0.sick_telegram_index = src_buffer[data_offset];
+    ref_scan.num_measurement_values = b0.sick_num_measurements;
+    ref_scan.sick_telegram_index = b0.sick_telegram_index;
+    ref_scan.sick_real_time_scan_index = b0.sick_real_time_scan_index;
+    ref_scan.sick_partial_scan_index = b0.sick_partial_scan_index;
+    measurements = b0.sick_measurements;
+    field_a_values = b0.sick_field_a_values;
+    field_b_values = b0.sick_field_b_values;
+    field_c_values = b0.sick_field_c_values;
+    break;
+  case 0xB6:
+    memset(&b6,0,sizeof(b6));
+    b6.sick_num_measurements = src_buffer[1] + 256*(src_buffer[2] & 0x03);
+    reference_extract(&src_buffer[3],b6.sick_num_measurements,measuring_mode,b6.sick_measurements);
+    data_offset = 3 + 2*b6.sick_num_measurements;
+    if (real_time_indices) {
+      b6.sick_real_time_scan_index = src_buffer[data_offset++];
+    }
+    b6.sick_telegram_index = src_buffer[data_offset];
+    ref_scan.num_measurement_values = b6.sick_num_measurements;
+    ref_scan.sick_telegram_index = b6.sick_telegram_index;
+    ref_scan.sick_real_time_scan_index = b6.sick_real_time_scan_index;
+    measurements = b6.sick_measurements;
+    break;
+  case 0xB7:
+    memset(&b7,0,sizeof(b7));
+    b7.sick_num_measurements = src_buffer[4] + 256*(src_buffer[5] & 0x03);
+    b7.sick_partial_scan_index = ((src_buffer[5] & 0x18) >> 3);
+    reference_extract(&src_buffer[6],b7.sick_num_measurements,measuring_mode,b7.sick_measurements,
+		      b7.sick_field_a_values,b7.sick_field_b_values,b7.sick_field_c_values);
+    data_offset = 6 + 2*b7.sick_num_measurements;
+    if (real_time_indices) {
+      b7.sick_real_time_scan_index = src_buffer[data_offset++];
+    }
+    b7.sick_telegram_index = src_buffer[data_offset];
+    ref_scan.num_measurement_values = b7.sick_num_measurements;
+    ref_scan.sick_telegram_index = b7.sick_telegram_index;
+    ref_scan.sick_real_time_scan_index = b7.sick_real_time_scan_index;
+    ref_scan.sick_partial_scan_index = b7.sick_partial_scan_index;
+    measurements = b7.sick_measurements;
+    field_a_values = b7.sick_field_a_values;
+    field_b_values = b7.sick_field_b_values;
+    field_c_values = b7.sick_field_c_values;
+    break;
+  case 0xBF:
+    memset(&bf,0,sizeof(bf));
+    bf.sick_num_measurements = src_buffer[5] + 256*(src_buffer[6] & 0x3F);
+    reference_extract(&src_buffer[7],bf.sick_num_measurements,measuring_mode,bf.sick_measurements);
+    data_offset = 7 + 2*bf.sick_num_measurements;
+    if (real_time_indices) {
+      bf.sick_real_time_scan_index = src_buffer[data_offset++];
+    }
+    bf.sick_telegram_index = src_buffer[data_offset];
+    ref_scan.num_measurement_values = bf.sick_num_measurements;
+    ref_scan.sick_telegram_index = bf.sick_telegram_index;
+    ref_scan.sick_real_time_scan_index = bf.sick_real_time_scan_index;
+    measurements = bf.sick_measurements;
+    break;
+  case 0xC4:
+    memset(&c4,0,sizeof(c4));
+    c4.sick_num_range_measurements = src_buffer[0] + 256*(src_buffer[1] & 0x03);
+    reference_extract(&src_buffer[2],c4.sick_num_range_measurements,measuring_mode,c4.sick_range_measurements,
+		      c4.sick_field_a_values,c4.sick_field_b_values,c4.sick_field_c_values);
+    data_offset = 2 + 2*c4.sick_num_range_measurements;
+    c4.sick_num_reflect_measurements = src_buffer[data_offset] + 256*(src_buffer[data_offset+1] & 0x03);
+    data_offset += 6;
+    for (unsigned int i = 0; i < c4.sick_num_reflect_measurements; i++, data_offset++) {
+      c4.sick_reflect_measurements[i] = src_buffer[data_offset];
+    }
+    if (real_time_indices) {
+      c4.sick_real_time_scan_index = src_buffer[data_offset++];
+    }
+    c4.sick_telegram_index = src_buffer[data_offset];
+    ref_scan.num_measurement_values = c4.sick_num_range_measurements;
+    ref_scan.num_reflect_values = c4.sick_num_reflect_measurements;
+    for (unsigned int i = 0; i < c4.sick_num_reflect_measurements; i++) {
+      ref_scan.reflect_values[i] = c4.sick_reflect_measurements[i];
+    }
+    ref_scan.sick_telegram_index = c4.sick_telegram_index;
+    ref_scan.sick_real_time_scan_index = c4.sick_real_time_scan_index;
+    measurements = c4.sick_range_measurements;
+    field_a_values = c4.sick_field_a_values;
+    field_b_values = c4.sick_field_b_values;
+    field_c_values = c4.sick_field_c_values;
+    break;
+  default:
+    return false;
+  }
+
+  /* Copied out element by element (mean values have no fields, so those are zero) */
+  for (unsigned int i = 0; i < ref_scan.num_measurement_values; i++) {
+    ref_scan.measurement_values[i] = measurements[i];
+    ref_scan.field_a_values[i] = field_a_values ? field_a_values[i] : 0;
+    ref_scan.field_b_values[i] = field_b_values ? field_b_values[i] : 0;
+    ref_scan.field_c_values[i] = field_c_values ? field_c_values[i] : 0;
+  }
+
+  return true;
+
+}
+
+/**
+ * \brief Tells whether the first num_values of two buffers match
+ */
+static bool values_match( const unsigned int * const values, const unsigned int * const ref_values, const unsigned int num_values ) {
+  return memcmp(values,ref_values,num_values*sizeof(unsigned int)) == 0;
+}
+
+/**
+ * \brief Fills in a random reply whose counts fit a real payload
+ * \return The payload length (the reply code through the status byte)
+ */
+static unsigned int random_reply( uint8_t * const payload_buffer, const uint8_t reply_code, const bool real_time_indices,
+				  unsigned int &num_values ) {
+
+  for (unsigned int j = 0; j < SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN; j++) {
+    payload_buffer[j] = (uint8_t)rand();
+  }
+
+  payload_buffer[0] = reply_code;
+
+  /* The blocks ahead of the values, and the indices and status byte after them */
+  const unsigned int header_length = (reply_code == 0xB0 || reply_code == 0xC4) ? 2 : (reply_code == 0xB6) ? 3 : (reply_code == 0xB7) ? 6 : 7;
+  const unsigned int trailer_length = (reply_code == 0xC4 ? 6 : 0) + (real_time_indices ? 2 : 1) + 1;
+  const unsigned int max_num_values = (SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN - 1 - header_length - trailer_length)/2;
+
+  num_values = rand() % (max_num_values + 1);
+
+  const unsigned int count_offset = header_length - 1;
+  const uint8_t count_mask = (reply_code == 0xBF) ? 0x3F : 0x03;
+  payload_buffer[count_offset] = num_values & 0xFF;
+  payload_buffer[count_offset+1] = (payload_buffer[count_offset+1] & ~count_mask) | (num_values >> 8);
+
+  unsigned int payload_length = 1 + header_length + 2*num_values + trailer_length;
+
+  /* C4 follows the ranges w/ up to as many reflectivity values as still fit */
+  if (reply_code == 0xC4) {
+    unsigned int max_num_reflect = SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN - payload_length;
+    if (max_num_reflect > SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS) {
+      max_num_reflect = SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS;
+    }
+    
+    const unsigned int num_reflect = rand() % (max_num_reflect + 1);
+    const unsigned int reflect_offset = 1 + header_length + 2*num_values;
+    payload_buffer[reflect_offset] = num_reflect & 0xFF;
+    payload_buffer[reflect_offset+1] = (payload_buffer[reflect_offset+1] & ~0x03) | (num_reflect >> 8);
+    payload_length += num_reflect;
+  }
+
+  return payload_length;
+
+}
+
+int main()
+{
+
+  const uint8_t measuring_modes[] = { SickLMS2xx::SICK_MS_MODE_8_OR_80_FA_FB_DAZZLE,
+				      SickLMS2xx::SICK_MS_MODE_8_OR_80_REFLECTOR,
+				      SickLMS2xx::SICK_MS_MODE_8_OR_80_FA_FB_FC,
+				      SickLMS2xx::SICK_MS_MODE_16_REFLECTOR,
+				      SickLMS2xx::SICK_MS_MODE_16_FA_FB,
+				      SickLMS2xx::SICK_MS_MODE_32_REFLECTOR,
+				      SickLMS2xx::SICK_MS_MODE_32_FA,
+				      SickLMS2xx::SICK_MS_MODE_32_IMMEDIATE,
+				      SickLMS2xx::SICK_MS_MODE_REFLECTIVITY,
+				      0x09,
+				      SickLMS2xx::SICK_MS_MODE_UNKNOWN };
+  const unsigned int num_measuring_modes = sizeof(measuring_modes)/sizeof(measuring_modes[0]);
+  const uint8_t reply_codes[] = { 0xB0, 0xB6, 0xB7, 0xBF, 0xC4 };
+
+  static uint8_t payload_buffer[SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN];
+  static reference_scan_t ref_scan;
+  static unsigned int values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int reflect_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int field_a_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int field_b_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int field_c_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+
+  SickLMS2xxCheck sick_lms;
+  unsigned int num_mismatches = 0;
+
+  srand(7);
+
+  for (unsigned int i = 0; i < NUM_RANDOM_REPLIES; i++) {
+
+    const uint8_t measuring_mode = measuring_modes[i % num_measuring_modes];
+    const bool real_time_indices = (i / num_measuring_modes) % 2;
+    const uint8_t reply_code = reply_codes[(i / (2*num_measuring_modes)) % 5];
+    const bool has_field_values = reply_code != 0xB6 && reply_code != 0xBF;
+
+    unsigned int num_values = 0;
+    const unsigned int payload_length = random_reply(payload_buffer,reply_code,real_time_indices,num_values);
+
+    reference_decode(payload_buffer,measuring_mode,real_time_indices,ref_scan);
+
+    /* Decode from a copy of just the payload, so reading past it is an overrun (e.g. under ASan or valgrind) */
+    uint8_t * const reply_buffer = new uint8_t[payload_length];
+    memcpy(reply_buffer,payload_buffer,payload_length);
+
+    sick_lms.SetDecodeConfig(measuring_mode,real_time_indices);
+
+    /* Ask for every field and then for only some (the getters allow either) */
+    for (unsigned int some_fields = 0; some_fields < 2; some_fields++) {
+
+      SickLMS2xxCheck::scan_dest_t sick_scan_dest;
+      sick_lms._setSickScanDest(sick_scan_dest,values,reflect_values,
+				has_field_values ? field_a_values : NULL,
+				has_field_values && !some_fields ? field_b_values : NULL,
+				has_field_values ? field_c_values : NULL);
+
+      bool matches = sick_lms._decodeSickScan(reply_buffer,payload_length,sick_scan_dest) &&
+		     sick_scan_dest.num_measurement_values == ref_scan.num_measurement_values &&
+		     sick_scan_dest.sick_telegram_index == ref_scan.sick_telegram_index &&
+		     sick_scan_dest.sick_real_time_scan_index == ref_scan.sick_real_time_scan_index &&
+		     sick_scan_dest.sick_partial_scan_index == ref_scan.sick_partial_scan_index &&
+		     values_match(values,ref_scan.measurement_values,ref_scan.num_measurement_values);
+
+      if (matches && has_field_values) {
+	matches = values_match(field_a_values,ref_scan.field_a_values,ref_scan.num_measurement_values) &&
+		  (some_fields || values_match(field_b_values,ref_scan.field_b_values,ref_scan.num_measurement_values)) &&
+		  values_match(field_c_values,ref_scan.field_c_values,ref_scan.num_measurement_values);
+      }
+
+      if (matches && reply_code == 0xC4) {
+	matches = sick_scan_dest.num_reflect_values == ref_scan.num_reflect_values &&
+		  values_match(reflect_values,ref_scan.reflect_values,ref_scan.num_reflect_values);
+      }
+
+      if (!matches) {
+	cerr << "Mismatch: reply 0x" << hex << (unsigned int)reply_code << " mode 0x" << (unsigned int)measuring_mode << dec
+	     << " w/ " << num_values << " values" << (real_time_indices ? " (real-time indices)" : "")
+	     << (some_fields ? " (some fields)" : "") << endl;
+	num_mismatches++;
+      }
+
+    }
+
+    delete [] reply_buffer;
+
+    /* Cut short anywhere before the telegram index, the reply is refused w/o being read past its end */
+    const unsigned int truncated_length = rand() % (payload_length - 1);
+    uint8_t * const truncated_buffer = new uint8_t[truncated_length];
+    memcpy(truncated_buffer,payload_buffer,truncated_length);
+
+    SickLMS2xxCheck::scan_dest_t sick_scan_dest;
+    sick_lms._setSickScanDest(sick_scan_dest,values,reflect_values,field_a_values,field_b_values,field_c_values);
+    if (sick_lms._decodeSickScan(truncated_buffer,truncated_length,sick_scan_dest)) {
+      cerr << "Truncated reply 0x" << hex << (unsigned int)reply_code << dec << " (" << truncated_length << " of "
+	   << payload_length << " bytes) was decoded!" << endl;
+      num_mismatches++;
+    }
+
+    delete [] truncated_buffer;
+
+  }
+
+  /* A count the buffers can't hold is refused rather than overrun */
+  payload_buffer[0] = 0xB0;
+  payload_buffer[1] = 0xFF;
+  payload_buffer[2] = 0x03;
+
+  SickLMS2xxCheck::scan_dest_t sick_scan_dest;
+  sick_lms._setSickScanDest(sick_scan_dest,values);
+  if (sick_lms._decodeSickScan(payload_buffer,SICK_LMS_2XX_MSG_PAYLOAD_MAX_LEN,sick_scan_dest)) {
+    cerr << "A reply w/ 1023 values was decoded!" << endl;
+    num_mismatches++;
+  }
+
+  /* ...as is an empty payload */
+  if (sick_lms._decodeSickScan(payload_buffer,0,sick_scan_dest)) {
+    cerr << "An empty reply was decoded!" << endl;
+    num_mismatches++;
+  }
+
+  cout << NUM_RANDOM_REPLIES << " random replies (and as many truncated ones), " << num_mismatches << " mismatch(es)" << endl;
+
+  return num_mismatches == 0 ? 0 : 1;
+
+}
@@ -0,0 +1,204 @@
+/*!
+ * \file extract_check.cc
+ * \brief Checks the vectorized Sick LMS 2xx measured value extraction
+ *        byte for byte against the scalar extraction.
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <sicklms2xx/SickLMS2xx.hh>
+#include "SickLMS2xxCheck.hh"
+
+using namespace std;
+using namespace SickToolbox;
+
+#define NUM_RANDOM_SEQUENCES  (200)         ///< Random byte sequences run through each measuring mode
+#define UNTOUCHED_VALUE       (0xDEADBEEF)  ///< Fills the buffers past the values that should be written
+
+/**
+ * \brief How a measuring mode lays out each value's high byte
+ */
+struct mask_layout_t {
+  uint8_t measuring_mode;
+  uint8_t value_mask;
+  uint8_t field_a_mask;
+  uint8_t field_b_mask;
+  uint8_t field_c_mask;
+};
+
+/* The layouts per the telegram listing (a zero value mask => mode unknown, nothing is extracted) */
+static const mask_layout_t mask_layouts[] = {
+  { SickLMS2xx::SICK_MS_MODE_8_OR_80_FA_FB_DAZZLE, 0x1F, 0x20, 0x40, 0x80 },
+  { SickLMS2xx::SICK_MS_MODE_8_OR_80_REFLECTOR,    0x1F, 0xE0, 0x00, 0x00 },
+  { SickLMS2xx::SICK_MS_MODE_8_OR_80_FA_FB_FC,     0x1F, 0x20, 0x40, 0x80 },
+  { SickLMS2xx::SICK_MS_MODE_16_REFLECTOR,         0x3F, 0xC0, 0x00, 0x00 },
+  { SickLMS2xx::SICK_MS_MODE_16_FA_FB,             0x3F, 0x40, 0x80, 0x00 },
+  { SickLMS2xx::SICK_MS_MODE_32_REFLECTOR,         0x7F, 0x80, 0x00, 0x00 },
+  { SickLMS2xx::SICK_MS_MODE_32_FA,                0x7F, 0x80, 0x00, 0x00 },
+  { SickLMS2xx::SICK_MS_MODE_32_IMMEDIATE,         0xFF, 0x00, 0x00, 0x00 },
+  { SickLMS2xx::SICK_MS_MODE_REFLECTIVITY,         0xFF, 0x00, 0x00, 0x00 },
+  { SickLMS2xx::SICK_MS_MODE_UNKNOWN,              0x00, 0x00, 0x00, 0x00 }
+};
+
+static const unsigned int num_mask_layouts = sizeof(mask_layouts)/sizeof(mask_layouts[0]);
+
+/**
+ * \brief The scalar extraction, one value at a time
+ */
+static void scalar_extract( const uint8_t * const byte_sequence, const unsigned int num_measurements, const mask_layout_t &layout,
+			    unsigned int * const measured_values, unsigned int * const field_a_values,
+			    unsigned int * const field_b_values, unsigned int * const field_c_values ) {
+
+  for (unsigned int i = 0; i < num_measurements; i++) {
+
+    const uint8_t high_byte = byte_sequence[i*2+1];
+
+    measured_values[i] = layout.value_mask ? byte_sequence[i*2] + 256*(high_byte & layout.value_mask) : 0;
+    field_a_values[i] = high_byte & layout.field_a_mask;
+    field_b_values[i] = high_byte & layout.field_b_mask;
+    field_c_values[i] = high_byte & layout.field_c_mask;
+
+  }
+
+}
+
+/**
+ * \brief Fills a buffer w/ the value that shouldn't be overwritten
+ */
+static void fill_untouched( unsigned int * const values ) {
+
+  for (unsigned int i = 0; i < SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS; i++) {
+    values[i] = UNTOUCHED_VALUE;
+  }
+
+}
+
+/**
+ * \brief Tells whether the first num_values match and the rest of the buffer was left alone
+ */
+static bool values_match( const unsigned int * const values, const unsigned int * const ref_values, const unsigned int num_values ) {
+
+  if (memcmp(values,ref_values,num_values*sizeof(unsigned int)) != 0) {
+    return false;
+  }
+
+  for (unsigned int i = num_values; i < SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS; i++) {
+    if (values[i] != UNTOUCHED_VALUE) {
+      return false;
+    }
+  }
+
+  return true;
+
+}
+
+int main()
+{
+
+  static uint8_t byte_buffer[2*SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS+16];
+  static unsigned int ref_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int ref_field_a_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int ref_field_b_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int ref_field_c_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int field_a_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int field_b_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+  static unsigned int field_c_values[SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS];
+
+  SickLMS2xxCheck sick_lms;
+  unsigned int num_mismatches = 0;
+  unsigned long num_block_values = 0, num_values = 0;
+
+  srand(11);
+
+  for (unsigned int i = 0; i < NUM_RANDOM_SEQUENCES; i++) {
+
+    for (unsigned int j = 0; j < sizeof(byte_buffer); j++) {
+      byte_buffer[j] = (uint8_t)rand();
+    }
+
+    /* Any count (the full scan, a multiple of the block size, or not) at any alignment */
+    const unsigned int num_measurements = (i < 8) ? SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS - i : rand() % (SickLMS2xx::SICK_MAX_NUM_MEASUREMENTS + 1);
+    const uint8_t * const byte_sequence = &byte_buffer[i % 16];
+
+    for (unsigned int k = 0; k < num_mask_layouts; k++) {
+
+      const mask_layout_t &layout = mask_layouts[k];
+      scalar_extract(byte_sequence,num_measurements,layout,ref_values,ref_field_a_values,ref_field_b_values,ref_field_c_values);
+
+      /* Through the driver, w/ every combination of wanted fields */
+      sick_lms.SetMeasuringMode(layout.measuring_mode);
+      for (unsigned int wanted_fields = 0; wanted_fields < 8; wanted_fields++) {
+
+	fill_untouched(values);
+	fill_untouched(field_a_values);
+	fill_untouched(field_b_values);
+	fill_untouched(field_c_values);
+
+	sick_lms._extractSickMeasurementValues(byte_sequence,num_measurements,values,
+					       (wanted_fields & 1) ? field_a_values : NULL,
+					       (wanted_fields & 2) ? field_b_values : NULL,
+					       (wanted_fields & 4) ? field_c_values : NULL);
+
+	if (!values_match(values,ref_values,num_measurements) ||
+	    !values_match(field_a_values,ref_field_a_values,(wanted_fields & 1) ? num_measurements : 0) ||
+	    !values_match(field_b_values,ref_field_b_values,(wanted_fields & 2) ? num_measurements : 0) ||
+	    !values_match(field_c_values,ref_field_c_values,(wanted_fields & 4) ? num_measurements : 0)) {
+	  cerr << "Mismatch: mode 0x" << hex << (unsigned int)layout.measuring_mode << dec << " w/ " << num_measurements
+	       << " values (fields wanted " << wanted_fields << ")" << endl;
+	  num_mismatches++;
+	}
+
+      }
+
+      /* Straight through the vector kernel (a known mode only) */
+      if (!layout.value_mask) {
+	continue;
+      }
+
+      for (unsigned int with_fields = 0; with_fields < 2; with_fields++) {
+
+	fill_untouched(values);
+	fill_untouched(field_a_values);
+	fill_untouched(field_b_values);
+	fill_untouched(field_c_values);
+
+	const unsigned int num_extracted =
+	  SickLMS2xxCheck::_extractSickMeasurementBlocks(byte_sequence,num_measurements,layout.value_mask,values,
+							 layout.field_a_mask,layout.field_b_mask,layout.field_c_mask,
+							 with_fields ? field_a_values : NULL,
+							 with_fields ? field_b_values : NULL,
+							 with_fields ? field_c_values : NULL);
+
+	if (num_extracted > num_measurements || num_extracted % 8 != 0 ||
+	    !values_match(values,ref_values,num_extracted) ||
+	    !values_match(field_a_values,ref_field_a_values,with_fields ? num_extracted : 0) ||
+	    !values_match(field_b_values,ref_field_b_values,with_fields ? num_extracted : 0) ||
+	    !values_match(field_c_values,ref_field_c_values,with_fields ? num_extracted : 0)) {
+	  cerr << "Kernel mismatch: mode 0x" << hex << (unsigned int)layout.measuring_mode << dec << " w/ " << num_measurements
+	       << " values (" << num_extracted << " extracted" << (with_fields ? ", w/ fields)" : ")") << endl;
+	  num_mismatches++;
+	}
+
+	num_block_values += num_extracted;
+	num_values += num_measurements;
+
+      }
+
+    }
+
+  }
+
+  cout << NUM_RANDOM_SEQUENCES << " random sequences x " << num_mask_layouts << " measuring modes, "
+       << num_mismatches << " mismatch(es)" << endl;
+  cout << "Vector kernel extracted " << num_block_values << " of " << num_values << " values"
+       << (num_block_values ? "" : " (scalar build)") << endl;
+
+  return num_mismatches == 0 ? 0 : 1;
+
+}
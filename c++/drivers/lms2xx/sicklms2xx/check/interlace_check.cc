@@ -0,0 +1,223 @@
+/*!
+ * \file interlace_check.cc
+ * \brief Checks how the Sick LMS 2xx partial scans are interlaced (a start
+ *        mid-scan, dropped and repeated partial scans, interpolation and
+ *        stray whole scans).
+ *
+ * The Sick LIDAR Matlab/C++ Toolbox
+ * This software is released under a BSD Open-Source License.
+ * See http://sicktoolbox.sourceforge.net
+ */
+
+#include <string.h>
+#include <iostream>
+#include <sicklms2xx/SickLMS2xx.hh>
+#include "SickLMS2xxCheck.hh"
+
+using namespace std;
+using namespace SickToolbox;
+
+/**
+ * \brief Feeds partial scans straight to the interlacer (the device is never opened)
+ */
+class SickLMS2xxInterlaceCheck : public SickLMS2xxCheck {
+
+public:
+
+  SickLMS2xxInterlaceCheck( ) : _num_partial_scans_read(0) {
+    _setSickScanDest(_interlaced_scan,_measurement_values,NULL,_field_a_values,_field_b_values,_field_c_values);
+  }
+
+  /** Sets the scan area and resolution (1/100 deg) and starts the interlacer afresh */
+  void SetScanArea( const uint16_t scan_angle, const uint16_t scan_resolution ) {
+    _sick_operating_status.sick_scan_angle = scan_angle;
+    _sick_operating_status.sick_scan_resolution = scan_resolution;
+    _resetSickInterlacer(_sick_interlacer);
+  }
+
+  /** The number of values an interlaced scan should have */
+  unsigned int NumValues( ) const { return _sick_interlacer.num_measurement_values; }
+
+  /** The number of partial scans making up an interlaced scan */
+  unsigned int NumPartialScans( ) const { return _sick_interlacer.num_partial_scans; }
+
+  /**
+   * \brief Feeds a partial scan holding the values of its slot
+   * \param partial_scan_index The partial scan index (in 0.25 deg steps)
+   * \param telegram_index The telegram index
+   * \param num_values The number of values (zero => however many the slot has)
+   * \param value_offset Added to each value (to tell a repeated partial scan apart)
+   * \return True if an interlaced scan was handed over
+   */
+  bool Feed( const unsigned int partial_scan_index, const unsigned int telegram_index, const unsigned int num_values = 0,
+	     const unsigned int value_offset = 0 ) {
+
+    const unsigned int num_partial_scans = _sick_interlacer.num_partial_scans;
+    const unsigned int slot = (partial_scan_index*num_partial_scans)/SICK_MAX_NUM_PARTIAL_SCANS;
+
+    /* Fill the interlacer's partial scan buffers, as the driver's decode does */
+    unsigned int * const partial_values = _sick_interlacer.partial_values;
+    unsigned int * const partial_field_a_values = _sick_interlacer.partial_field_a_values;
+    unsigned int * const partial_field_b_values = _sick_interlacer.partial_field_b_values;
+    unsigned int * const partial_field_c_values = _sick_interlacer.partial_field_c_values;
+
+    sick_lms_2xx_scan_dest_t sick_partial_scan;
+    _setSickScanDest(sick_partial_scan,partial_values,NULL,partial_field_a_values,partial_field_b_values,partial_field_c_values);
+
+    sick_partial_scan.num_measurement_values = num_values;
+    if (!num_values) {
+      sick_partial_scan.num_measurement_values = (_sick_interlacer.num_measurement_values - slot + num_partial_scans - 1)/num_partial_scans;
+    }
+
+    for (unsigned int i = 0, j = slot; i < sick_partial_scan.num_measurement_values; i++, j += num_partial_scans) {
+      partial_values[i] = ExpectedValue(j) + value_offset;
+      partial_field_a_values[i] = ExpectedFieldA(j);
+      partial_field_b_values[i] = 0;
+      partial_field_c_values[i] = 0;
+    }
+
+    sick_partial_scan.sick_telegram_index = telegram_index;
+    sick_partial_scan.sick_partial_scan_index = partial_scan_index;
+
+    /* Tag each partial scan w/ when it was read */
+    struct timespec partial_arrival_time;
+    partial_arrival_time.tv_sec = ++_num_partial_scans_read;
+    partial_arrival_time.tv_nsec = 0;
+
+    return _interlaceSickPartialScan(_sick_interlacer,sick_partial_scan,partial_arrival_time,_interlaced_scan,_arrival_time);
+
+  }
+
+  /**
+   * \brief Checks the scan handed over last
+   * \param missing_partial_scans The partial scans (by index) that should be flagged missing
+   * \param telegram_index The telegram index of the scan's last partial scan
+   * \param arrival_secs When the scan's first partial scan was read
+   * \return True if the scan is as expected
+   */
+  bool ScanMatches( const unsigned int missing_partial_scans, const unsigned int telegram_index, const time_t arrival_secs ) const {
+
+    const unsigned int num_partial_scans = _sick_interlacer.num_partial_scans;
+
+    if (_interlaced_scan.num_measurement_values != _sick_interlacer.num_measurement_values ||
+	_interlaced_scan.sick_missing_partial_scans != missing_partial_scans ||
+	_interlaced_scan.sick_telegram_index != telegram_index ||
+	_interlaced_scan.sick_partial_scan_index != 0 ||
+	_arrival_time.tv_sec != arrival_secs) {
+      return false;
+    }
+
+    for (unsigned int j = 0; j < _interlaced_scan.num_measurement_values; j++) {
+
+      const unsigned int partial_scan_index = ((j % num_partial_scans)*SICK_MAX_NUM_PARTIAL_SCANS)/num_partial_scans;
+      const bool missing = missing_partial_scans & (1 << partial_scan_index);
+
+      /* Missing values are zeroed, or interpolated (exactly, as the values are linear and the neighbours came in) */
+      const unsigned int expected_value = (!missing || _sick_partial_scan_interpolation) ? ExpectedValue(j) : 0;
+      const unsigned int expected_field_a = missing ? 0 : ExpectedFieldA(j);
+
+      if (_measurement_values[j] != expected_value || _field_a_values[j] != expected_field_a ||
+	  _field_b_values[j] != 0 || _field_c_values[j] != 0) {
+	return false;
+      }
+
+    }
+
+    return true;
+
+  }
+
+  /** The value fed for interlaced index j */
+  static unsigned int ExpectedValue( const unsigned int j ) { return 1000 + 10*j; }
+
+  /** The Field A value fed for interlaced index j */
+  static unsigned int ExpectedFieldA( const unsigned int j ) { return j & 1; }
+
+private:
+
+  unsigned int _num_partial_scans_read;
+  sick_lms_2xx_scan_dest_t _interlaced_scan;
+  struct timespec _arrival_time;
+  unsigned int _measurement_values[SICK_MAX_NUM_MEASUREMENTS];
+  unsigned int _field_a_values[SICK_MAX_NUM_MEASUREMENTS];
+  unsigned int _field_b_values[SICK_MAX_NUM_MEASUREMENTS];
+  unsigned int _field_c_values[SICK_MAX_NUM_MEASUREMENTS];
+
+};
+
+static unsigned int num_failures = 0;
+
+/**
+ * \brief Reports a failed expectation
+ */
+static void expect( const bool condition, const char * const what ) {
+
+  if (!condition) {
+    cerr << "FAILED: " << what << endl;
+    num_failures++;
+  }
+
+}
+
+int main()
+{
+
+  static SickLMS2xxInterlaceCheck sick_lms;
+
+  /* 0.25 deg over 100 deg: four partial scans, 401 values */
+  sick_lms.SetScanArea(100,25);
+  expect(sick_lms.NumPartialScans() == 4 && sick_lms.NumValues() == 401,"0.25 deg over 100 deg is 4 x 401");
+
+  /* Joining mid-scan (w/ the telegram index wrapping), the first scan is short its first two partial scans */
+  expect(!sick_lms.Feed(2,254),"mid-scan start: partial 2 held");
+  expect(!sick_lms.Feed(3,255),"mid-scan start: partial 3 held");
+  expect(sick_lms.Feed(0,0),"mid-scan start: next scan hands over the first");
+  expect(sick_lms.ScanMatches(0x3,255,1),"mid-scan start: partials 0 and 1 flagged and zeroed");
+  expect(!sick_lms.Feed(1,1) && !sick_lms.Feed(2,2),"complete scan: partials held");
+  expect(sick_lms.Feed(3,3),"complete scan: handed over once whole");
+  expect(sick_lms.ScanMatches(0x0,3,3),"complete scan: nothing missing");
+
+  /* A dropped partial scan shows once the next scan begins */
+  expect(!sick_lms.Feed(0,4) && !sick_lms.Feed(2,6) && !sick_lms.Feed(3,7),"drop: partials held");
+  expect(sick_lms.Feed(0,8),"drop: next scan hands over the short one");
+  expect(sick_lms.ScanMatches(0x2,7,7),"drop: partial 1 flagged and zeroed");
+
+  /* A repeated partial scan is ignored (its values would otherwise show) */
+  expect(!sick_lms.Feed(1,9) && !sick_lms.Feed(1,9,0,1),"repeat: ignored");
+  expect(!sick_lms.Feed(2,10) && sick_lms.Feed(3,11),"repeat: scan still handed over once whole");
+  expect(sick_lms.ScanMatches(0x0,11,10),"repeat: nothing missing");
+
+  /* Interpolated values are the mean of their neighbours */
+  sick_lms.SetSickPartialScanInterpolation(true);
+  expect(!sick_lms.Feed(0,12) && !sick_lms.Feed(1,13) && !sick_lms.Feed(3,15),"interpolation: partials held");
+  expect(sick_lms.Feed(0,16),"interpolation: next scan hands over the short one");
+  expect(sick_lms.ScanMatches(0x4,15,15),"interpolation: partial 2 flagged and interpolated");
+  sick_lms.SetSickPartialScanInterpolation(false);
+
+  /* A whole scan (left over from another mode) is rejected w/o disturbing the scan being collected */
+  expect(!sick_lms.Feed(0,17,401),"whole scan: rejected");
+  expect(!sick_lms.Feed(1,17,101),"partial scan w/ the wrong count: rejected");
+  expect(!sick_lms.Feed(1,17) && !sick_lms.Feed(2,18),"whole scan: partials still held");
+  expect(sick_lms.Feed(3,19),"whole scan: scan handed over once whole");
+  expect(sick_lms.ScanMatches(0x0,19,18),"whole scan: nothing missing");
+
+  /* 0.5 deg over 180 deg: two partial scans (indices 0 and 2), 361 values */
+  sick_lms.SetScanArea(180,50);
+  expect(sick_lms.NumPartialScans() == 2 && sick_lms.NumValues() == 361,"0.5 deg over 180 deg is 2 x 361");
+  expect(!sick_lms.Feed(1,20) && !sick_lms.Feed(3,20),"0.5 deg: 0.25 deg partial indices rejected");
+  expect(!sick_lms.Feed(0,20) && sick_lms.Feed(2,21),"0.5 deg: handed over once whole");
+  expect(sick_lms.ScanMatches(0x0,21,26),"0.5 deg: nothing missing");
+  expect(!sick_lms.Feed(2,23) && sick_lms.Feed(2,25),"0.5 deg: missing partial 0 shows on the next scan");
+  expect(sick_lms.ScanMatches(0x1,23,28),"0.5 deg: partial 0 flagged and zeroed");
+
+  /* 1 deg: every partial scan is a whole scan */
+  sick_lms.SetScanArea(180,100);
+  expect(sick_lms.NumPartialScans() == 1 && sick_lms.NumValues() == 181,"1 deg over 180 deg is 1 x 181");
+  expect(sick_lms.Feed(0,30),"1 deg: handed over immediately");
+  expect(sick_lms.ScanMatches(0x0,30,30),"1 deg: nothing missing");
+
+  cout << "Interlacer: " << num_failures << " failure(s)" << endl;
+
+  return num_failures == 0 ? 0 : 1;
+
+}